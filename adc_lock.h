@@ -0,0 +1,27 @@
+#ifndef ADC_LOCK_H
+#define ADC_LOCK_H
+
+#include <Arduino.h>
+
+// One lock for every analogRead: the photoresistor is sampled from the esp_timer task while the resistive
+// touchscreen (touchscreen_type 2) reads its plates from loop(), and two reads in flight on the ADC at once get
+// each other's channel setup.
+// The sampler only tries the lock and skips a sample when touch has the ADC, so the esp_timer task never waits.
+class AdcLock {
+public:
+  // wait for the ADC
+  static void Take() { xSemaphoreTake(Handle(), portMAX_DELAY); }
+  // ADC if free right now
+  static bool TryTake() { return xSemaphoreTake(Handle(), 0) == pdTRUE; }
+  static void Give() { xSemaphoreGive(Handle()); }
+
+private:
+  // created on first use, whichever task that is
+  static SemaphoreHandle_t Handle() {
+    static StaticSemaphore_t mutex_buffer;
+    static SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic(&mutex_buffer);
+    return mutex;
+  }
+};
+
+#endif // ADC_LOCK_H
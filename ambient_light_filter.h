@@ -0,0 +1,52 @@
+#ifndef AMBIENT_LIGHT_FILTER_H
+#define AMBIENT_LIGHT_FILTER_H
+
+#include <stdint.h>
+
+// Photoresistor ADC filter, no Arduino dependencies.
+// Raw samples are averaged in blocks of kDecimation (kills ADC and mains flicker noise), each block average then goes
+// through an exponential moving average with alpha 1 / 2^kEmaShift. The EMA state keeps kFracBits extra bits so small
+// light changes are not lost to rounding.
+class AmbientLightFilter {
+public:
+  static const uint8_t kDecimation = 16;
+  static const uint8_t kEmaShift = 3;
+  static const uint8_t kFracBits = 4;
+
+  // start filtered value at raw, so the first reading is not a slow ramp up from 0
+  void Reset(uint16_t raw) {
+    sum_ = 0;
+    count_ = 0;
+    last_raw_ = raw;
+    state_ = (int32_t)raw << kFracBits;
+  }
+
+  // add one raw sample, true when it completed a block and filtered() moved
+  bool Add(uint16_t raw) {
+    last_raw_ = raw;
+    sum_ += raw;
+    if(++count_ < kDecimation)
+      return false;
+    int32_t block_avg = (int32_t)((sum_ << kFracBits) / kDecimation);
+    sum_ = 0;
+    count_ = 0;
+    state_ += (block_avg - state_) >> kEmaShift;
+    return true;
+  }
+
+  uint16_t filtered() const { return (state_ + (1 << (kFracBits - 1))) >> kFracBits; }
+  uint16_t last_raw() const { return last_raw_; }
+
+  // raw and filtered in one word, so a reader on another task gets a consistent pair from a single atomic load
+  uint32_t Snapshot() const { return ((uint32_t)last_raw_ << 16) | filtered(); }
+  static uint16_t SnapshotRaw(uint32_t snapshot) { return snapshot >> 16; }
+  static uint16_t SnapshotFiltered(uint32_t snapshot) { return snapshot & 0xFFFF; }
+
+private:
+  uint32_t sum_ = 0;
+  uint8_t count_ = 0;
+  uint16_t last_raw_ = 0;
+  int32_t state_ = 0;
+};
+
+#endif  // AMBIENT_LIGHT_FILTER_H
@@ -0,0 +1,135 @@
+#ifndef BACKLIGHT_FADER_H
+#define BACKLIGHT_FADER_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Backlight fade planner, no Arduino dependencies.
+// Brightness levels are the 0 - 255 PWM values the display code has always used. A fade from one level to another
+// is split into kSegments straight duty ramps whose end points lie on a gamma curve, so equal time steps look like
+// equal steps in perceived brightness. Each segment is handed to the LEDC hardware fade, which ramps it without CPU.
+// Ambient (photoresistor) driven changes go through hysteresis and a minimum interval so brightness does not hunt.
+class BacklightFader {
+public:
+  static const uint8_t kSegments = 8;
+  static const uint8_t kDutyBits = 12;
+  static const uint16_t kDutyMax = (1 << kDutyBits) - 1;
+  static constexpr float kGamma = 2.2;
+
+  // ambient level changes smaller than 1 + target / kAmbientHysteresisDiv are ignored, so a dim screen still follows
+  // small steps while a bright one needs a bigger change
+  static const uint8_t kAmbientHysteresisDiv = 16;
+  // and ambient changes are accepted at most this often
+  static const unsigned long kAmbientMinIntervalMs = 5000;
+
+  // PWM level to LEDC duty at kDutyBits resolution
+  static uint16_t LevelToDuty(uint8_t level) {
+    return (uint32_t)level * kDutyMax / 255;
+  }
+
+  // start a fade from where the backlight is now to target over duration_ms, 0 ms jumps straight there
+  void Start(uint8_t target, uint16_t duration_ms, unsigned long now_ms) {
+    from_duty_ = CurrentDuty(now_ms);
+    target_ = target;
+    to_duty_ = LevelToDuty(target);
+    duration_ms_ = duration_ms;
+    start_ms_ = now_ms;
+    next_segment_ = 0;
+  }
+
+  // gate for photoresistor levels: true if level is far enough from target and the last accepted change is old enough
+  // the very first level is always accepted
+  bool AcceptAmbientLevel(uint8_t level, unsigned long now_ms) {
+    if(ambient_accepted_) {
+      int diff = (int)level - (int)target_;
+      if(diff < 0)
+        diff = -diff;
+      if(diff < 1 + target_ / kAmbientHysteresisDiv)
+        return false;
+      if(now_ms - last_ambient_ms_ < kAmbientMinIntervalMs)
+        return false;
+    }
+    ambient_accepted_ = true;
+    last_ambient_ms_ = now_ms;
+    return true;
+  }
+
+  // true when the next segment is due: the hardware should ramp from start_duty to end_duty in segment_ms
+  bool NextSegment(unsigned long now_ms, uint16_t* start_duty, uint16_t* end_duty, uint16_t* segment_ms) {
+    if(next_segment_ > kSegments)
+      return false;
+    if(duration_ms_ == 0 || from_duty_ == to_duty_) {
+      next_segment_ = kSegments + 1;
+      *start_duty = to_duty_;
+      *end_duty = to_duty_;
+      *segment_ms = 0;
+      return true;
+    }
+    if(next_segment_ == kSegments) {
+      next_segment_++;
+      return false;
+    }
+    // segment k runs from SegmentStartMs(k) to SegmentStartMs(k + 1)
+    if(now_ms - start_ms_ < SegmentStartMs(next_segment_))
+      return false;
+    uint8_t k = next_segment_++;
+    *start_duty = WaypointDuty(k);
+    *end_duty = WaypointDuty(k + 1);
+    *segment_ms = SegmentStartMs(k + 1) - SegmentStartMs(k);
+    return true;
+  }
+
+  // duty the backlight is at now, following the planned waypoints
+  uint16_t CurrentDuty(unsigned long now_ms) const {
+    if(duration_ms_ == 0)
+      return to_duty_;
+    unsigned long t = now_ms - start_ms_;
+    if(t >= duration_ms_)
+      return to_duty_;
+    uint8_t k = t * kSegments / duration_ms_;
+    unsigned long t0 = SegmentStartMs(k), t1 = SegmentStartMs(k + 1);
+    int32_t d0 = WaypointDuty(k), d1 = WaypointDuty(k + 1);
+    return d0 + (d1 - d0) * (int32_t)(t - t0) / (int32_t)(t1 - t0);
+  }
+
+  uint8_t CurrentLevel(unsigned long now_ms) const {
+    return ((uint32_t)CurrentDuty(now_ms) * 255 + kDutyMax / 2) / kDutyMax;
+  }
+  uint8_t target() const { return target_; }
+
+  // the hardware ramp of a segment handed out at now_ms takes segment_ms
+  // a ramp must not be started or overwritten while one runs, the LEDC fade call would wait for it to end
+  void RampStarted(unsigned long now_ms, uint16_t segment_ms) {
+    ramp_start_ms_ = now_ms;
+    ramp_ms_ = segment_ms;
+  }
+  bool RampRunning(unsigned long now_ms) const { return now_ms - ramp_start_ms_ < ramp_ms_; }
+
+private:
+  unsigned long SegmentStartMs(uint8_t k) const {
+    return (unsigned long)duration_ms_ * k / kSegments;
+  }
+
+  // waypoint k of kSegments: linear in perceived brightness (duty ^ (1 / gamma)) between from and to
+  uint16_t WaypointDuty(uint8_t k) const {
+    if(k == 0)
+      return from_duty_;
+    if(k >= kSegments)
+      return to_duty_;
+    float p0 = powf((float)from_duty_ / kDutyMax, 1 / kGamma), p1 = powf((float)to_duty_ / kDutyMax, 1 / kGamma);
+    float p = p0 + (p1 - p0) * k / kSegments;
+    return (uint16_t)(powf(p, kGamma) * kDutyMax + 0.5f);
+  }
+
+  uint8_t target_ = 0;
+  uint16_t from_duty_ = 0, to_duty_ = 0;
+  uint16_t duration_ms_ = 0;
+  unsigned long start_ms_ = 0;
+  uint8_t next_segment_ = kSegments + 1;
+  bool ambient_accepted_ = false;
+  unsigned long last_ambient_ms_ = 0;
+  unsigned long ramp_start_ms_ = 0;
+  uint16_t ramp_ms_ = 0;
+};
+
+#endif  // BACKLIGHT_FADER_H
@@ -0,0 +1,66 @@
+#ifndef CLOCK_TIME_H
+#define CLOCK_TIME_H
+
+#include <stdint.h>
+
+// Broken down calendar time that the SQW interrupt advances a second at a time, no Arduino dependencies.
+// Hours are 0 - 23, 12 hour display is worked out when read. Tick() uses no tables, so it is safe from an IRAM ISR
+// while flash cache is off.
+struct ClockTime {
+  uint16_t year = 2000;
+  uint8_t month = 1;          // January = 1
+  uint8_t day = 1;
+  uint8_t hour = 0;
+  uint8_t minute = 0;
+  uint8_t second = 0;
+  uint8_t day_of_week = 7;    // Sunday = 1, 1 Jan 2000 was a Saturday
+
+  __attribute__((always_inline)) static bool IsLeapYear(uint16_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  }
+
+  // 31 day months are the odd ones up to July and the even ones from August
+  __attribute__((always_inline)) static uint8_t DaysInMonth(uint16_t year, uint8_t month) {
+    if(month == 2)
+      return (IsLeapYear(year) ? 29 : 28);
+    return 30 + ((month + (month >> 3)) & 1);
+  }
+
+  // one second forward with minute, hour, day, week day, month and year rollover, true on a new minute
+  __attribute__((always_inline)) bool Tick() {
+    if(++second < 60)
+      return false;
+    second = 0;
+    if(++minute < 60)
+      return true;
+    minute = 0;
+    if(++hour < 24)
+      return true;
+    hour = 0;
+    day_of_week = (day_of_week == 7 ? 1 : day_of_week + 1);
+    if(++day <= DaysInMonth(year, month))
+      return true;
+    day = 1;
+    if(++month <= 12)
+      return true;
+    month = 1;
+    year++;
+    return true;
+  }
+
+  uint32_t SecondsOfDay() const { return (uint32_t)hour * 3600 + minute * 60 + second; }
+  bool SameDate(const ClockTime& other) const { return year == other.year && month == other.month && day == other.day; }
+};
+
+// what the SQW interrupt hands loop for each tick. The minute is the one the tick made, loop may only get to it after
+// the clock has moved on
+struct ClockTick {
+  unsigned long micros;     // when the tick interrupt ran
+  bool new_minute;          // seconds rolled over 59 -> 0
+  uint8_t minute;           // clock minute right after the tick
+
+  // the tick that started an hour, once an hour the software clock is checked against RTC HW
+  bool new_hour() const { return new_minute && minute == 0; }
+};
+
+#endif  // CLOCK_TIME_H
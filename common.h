@@ -5,6 +5,7 @@
 #include <Arduino.h>
 #include "pin_defs.h"
 #include "general_constants.h"
+#include "page_layout.h"
 #include <queue>          // std::queue
 #include <vector>         // std::vector
 #include "SPI.h"
@@ -184,20 +185,48 @@ enum ButtonType {
   kLabelOnlyNoClickButton,    // kLabelOnlyNoClickButton will not be highlighted on display
 };
 
+// buttons whose value text depends on saved settings, each has a slot in button_values
+enum ButtonValueSlot : uint8_t {
+  kLongPressTimeValue,
+  kSavedWiFiValue,
+  kLocationValue,
+  kWeatherUnitsValue,
+  kScreensaverMotionValue,
+  kScreensaverSpeedValue,
+  kRgbLedModeValue,
+  kNightTimeDimHourValue,
+  kRgbLedBrightnessValue,
+  kButtonValueSlots,    // needs to be after the slots
+  kFixedButtonValue = kButtonValueSlots,  // value text is fixed_value
+};
+const size_t kButtonValueSize = 24;
+
 // struct declerations
+// everything about a button known at compile time, page tables of these stay in flash
 struct DisplayButton {
-  const Cursor btn_cursor_id;
-  const ButtonType btn_type;
-  const std::string row_label;
-  const bool fixed_location;
-  int16_t btn_x;
-  int16_t btn_y;
-  uint16_t btn_w;
-  uint16_t btn_h;
-  std::string btn_value;
+  Cursor btn_cursor_id;
+  ButtonType btn_type;
+  const char* row_label;        // string literal
+  bool fixed_location;
+  ButtonRect fixed_rect;        // fixed_location buttons, row buttons are sized to their value by PageLayout::RowButton
+  ButtonValueSlot value_slot;
+  const char* fixed_value;      // value text when value_slot is kFixedButtonValue
 };
 
-extern std::vector<std::vector<DisplayButton*>> display_pages_vec;
+// buttons of one page, a fixed size table laid out at compile time
+struct DisplayPage {
+  const DisplayButton* buttons;
+  uint8_t count;
+  constexpr size_t size() const { return count; }
+  constexpr const DisplayButton* operator[](int i) const { return buttons + i; }
+};
+
+extern const DisplayPage display_pages_vec[kNoPageSelected];
+
+// runtime value texts of the buttons with a slot, filled in by PopulateButtonValues()
+extern char button_values[kButtonValueSlots][kButtonValueSize];
+extern const char* ButtonValue(const DisplayButton* button);
+extern void SetButtonValue(ButtonValueSlot slot, const char* value);
 
 // display time data in char arrays
 struct DisplayData {
@@ -19,6 +19,11 @@
 // #define DISPLAY_IS_ILI9488
 
 
+// SELECT IF SETTINGS PAGES ARE COMPOSED IN A FULL RGB565 FRAME IN PSRAM (ESP32-S3 N16R8 only, set PSRAM: "OPI PSRAM" in IDE)
+
+// #define PSRAM_FRAMEBUFFER
+
+
 // SELECT IF WIFI IS USED
 
 #define WIFI_IS_USED
@@ -37,4 +42,9 @@ const std::string kChangeLog = "- Min 5 digit zip codes.";
 // #define MORE_LOGS
 
 
+// SELECT IF DRAW TIMES OF SCREENS ARE COLLECTED INTO HISTOGRAMS (serial 'R' prints them, no cost when not defined)
+
+// #define RENDER_PROFILING
+
+
 #endif  // CONFIGURATION_H
\ No newline at end of file
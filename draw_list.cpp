@@ -0,0 +1,149 @@
+#include "draw_list.h"
+
+DrawList::DrawList(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+  setTextWrap(false);
+}
+
+void DrawList::Clear() {
+  ops_.clear();
+  fonts_.clear();
+  replayed_ = 0;
+}
+
+void DrawList::Release() {
+  Clear();
+  std::vector<Op>().swap(ops_);
+  std::vector<const GFXfont*>().swap(fonts_);
+}
+
+void DrawList::Add(OpType type, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if(in_write_)
+    return;
+  ops_.push_back({ x, y, w, h, color, 0, type, 0 });
+}
+
+void DrawList::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  Add(kPixel, x, y, 1, 1, color);
+}
+
+void DrawList::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  Add(kHLine, x, y, w, 1, color);
+}
+
+void DrawList::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  Add(kVLine, x, y, 1, h, color);
+}
+
+void DrawList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  Add(kFillRect, x, y, w, h, color);
+}
+
+void DrawList::fillScreen(uint16_t color) {
+  Add(kFillScreen, 0, 0, WIDTH, HEIGHT, color);
+}
+
+size_t DrawList::write(uint8_t c) {
+  int16_t x = cursor_x, y = cursor_y;
+  // Adafruit_GFX moves the cursor, what it draws for the character is not recorded
+  in_write_ = true;
+  Adafruit_GFX::write(c);
+  in_write_ = false;
+  if(c == '\n' || c == '\r')
+    return 1;
+  if(gfxFont != NULL) {
+    // characters Adafruit_GFX does not draw
+    uint8_t first = pgm_read_byte(&gfxFont->first), last = pgm_read_byte(&gfxFont->last);
+    if(c < first || c > last)
+      return 1;
+    GFXglyph* glyph = (GFXglyph*)pgm_read_ptr(&gfxFont->glyph) + (c - first);
+    if(pgm_read_byte(&glyph->width) == 0 || pgm_read_byte(&glyph->height) == 0)
+      return 1;
+  }
+  uint8_t font_index = 0;
+  while(font_index < fonts_.size() && fonts_[font_index] != gfxFont)
+    font_index++;
+  if(font_index == fonts_.size())
+    fonts_.push_back(gfxFont);
+  ops_.push_back({ x, y, (int16_t)(textsize_x | (textsize_y << 8)), font_index, textcolor, textbgcolor, kChar, c });
+  return 1;
+}
+
+// heights of 0 and below are replayed as they were given, Adafruit_GFX and the canvases each have their own take
+// on them, so their rows are counted generously
+void DrawList::Rows(const Op& op, int16_t* top, int16_t* bottom) const {
+  switch (op.type) {
+    case kFillScreen:
+      *top = INT16_MIN;
+      *bottom = INT16_MAX;
+      break;
+    case kChar: {
+      uint8_t size_y = op.w >> 8;
+      const GFXfont* font = fonts_[op.h];
+      if(font == NULL) {
+        // classic 5x7 font cell, background included
+        *top = op.y;
+        *bottom = op.y + 8 * size_y - 1;
+      }
+      else {
+        GFXglyph* glyph = (GFXglyph*)pgm_read_ptr(&font->glyph) + (op.c - pgm_read_byte(&font->first));
+        *top = op.y + (int8_t)pgm_read_byte(&glyph->yOffset) * size_y;
+        *bottom = *top + pgm_read_byte(&glyph->height) * size_y - 1;
+      }
+      break;
+    }
+    default:
+      if(op.h > 0) {
+        *top = op.y;
+        *bottom = op.y + op.h - 1;
+      }
+      else {
+        *top = op.y + op.h - 1;
+        *bottom = op.y;
+      }
+  }
+}
+
+void DrawList::Replay(Adafruit_GFX& gfx, int16_t band_y0, int16_t band_h) {
+  int16_t band_y1 = band_y0 + band_h - 1;
+  int16_t font_index = -1;
+  replayed_ = 0;
+  for (const Op& op : ops_) {
+    int16_t top, bottom;
+    Rows(op, &top, &bottom);
+    if(bottom < band_y0 || top > band_y1)
+      continue;
+    replayed_++;
+    // rows of vertical lines and rectangles past the band would only be clipped by gfx
+    int16_t y0 = max(top, band_y0), y1 = min(bottom, band_y1);
+    switch (op.type) {
+      case kPixel:
+        gfx.drawPixel(op.x, op.y, op.color);
+        break;
+      case kHLine:
+        gfx.drawFastHLine(op.x, op.y, op.w, op.color);
+        break;
+      case kVLine:
+        if(op.h > 0)
+          gfx.drawFastVLine(op.x, y0, y1 - y0 + 1, op.color);
+        else
+          gfx.drawFastVLine(op.x, op.y, op.h, op.color);
+        break;
+      case kFillRect:
+        if(op.h > 0)
+          gfx.fillRect(op.x, y0, op.w, y1 - y0 + 1, op.color);
+        else
+          gfx.fillRect(op.x, op.y, op.w, op.h, op.color);
+        break;
+      case kFillScreen:
+        gfx.fillScreen(op.color);
+        break;
+      case kChar:
+        if(op.h != font_index) {
+          font_index = op.h;
+          gfx.setFont(fonts_[font_index]);
+        }
+        gfx.drawChar(op.x, op.y, op.c, op.color, op.bg, op.w & 0xFF, op.w >> 8);
+        break;
+    }
+  }
+}
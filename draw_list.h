@@ -0,0 +1,51 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <vector>
+#include <Adafruit_GFX.h>
+
+// Records what is drawn on it and replays it onto another Adafruit_GFX, needs only Adafruit_GFX.
+// A page laid out once can then be sent a band at a time: each band replays only the calls that reach its rows.
+// Shapes are recorded as the pixels, lines and rectangles Adafruit_GFX breaks them into, and text as glyphs at the
+// cursor position write() gave them, so nothing is laid out or measured again per band.
+// text wrap must stay off, wrapped text would be recorded at its unwrapped position
+class DrawList : public Adafruit_GFX {
+public:
+  DrawList(uint16_t w, uint16_t h);
+  // forget recorded calls, their storage is kept for the next page
+  void Clear();
+  // forget recorded calls and free their storage
+  void Release();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  using Adafruit_GFX::write;
+  size_t write(uint8_t c) override;
+  // replay calls that reach rows [band_y0, band_y0 + band_h) onto gfx, which ends up in the last recorded font
+  void Replay(Adafruit_GFX& gfx, int16_t band_y0, int16_t band_h);
+  size_t size() const { return ops_.size(); }
+  // calls sent to gfx by the last Replay
+  size_t replayed() const { return replayed_; }
+
+private:
+  enum OpType : uint8_t { kPixel, kHLine, kVLine, kFillRect, kFillScreen, kChar };
+  struct Op {
+    int16_t x, y, w, h;       // kChar: cursor, w is text size and h the index in fonts_
+    uint16_t color, bg;
+    OpType type;
+    uint8_t c;
+  };
+  void Add(OpType type, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  // rows op can draw on
+  void Rows(const Op& op, int16_t* top, int16_t* bottom) const;
+
+  std::vector<Op> ops_;
+  std::vector<const GFXfont*> fonts_;
+  // set while Adafruit_GFX::write lays out a character, its pixels are recorded as the character instead
+  bool in_write_ = false;
+  size_t replayed_ = 0;
+};
+
+#endif // DRAW_LIST_H
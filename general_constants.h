@@ -49,6 +49,7 @@ const char kAmLabel[3] = "AM", kPmLabel[3] = "PM", kOffLabel[4] = "Off", kAlarmL
 const char kCharSpace = ' ', kCharZero = '0', kCharColon = ':';
 
 const unsigned int kWifiSsidPasswordLengthMax = 32;
+const unsigned int kPosixTzLengthMax = 64;
 
 const char softApSsid[24] = "Long-Press-Alarm-SoftAP";
 
@@ -0,0 +1,213 @@
+#include "gfx_canvases.h"
+#include <new>      // placement new for canvas arena views
+
+// unpack digit glyphs of font into row aligned bitmaps, storage is allocated once at boot
+bool GlyphAtlas::Build(const GFXfont* font) {
+  if(storage_ != NULL) {
+    free(storage_);
+    storage_ = NULL;
+    bytes_ = 0;
+  }
+  font_ = font;
+  uint8_t first = pgm_read_byte(&font->first);
+  GFXglyph* font_glyphs = (GFXglyph*)pgm_read_ptr(&font->glyph);
+  uint8_t* font_bitmap = (uint8_t*)pgm_read_ptr(&font->bitmap);
+
+  // glyph metrics and total size of atlas
+  size_t total_bytes = 0;
+  for (int g = 0; g < kGlyphCount; g++) {
+    GFXglyph* glyph = font_glyphs + (kFirstChar + g - first);
+    AtlasGlyph &atlas_glyph = glyphs_[g];
+    atlas_glyph.w = pgm_read_byte(&glyph->width);
+    atlas_glyph.h = pgm_read_byte(&glyph->height);
+    atlas_glyph.x_advance = pgm_read_byte(&glyph->xAdvance);
+    atlas_glyph.x_offset = pgm_read_byte(&glyph->xOffset);
+    atlas_glyph.y_offset = pgm_read_byte(&glyph->yOffset);
+    atlas_glyph.row_bytes = (atlas_glyph.w + 7) >> 3;
+    total_bytes += atlas_glyph.row_bytes * atlas_glyph.h;
+  }
+
+  storage_ = (uint8_t*)calloc(total_bytes, 1);
+  if(storage_ == NULL)
+    return false;
+  bytes_ = total_bytes;
+
+  // font bitmaps are bit packed without row padding, same decoding as Adafruit_GFX drawChar
+  uint8_t* dst = storage_;
+  for (int g = 0; g < kGlyphCount; g++) {
+    GFXglyph* glyph = font_glyphs + (kFirstChar + g - first);
+    AtlasGlyph &atlas_glyph = glyphs_[g];
+    atlas_glyph.bitmap = dst;
+    uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+    uint8_t bits = 0, bit = 0;
+    for (int16_t yy = 0; yy < atlas_glyph.h; yy++) {
+      for (int16_t xx = 0; xx < atlas_glyph.w; xx++) {
+        if(!(bit++ & 7))
+          bits = pgm_read_byte(&font_bitmap[bo++]);
+        if(bits & 0x80)
+          dst[yy * atlas_glyph.row_bytes + (xx >> 3)] |= 0x80 >> (xx & 7);
+        bits <<= 1;
+      }
+    }
+    dst += atlas_glyph.row_bytes * atlas_glyph.h;
+  }
+  return true;
+}
+
+// print str at canvas cursor and advance the cursor, same pixels as canvas->print(str) with font_ set
+// characters not in the atlas go through regular glyph decoding
+void GlyphAtlas::Print(GFXcanvas1* canvas, const char* str, uint16_t color) {
+  uint8_t* buffer = canvas->getBuffer();
+  int16_t canvas_w = canvas->width(), canvas_h = canvas->height();
+  int16_t stride = (canvas_w + 7) >> 3;
+  for (; *str != '\0'; str++) {
+    char c = *str;
+    if(storage_ == NULL || c < kFirstChar || c > kLastChar || canvas->getRotation() != 0) {
+      canvas->write(c);
+      continue;
+    }
+    AtlasGlyph &atlas_glyph = glyphs_[c - kFirstChar];
+    int16_t x0 = canvas->getCursorX() + atlas_glyph.x_offset;
+    int16_t y0 = canvas->getCursorY() + atlas_glyph.y_offset;
+    for (int16_t yy = (y0 < 0 ? -y0 : 0); yy < atlas_glyph.h && y0 + yy < canvas_h; yy++) {
+      const uint8_t* src = atlas_glyph.bitmap + yy * atlas_glyph.row_bytes;
+      uint8_t* dst_row = buffer + (y0 + yy) * stride;
+      for (int16_t k = 0; k < atlas_glyph.row_bytes; k++) {
+        uint8_t b = src[k];
+        if(b == 0)
+          continue;
+        int16_t x = x0 + (k << 3);
+        if(x >= 0 && x + 8 <= canvas_w) {
+          // all 8 pixels inside canvas row, spread over at most 2 canvas bytes
+          uint8_t s = x & 7;
+          uint8_t* dst = dst_row + (x >> 3);
+          if(color) {
+            dst[0] |= b >> s;
+            if(s) dst[1] |= b << (8 - s);
+          }
+          else {
+            dst[0] &= ~(b >> s);
+            if(s) dst[1] &= ~(uint8_t)(b << (8 - s));
+          }
+        }
+        else {
+          // clipped at canvas edge, drawPixel clips per pixel
+          for (int16_t i = 0; i < 8; i++)
+            if(b & (0x80 >> i))
+              canvas->drawPixel(x + i, y0 + yy, color);
+        }
+      }
+    }
+    canvas->setCursor(canvas->getCursorX() + atlas_glyph.x_advance, canvas->getCursorY());
+  }
+}
+
+// same cursor, newline and wrap handling as Adafruit_GFX::write() for GFXfonts
+size_t SpanTextCanvas1::write(uint8_t c) {
+  if(!span_glyphs || gfxFont == NULL || textsize_x != 1 || textsize_y != 1 || rotation != 0)
+    return GFXcanvas1::write(c);
+
+  if(c == '\n') {
+    cursor_x = 0;
+    cursor_y += (int16_t)pgm_read_byte(&gfxFont->yAdvance);
+    return 1;
+  }
+  if(c == '\r')
+    return 1;
+  uint8_t first = pgm_read_byte(&gfxFont->first);
+  if(c < first || c > (uint8_t)pgm_read_byte(&gfxFont->last))
+    return 1;
+
+  GFXglyph* glyph = (GFXglyph*)pgm_read_ptr(&gfxFont->glyph) + (c - first);
+  uint8_t w = pgm_read_byte(&glyph->width), h = pgm_read_byte(&glyph->height);
+  if(w > 0 && h > 0) {
+    int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset);
+    if(wrap && ((cursor_x + xo + w) > _width)) {
+      cursor_x = 0;
+      cursor_y += (int16_t)pgm_read_byte(&gfxFont->yAdvance);
+    }
+    DrawGlyphSpans(cursor_x + xo, cursor_y + (int8_t)pgm_read_byte(&glyph->yOffset), (const uint8_t*)pgm_read_ptr(&gfxFont->bitmap), pgm_read_word(&glyph->bitmapOffset), w, h, textcolor != 0);
+  }
+  cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance);
+  return 1;
+}
+
+// glyph bitmaps are one bit stream without row padding, msb first
+// each glyph row is read in chunks of up to 24 bits and merged into the canvas bytes it covers
+void SpanTextCanvas1::DrawGlyphSpans(int16_t x, int16_t y, const uint8_t* bitmap, uint16_t bit_offset, uint8_t w, uint8_t h, bool set) {
+  uint32_t bit_pos = (uint32_t)bit_offset * 8;
+  int16_t row_bytes = (WIDTH + 7) / 8;
+  for (int16_t yy = 0; yy < h; yy++, bit_pos += w) {
+    int16_t py = y + yy;
+    if(py < 0 || py >= _height)
+      continue;
+    uint8_t* row = buffer + py * row_bytes;
+    for (int16_t xx = 0; xx < w; xx += 24) {
+      int16_t n = min(24, w - xx);
+      // n bits starting at bit_pos + xx, left aligned in span
+      uint32_t pos = bit_pos + xx;
+      const uint8_t* src = bitmap + (pos >> 3);
+      int16_t src_bytes = ((pos & 7) + n + 7) >> 3;
+      uint32_t span = 0;
+      for (int16_t b = 0; b < src_bytes; b++)
+        span |= (uint32_t)pgm_read_byte(src + b) << (24 - 8 * b);
+      span <<= (pos & 7);
+      uint32_t mask = 0xFFFFFFFFUL << (32 - n);
+      // clip to canvas
+      int16_t px = x + xx;
+      if(px < 0) {
+        if(px <= -n)
+          continue;
+        span <<= -px;
+        mask <<= -px;
+        px = 0;
+      }
+      if(px >= _width)
+        break;
+      if(px + n > _width)
+        mask &= 0xFFFFFFFFUL << (32 - (_width - px));
+      span &= mask;
+      if(mask == 0)
+        continue;
+      // shift to canvas bit position, up to 5 destination bytes
+      uint8_t shift = px & 7;
+      uint64_t span64 = ((uint64_t)span << 32) >> shift;
+      uint64_t mask64 = ((uint64_t)mask << 32) >> shift;
+      uint8_t* dst = row + (px >> 3);
+      for (int16_t b = 0; b < 5 && mask64 != 0; b++) {
+        uint8_t m = mask64 >> 56;
+        if(m) {
+          if(set)
+            dst[b] |= (uint8_t)(span64 >> 56);
+          else
+            dst[b] &= ~(uint8_t)(span64 >> 56);
+        }
+        span64 <<= 8;
+        mask64 <<= 8;
+      }
+    }
+  }
+}
+
+// w x h canvas over the arena, heap only if it does not fit
+SpanTextCanvas1* CanvasArena::Borrow(uint16_t w, uint16_t h) {
+  Return();
+  if((size_t)((w + 7) / 8) * h <= bytes_)
+    canvas_ = new (view_) ArenaCanvas1(w, h, arena_);
+  else {
+    canvas_ = new SpanTextCanvas1(w, h);
+    misses_++;
+  }
+  return canvas_;
+}
+
+// arena views are only destroyed, heap canvases are deleted
+void CanvasArena::Return() {
+  if(canvas_ == NULL)
+    return;
+  if((void*)canvas_ == (void*)view_)
+    static_cast<ArenaCanvas1*>(canvas_)->~ArenaCanvas1();
+  else
+    delete canvas_;
+  canvas_ = NULL;
+}
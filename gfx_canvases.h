@@ -0,0 +1,82 @@
+#ifndef GFX_CANVASES_H
+#define GFX_CANVASES_H
+
+#include <Adafruit_GFX.h>
+
+// Canvases and glyph helpers for the render path built only on Adafruit_GFX, no display or board code,
+// so the host tests in test/ can check them pixel for pixel against plain Adafruit_GFX drawing.
+
+// digits and ':' of a GFXfont pre-rasterized at boot into row aligned 1 bit bitmaps
+// time strings are then composed by OR-ing whole bytes into a GFXcanvas1 instead of per pixel drawChar
+// canvas must be unrotated, text size 1 and text wrap off, same as the time canvases
+class GlyphAtlas {
+public:
+  ~GlyphAtlas() { free(storage_); }
+  // false if the atlas could not be allocated, Print then falls back to canvas->write
+  bool Build(const GFXfont* font);
+  // bytes of atlas storage, 0 if not built
+  size_t bytes() const { return bytes_; }
+  void Print(GFXcanvas1* canvas, const char* str, uint16_t color);
+
+private:
+  // '0' to '9' and ':' are contiguous in ASCII
+  static const char kFirstChar = '0', kLastChar = ':';
+  static const int kGlyphCount = kLastChar - kFirstChar + 1;
+
+  struct AtlasGlyph {
+    uint8_t* bitmap;        // h rows of row_bytes each, msb is leftmost pixel
+    uint8_t w, h, row_bytes, x_advance;
+    int8_t x_offset, y_offset;
+  };
+  AtlasGlyph glyphs_[kGlyphCount];
+  uint8_t* storage_ = NULL;
+  size_t bytes_ = 0;
+  const GFXfont* font_ = NULL;
+};
+
+// GFXcanvas1 that prints GFXfont glyphs a row span at a time: glyph bits are shifted into place and OR-ed
+// (or cleared) a byte at a time instead of one drawPixel per set bit
+// same pixels as Adafruit_GFX drawChar, other text sizes and rotations still go through it
+class SpanTextCanvas1 : public GFXcanvas1 {
+public:
+  SpanTextCanvas1(uint16_t w, uint16_t h, bool allocate_buffer = true) : GFXcanvas1(w, h, allocate_buffer) {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // off: every glyph pixel goes through drawPixel, for comparison
+  bool span_glyphs = true;
+
+private:
+  void DrawGlyphSpans(int16_t x, int16_t y, const uint8_t* bitmap, uint16_t bit_offset, uint8_t w, uint8_t h, bool set);
+};
+
+// GFXcanvas1 that draws into a buffer owned by someone else, nothing is allocated or freed by it
+class ArenaCanvas1 : public SpanTextCanvas1 {
+public:
+  ArenaCanvas1(uint16_t w, uint16_t h, uint8_t* arena) : SpanTextCanvas1(w, h, false) { buffer = arena; }
+};
+
+// hands out 1 bit canvases of any size that fits in a buffer reserved once at boot, so borrowing and returning them
+// does not touch the heap; a canvas larger than the buffer is heap allocated and counted in misses()
+// one canvas at a time, borrowing again returns the previous one
+class CanvasArena {
+public:
+  // canvases draw into arena of bytes, owned by the caller
+  CanvasArena(uint8_t* arena, size_t bytes) : arena_(arena), bytes_(bytes) {}
+  ~CanvasArena() { Return(); }
+  SpanTextCanvas1* Borrow(uint16_t w, uint16_t h);
+  // no-op if nothing is borrowed
+  void Return();
+  // borrowed canvas or NULL
+  SpanTextCanvas1* canvas() const { return canvas_; }
+  int misses() const { return misses_; }
+
+private:
+  uint8_t* arena_;
+  size_t bytes_;
+  alignas(ArenaCanvas1) uint8_t view_[sizeof(ArenaCanvas1)];
+  SpanTextCanvas1* canvas_ = NULL;
+  int misses_ = 0;
+};
+
+#endif  // GFX_CANVASES_H
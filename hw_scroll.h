@@ -0,0 +1,101 @@
+#ifndef HW_SCROLL_H
+#define HW_SCROLL_H
+
+#include <stdint.h>
+
+// Controller vertical scroll used as a horizontal scroll in landscape, no Arduino dependencies.
+// With the MV (row / column exchange) bit set the panel gate lines run along screen x, and the scroll start address s
+// makes physical line L show memory line (L + s) mod ring. Memory column m written through setAddrWindow lands on
+// memory line m, or ring - 1 - m when MY mirrors it, so content drawn at memory column m shows at screen
+// x = (m - direction * s) mod ring.
+// Every memory column is on screen somewhere, so whatever must not be seen has to be bg in memory. The fly through
+// screensaver keeps only the canvas columns a plain blit at its screen x would show, see VisibleColumns and Plan.
+class HwScroll {
+public:
+  // MADCTL bits
+  static const uint8_t kMadctlMY = 0x80, kMadctlMX = 0x40, kMadctlMV = 0x20;
+
+  // MADCTL the Adafruit drivers write for a rotation
+  static uint8_t Madctl(bool st7789, uint8_t rotation) {
+    static const uint8_t kSt7789[4] = { kMadctlMX | kMadctlMY, kMadctlMY | kMadctlMV, 0, kMadctlMX | kMadctlMV };
+    static const uint8_t kIli9341[4] = { kMadctlMX, kMadctlMV, kMadctlMY, kMadctlMX | kMadctlMY | kMadctlMV };
+    return (st7789 ? kSt7789 : kIli9341)[rotation & 3];
+  }
+
+  // +1 if screen x increases with memory line, -1 if it decreases, landscape (MV) rotations only
+  static int8_t Direction(uint8_t madctl) { return ((madctl & kMadctlMY) ? -1 : 1); }
+
+  // a mod m in [0, m)
+  static int16_t PositiveMod(int32_t a, int16_t m) {
+    a %= m;
+    return (a < 0 ? a + m : a);
+  }
+
+  // memory column to draw at so content shows at screen_x
+  static int16_t MemoryX(int16_t screen_x, uint16_t offset, int8_t direction, int16_t ring) {
+    return PositiveMod((int32_t)screen_x + direction * (int32_t)offset, ring);
+  }
+
+  // scroll offset that shows content drawn at memory column memory_x at screen_x
+  static uint16_t Offset(int16_t screen_x, int16_t memory_x, int8_t direction, int16_t ring) {
+    return PositiveMod(direction * ((int32_t)memory_x - screen_x), ring);
+  }
+
+  // columns [*col0, *col1) of a w wide canvas at screen x that fit on a screen_w wide screen, (0, 0) if none
+  static void VisibleColumns(int16_t x, int16_t w, int16_t screen_w, int16_t* col0, int16_t* col1) {
+    int32_t c0 = (x < 0 ? -(int32_t)x : 0), c1 = (int32_t)screen_w - x;
+    if(c1 > w) c1 = w;
+    if(c0 >= c1)
+      c0 = c1 = 0;
+    *col0 = c0;
+    *col1 = c1;
+  }
+
+  // canvas column ranges to update when the visible columns go from [prev_col0, prev_col1) to [col0, col1):
+  // erase the ones that left, move the ones still there, draw the ones that came in
+  struct Plan {
+    int16_t erase[2][2];
+    uint8_t erase_count;
+    int16_t keep[2];
+    int16_t draw[2][2];
+    uint8_t draw_count;
+  };
+  static Plan ColumnPlan(int16_t prev_col0, int16_t prev_col1, int16_t col0, int16_t col1) {
+    Plan plan;
+    plan.erase_count = Subtract(prev_col0, prev_col1, col0, col1, plan.erase);
+    plan.draw_count = Subtract(col0, col1, prev_col0, prev_col1, plan.draw);
+    plan.keep[0] = (prev_col0 > col0 ? prev_col0 : col0);
+    plan.keep[1] = (prev_col1 < col1 ? prev_col1 : col1);
+    if(plan.keep[0] >= plan.keep[1])
+      plan.keep[0] = plan.keep[1] = 0;
+    return plan;
+  }
+
+private:
+  // [a0, a1) minus [b0, b1) as up to 2 ranges, returns how many
+  static uint8_t Subtract(int16_t a0, int16_t a1, int16_t b0, int16_t b1, int16_t out[2][2]) {
+    uint8_t n = 0;
+    if(b0 >= b1) {
+      if(a0 < a1) {
+        out[0][0] = a0;
+        out[0][1] = a1;
+        n = 1;
+      }
+      return n;
+    }
+    int16_t left_end = (a1 < b0 ? a1 : b0), right_start = (a0 > b1 ? a0 : b1);
+    if(a0 < left_end) {
+      out[n][0] = a0;
+      out[n][1] = left_end;
+      n++;
+    }
+    if(right_start < a1) {
+      out[n][0] = right_start;
+      out[n][1] = a1;
+      n++;
+    }
+    return n;
+  }
+};
+
+#endif  // HW_SCROLL_H
@@ -0,0 +1,50 @@
+#ifndef ISR_EVENT_RING_H
+#define ISR_EVENT_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Single producer / single consumer lock-free ring, no Arduino dependencies.
+// The producer (an ISR) only writes head_, the consumer (loop) only writes tail_, so neither side ever waits or
+// disables interrupts. Indexes run freely and wrap at 2^16, kCapacity must be a power of 2 so they wrap cleanly.
+// A push into a full ring is dropped and counted, events already queued are never overwritten.
+template <typename T, uint16_t kCapacity>
+class IsrEventRing {
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0, "IsrEventRing capacity must be a power of 2");
+  static_assert(kCapacity <= 0x8000, "IsrEventRing capacity must fit 16 bit indexes");
+
+public:
+  // producer side only, always inlined so it lands in the calling IRAM_ATTR ISR instead of flash
+  __attribute__((always_inline)) bool Push(const T& item) {
+    uint16_t head = head_.load(std::memory_order_relaxed);
+    if((uint16_t)(head - tail_.load(std::memory_order_acquire)) == kCapacity) {
+      overflows_.store(overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items_[head & (kCapacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side only, oldest event first
+  bool Pop(T* item) {
+    uint16_t tail = tail_.load(std::memory_order_relaxed);
+    if(tail == head_.load(std::memory_order_acquire))
+      return false;
+    *item = items_[tail & (kCapacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint16_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0; }
+  // events dropped because the ring was full
+  uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint16_t> head_{0}, tail_{0};
+  std::atomic<uint32_t> overflows_{0};
+  T items_[kCapacity];
+};
+
+#endif  // ISR_EVENT_RING_H
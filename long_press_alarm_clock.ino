@@ -114,10 +114,9 @@ uint8_t frames_per_second = 0;
 #endif
 
 // LOCAL FUNCTIONS
-// populate all pages in display_pages_vec
-void PopulateDisplayPages();
+// fill in button_values from saved settings
+void PopulateButtonValues();
 int DisplayPagesVecCurrentButtonIndex();
-int DisplayPagesVecButtonIndex(ScreenPage button_page, Cursor button_cursor);
 void LedButtonClickUiResponse(int response_type);
 void InitializeRgbLed();
 void RunRgbLedAccordingToSettings();
@@ -245,7 +244,7 @@ void setup() {
   InitializeRgbLed();
   RunRgbLedAccordingToSettings();
 
-  PopulateDisplayPages(); // needs to be after all saved values have been retrieved
+  PopulateButtonValues(); // needs to be after all saved values have been retrieved
 
   #if defined(ESP32_DUAL_CORE)
     xTaskCreatePinnedToCore(
@@ -320,21 +319,31 @@ void loop() {
     firmware_updated_flag_user_information = false;
   }
 
+  // start due backlight fade segments
+  display->UpdateBacklight();
+
   // new second! Update Time!
-  if (rtc->rtc_hw_sec_update_) {
-    rtc->rtc_hw_sec_update_ = false;
+  // drain every queued SQW tick first (lag, overflow, clock checks and DST steps happen per tick), then run the
+  // per second work once: it can block on NTP, OTA and page changes, so running it per tick would only queue more
+  RTC::SqwEvent sqw_event;
+  bool new_second = false, new_minute = false;
+  while (rtc->NextSqwEvent(&sqw_event)) {
+    new_second = true;
+    if(sqw_event.new_minute)
+      new_minute = true;
+  }
+  if (new_second) {
 
     // if time is lost because of power failure
-    if((rtc->year() < 2024) && !(wifi_stuff->incorrect_wifi_details_) && !(wifi_stuff->incorrect_zip_code)) {
+    if((rtc->year() < 2024) && !(wifi_stuff->incorrect_wifi_details_) && (rtc->timezone_valid() || !(wifi_stuff->incorrect_zip_code))) {
       PrintLn("**** Update RTC HW Time from NTP Server ****");
       // update time from NTP server
       AddSecondCoreTaskIfNotThere(kUpdateTimeFromNtpServer);
       WaitForExecutionOfSecondCoreTask();
     }
 
-    // new minute!
-    if (rtc->rtc_hw_min_update_) {
-      rtc->rtc_hw_min_update_ = false;
+    // new minute! (one or more minutes rolled over since last loop)
+    if (new_minute) {
 
       // PrintLn("New Minute!");
 
@@ -371,10 +380,11 @@ void loop() {
           wifi_stuff->auto_updated_time_today_ = false;
 
         // auto update time at 3:05 AM  every morning
-        // (daylight savings time that kicks in and ends at 2AM in March and November once every year. At exactly 2AM, server time might not have updated)
+        // (daylight savings time changes are applied on device from the timezone rules, this only trims RTC drift.
+        // without valid timezone rules the offset comes from weather and DST is picked up here, after the 2AM change)
         // try for upto 55 times - once per min until successful time update
         // time update will be checked using wifi_stuff->auto_updated_time_today_
-        if(!(wifi_stuff->incorrect_zip_code) && !(wifi_stuff->auto_updated_time_today_) && (rtc->hourModeAndAmPm() == 1 && rtc->hour() == 3 && rtc->minute() >= 5)) {
+        if((rtc->timezone_valid() || !(wifi_stuff->incorrect_zip_code)) && !(wifi_stuff->auto_updated_time_today_) && (rtc->hourModeAndAmPm() == 1 && rtc->hour() == 3 && rtc->minute() >= 5)) {
           // update time from NTP server
           AddSecondCoreTaskIfNotThere(kUpdateTimeFromNtpServer);
           PrintLn("Get Time Update from NTP Server");
@@ -458,19 +468,43 @@ void loop() {
     // print fps
     if(debug_mode && current_page == kScreensaverPage) {
       PrintLn("FPS: ", frames_per_second);
+      Serial.printf("Blit expand %lu us, transfer %lu us\n", display->fast_draw_expand_us_, display->fast_draw_transfer_us_);
+      if(display->screensaver_motion_blit_)
+        Serial.printf("Motion blit saved %ld bytes last frame\n", display->motion_blit_saved_bytes_);
+      Serial.printf("Target FPS %u, frame interval %lu..%lu ms, idle %lu%%\n", display->ScreensaverTargetFps(), display->screensaver_frame_interval_min_ms_, display->screensaver_frame_interval_max_ms_, display->screensaver_idle_ms_ / 10);
+      display->screensaver_frame_interval_min_ms_ = ULONG_MAX;
+      display->screensaver_frame_interval_max_ms_ = 0;
+      display->screensaver_idle_ms_ = 0;
       frames_per_second = 0;
     }
     #endif
   }
 
-  // make screensaver motion
+  // make screensaver motion at target frame rate, idle in between instead of spinning
   if(current_page == kScreensaverPage) {
-    display->Screensaver();
-    #ifdef MORE_LOGS
-    if(debug_mode) frames_per_second++;
-    #endif
+    unsigned long wait_ms = display->ScreensaverMsToNextFrame();
+    if(wait_ms == 0) {
+      display->Screensaver();
+      #ifdef MORE_LOGS
+      if(debug_mode) frames_per_second++;
+      #endif
+    }
+    else {
+      // short sleeps so buttons, touch and serial input stay responsive
+      const unsigned long kScreensaverIdleSliceMs = 10;
+      unsigned long sleep_ms = min(wait_ms, kScreensaverIdleSliceMs);
+      delay(sleep_ms);
+      #ifdef MORE_LOGS
+      display->screensaver_idle_ms_ += sleep_ms;
+      #endif
+    }
   }
 
+  #ifdef PSRAM_FRAMEBUFFER
+  // send settings page changes drawn in PSRAM frame
+  display->FlushFrame();
+  #endif
+
   // accept user serial inputs
   if (Serial.available() != 0)
     SerialUserInput();
@@ -661,8 +695,122 @@ bool debug_mode = false;
 // firmware updated flag user information
 bool firmware_updated_flag_user_information = false;
 
-// all display buttons vector
-std::vector<std::vector<DisplayButton*>> display_pages_vec(kNoPageSelected);
+// display page button tables
+// cursor ids, button types, labels and fixed geometry are all known at compile time and the tables stay in flash.
+// Values that depend on saved settings live in button_values, filled in by PopulateButtonValues()
+//// struct decleration in common.h
+//struct DisplayButton {
+//  Cursor btn_cursor_id;
+//  ButtonType btn_type;
+//  const char* row_label;
+//  bool fixed_location;
+//  ButtonRect fixed_rect;
+//  ButtonValueSlot value_slot;
+//  const char* fixed_value;
+//};
+#define PAGE_SAVE_BUTTON { /* Save Button */ kPageSaveButton, kClickButtonWithLabel, "", true, PageLayout::kSaveButton, kFixedButtonValue, kSaveStr }
+#define PAGE_BACK_BUTTON { /* Back Button */ kPageBackButton, kClickButtonWithLabel, "", true, PageLayout::kBackButton, kFixedButtonValue, kBackStr }
+#define ROW_BUTTON(cursor, type, label, value) { cursor, type, label, false, PageLayout::kNoButton, kFixedButtonValue, value }
+#define ROW_BUTTON_WITH_SLOT(cursor, type, label, slot) { cursor, type, label, false, PageLayout::kNoButton, slot, "" }
+
+// MAIN PAGE
+constexpr DisplayButton main_page_buttons[] = {
+  { /* No Selection */ kCursorNoSelection, kClickButtonWithIcon, "", true, PageLayout::kNoButton, kFixedButtonValue, "" },
+  { /* Settings Wheel */ kMainPageSettingsWheel, kClickButtonWithIcon, "", true, PageLayout::kSettingsGear, kFixedButtonValue, "" },
+  { /* Alarms Row     */ kMainPageSetAlarm, kClickButtonWithIcon, "", true, PageLayout::kAlarmRow, kFixedButtonValue, "" },
+};
+
+// ALARM SET PAGE
+// this page is handled as a special case
+
+// SETTINGS PAGE
+constexpr DisplayButton settings_page_buttons[] = {
+  ROW_BUTTON(kSettingsPageWiFi, kClickButtonWithLabel, "WiFi Settings:", "WIFI"),
+  ROW_BUTTON(kSettingsPageLocationAndWeather, kClickButtonWithLabel, "Location Settings:", "LOCATION"),
+  ROW_BUTTON_WITH_SLOT(kSettingsPageAlarmLongPressTime, kClickButtonWithLabel, "Long Press / Alarm Snooze Hold Time:", kLongPressTimeValue),
+  ROW_BUTTON(kSettingsPageScreensaver, kClickButtonWithLabel, "Set RGB LEDs &:", "SCREENSAVER"),
+  ROW_BUTTON(kSettingsPageRotateScreen, kClickButtonWithLabel, "Rotate Screen:", "ROTATE"),
+  ROW_BUTTON(kSettingsPageUpdate, kClickButtonWithLabel, "Firmware Update:", "UPDATE"),
+  PAGE_BACK_BUTTON,
+};
+
+// WIFI SETTINGS PAGE
+constexpr DisplayButton wifi_settings_page_buttons[] = {
+  ROW_BUTTON_WITH_SLOT(kWiFiSettingsPageShowSsidRow, kLabelOnlyNoClickButton, "Saved WiFi:", kSavedWiFiValue),
+  ROW_BUTTON(kWiFiSettingsPageScanNetworks, kClickButtonWithLabel, "Scan Networks:", "SCAN WIFI"),
+  ROW_BUTTON(kWiFiSettingsPageChangePasswd, kClickButtonWithLabel, "Change Password:", "WIFI PASSWD"),
+  ROW_BUTTON(kWiFiSettingsPageClearSsidAndPasswd, kClickButtonWithLabel, "Clear WiFi Details:", "CLEAR"),
+  ROW_BUTTON(kWiFiSettingsPageConnect, kClickButtonWithLabel, "", "CONNECT WIFI"),
+  ROW_BUTTON(kWiFiSettingsPageDisconnect, kClickButtonWithLabel, "", "DISCONNECT"),
+  PAGE_BACK_BUTTON,
+};
+
+// WIFI SCAN NETWORKS PAGE
+constexpr DisplayButton wifi_scan_networks_page_buttons[] = {
+  { kWiFiScanNetworksPageList, kClickButtonWithIcon, "", true, PageLayout::kNoButton, kFixedButtonValue, "" },
+  { kWiFiScanNetworksPageRescan, kClickButtonWithLabel, "", true, PageLayout::kRescanButton, kFixedButtonValue, kRescanStr },
+  { kWiFiScanNetworksPageNext, kClickButtonWithLabel, "", true, PageLayout::kNextButton, kFixedButtonValue, kNextStr },
+  PAGE_BACK_BUTTON,
+};
+
+// WIFI DETAILS SOFT AP PAGE
+constexpr DisplayButton soft_ap_inputs_page_buttons[] = {
+  PAGE_SAVE_BUTTON,
+  PAGE_BACK_BUTTON,
+};
+
+// LOCATION AND WEATHER SETTINGS PAGE
+constexpr DisplayButton location_and_weather_settings_page_buttons[] = {
+  ROW_BUTTON_WITH_SLOT(kLocationAndWeatherSettingsPageSetLocation, kClickButtonWithLabel, "City:", kLocationValue),
+  ROW_BUTTON_WITH_SLOT(kLocationAndWeatherSettingsPageUnits, kClickButtonWithLabel, "Set Units:", kWeatherUnitsValue),
+  ROW_BUTTON(kLocationAndWeatherSettingsPageFetch, kClickButtonWithLabel, "Fetch Weather:", "FETCH"),
+  ROW_BUTTON(kLocationAndWeatherSettingsPageUpdateTime, kClickButtonWithLabel, "Time-Zone:", "UPDATE TIME"),
+  PAGE_BACK_BUTTON,
+};
+
+// LOCATION INPUT DETAILS PAGE
+constexpr DisplayButton location_inputs_page_buttons[] = {
+  PAGE_SAVE_BUTTON,
+  PAGE_BACK_BUTTON,
+};
+
+// SCREENSAVER SETTINGS PAGE
+static_assert(kEveningTimeMinutes / 60 - 12 == 6, "update evening time label");
+constexpr DisplayButton screensaver_settings_page_buttons[] = {
+  ROW_BUTTON_WITH_SLOT(kScreensaverSettingsPageMotion, kClickButtonWithLabel, "Screensaver Motion:", kScreensaverMotionValue),
+  ROW_BUTTON_WITH_SLOT(kScreensaverSettingsPageSpeed, kClickButtonWithLabel, "Screensaver Speed:", kScreensaverSpeedValue),
+  ROW_BUTTON(kScreensaverSettingsPageRun, kClickButtonWithLabel, "Run Screensaver:", "RUN"),
+  ROW_BUTTON_WITH_SLOT(kScreensaverSettingsPageRgbLedStripMode, kClickButtonWithLabel, "RGB LEDs Mode:", kRgbLedModeValue),
+  ROW_BUTTON_WITH_SLOT(kScreensaverSettingsPageNightTmDimHr, kClickButtonWithLabel, "Evening time is 6PM to:", kNightTimeDimHourValue),
+  ROW_BUTTON_WITH_SLOT(kScreensaverSettingsPageRgbLedBrightness, kClickButtonWithLabel, "RGB LEDs Brightness:", kRgbLedBrightnessValue),
+  PAGE_BACK_BUTTON,
+};
+
+#define DISPLAY_PAGE(buttons) { buttons, sizeof(buttons) / sizeof(buttons[0]) }
+#define NO_BUTTONS_PAGE { NULL, 0 }
+
+// all display pages, in ScreenPage order
+static_assert(kNoPageSelected == 15, "display_pages_vec needs an entry for every ScreenPage");
+constexpr DisplayPage display_pages_vec[kNoPageSelected] = {
+  /* kMainPage */                             DISPLAY_PAGE(main_page_buttons),
+  /* kScreensaverPage */                      NO_BUTTONS_PAGE,
+  /* kScreensaverSettingsPage */              DISPLAY_PAGE(screensaver_settings_page_buttons),
+  /* kAlarmSetPage */                         NO_BUTTONS_PAGE,
+  /* kAlarmTriggeredPage */                   NO_BUTTONS_PAGE,
+  /* kTimeSetPage */                          NO_BUTTONS_PAGE,
+  /* kSettingsPage */                         DISPLAY_PAGE(settings_page_buttons),
+  /* kWiFiSettingsPage */                     DISPLAY_PAGE(wifi_settings_page_buttons),
+  /* kWiFiScanNetworksPage */                 DISPLAY_PAGE(wifi_scan_networks_page_buttons),
+  /* kSoftApInputsPage */                     DISPLAY_PAGE(soft_ap_inputs_page_buttons),
+  /* kLocationAndWeatherSettingsPage */       DISPLAY_PAGE(location_and_weather_settings_page_buttons),
+  /* kLocationInputsPage */                   DISPLAY_PAGE(location_inputs_page_buttons),
+  /* kEnterWeatherLocationZipPage */          NO_BUTTONS_PAGE,
+  /* kEnterWeatherLocationCountryCodePage */  NO_BUTTONS_PAGE,
+  /* kFirmwareUpdatePage */                   NO_BUTTONS_PAGE,
+};
+
+// runtime button values, zero initialized, no constructors run at boot
+char button_values[kButtonValueSlots][kButtonValueSize];
 
 // CPU Speed for ESP32 CPU
 uint8_t cpu_speed_mhz = 80;
@@ -1157,6 +1305,67 @@ void SerialUserInput() {
         display->refresh_screensaver_canvas_ = true;
       }
       break;
+    case 'D':   // toggle main page time row dirty region / full row redraw
+      display->time_row_dirty_regions_only_ = !display->time_row_dirty_regions_only_;
+      PrintLn("time_row_dirty_regions_only_ = ", display->time_row_dirty_regions_only_);
+      break;
+    case 'M':   // toggle screensaver motion blit / full canvas blit
+      display->screensaver_motion_blit_ = !display->screensaver_motion_blit_;
+      PrintLn("screensaver_motion_blit_ = ", display->screensaver_motion_blit_);
+      break;
+    case 'V':   // toggle fly through screensaver hardware scroll
+      display->screensaver_hw_scroll_ = !display->screensaver_hw_scroll_;
+      PrintLn("screensaver_hw_scroll_ = ", display->screensaver_hw_scroll_);
+      break;
+    case 'G':   // toggle span / per pixel glyph printing on 1 bit canvases
+      display->canvas_span_text_ = !display->canvas_span_text_;
+      PrintLn("canvas_span_text_ = ", display->canvas_span_text_);
+      break;
+    case 'L':   // text layout cache hits / misses
+      PrintLn("text_layout_cache_ hits = ", (int)display->text_layout_cache_.hits);
+      PrintLn("text_layout_cache_ misses = ", (int)display->text_layout_cache_.misses);
+      break;
+    case 'A':   // photoresistor raw / filtered reading
+      PrintLn("ambient light raw = ", (int)AmbientLightFilter::SnapshotRaw(display->AmbientLightSnapshot()));
+      PrintLn("ambient light filtered = ", (int)AmbientLightFilter::SnapshotFiltered(display->AmbientLightSnapshot()));
+      break;
+    case 'Z':   // set POSIX TZ timezone string, e.g. PST8PDT,M3.2.0,M11.1.0, empty to use weather GMT offset
+      {
+        PrintLn("POSIX TZ:");
+        SerialInputWait();
+        String inputStr = Serial.readString();
+        std::string posix_tz = "";
+        for (int i = 0; i < min(inputStr.length(), kPosixTzLengthMax); i++)
+          if(inputStr[i] != '\0' && inputStr[i] != '\n' && inputStr[i] != '\r')
+            posix_tz = posix_tz + inputStr[i];
+        if(rtc->SetTimezone(posix_tz) || posix_tz.empty())
+          nvs_preferences->SaveTimezone(posix_tz);
+        PrintLn("utc_offset_sec_ = ", (int)rtc->utc_offset_sec());
+        PrintLn("next_transition_utc_ = ", (int)rtc->next_transition_utc());
+      }
+      break;
+    case 'E':   // SQW tick events dropped, worst loop lag and software clock checks, then reset lag
+      PrintLn("sqw_event_overflows = ", (int)rtc->sqw_event_overflows());
+      PrintLn("sqw_event_lag_max_us_ = ", (int)rtc->sqw_event_lag_max_us_);
+      PrintLn("clock_drift_count_ = ", (int)rtc->clock_drift_count_);
+      PrintLn("clock_mismatch_count_ = ", (int)rtc->clock_mismatch_count_);
+      rtc->sqw_event_lag_max_us_ = 0;
+      break;
+    case 'B':   // backlight current / target brightness
+      PrintLn("backlight current = ", (int)display->backlight_fader_.CurrentLevel(millis()));
+      PrintLn("backlight target = ", (int)display->backlight_fader_.target());
+      break;
+    case 'R':   // render time histograms, then start over
+      #ifdef RENDER_PROFILING
+      for(uint8_t i = 0; i < kRenderSectionCount; i++) {
+        const RenderHistogram& histogram = display->render_profiler_.histogram((RenderSection)i);
+        Serial.printf("%-22s n %6lu  p50 %7lu us  p99 %7lu us  max %7lu us\n", RenderProfiler::SectionName((RenderSection)i), (unsigned long)histogram.count(), (unsigned long)histogram.Percentile(50), (unsigned long)histogram.Percentile(99), (unsigned long)histogram.max_us());
+      }
+      display->render_profiler_.Clear();
+      #else
+      PrintLn("RENDER_PROFILING is not defined in configuration.h");
+      #endif
+      break;
     default:
       PrintLn("Unrecognized user input");
   }
@@ -1230,6 +1439,13 @@ void SetPage(ScreenPage set_this_page, bool move_cursor_to_first_button) {
 }
 
 void SetPage(ScreenPage set_this_page, bool move_cursor_to_first_button, bool increment_page) {
+  // page drawing starts from a fresh screen
+  display->InvalidateRetainedPage();
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  // only screensaver runs with a controller scroll offset
+  if(set_this_page != kScreensaverPage)
+    display->StopHwScroll();
+  #endif
   switch(set_this_page) {
     case kMainPage:
       // if screensaver is active then clear screensaver canvas to free memory
@@ -1431,96 +1647,34 @@ void MoveCursor(bool increment) {
   delay(2*kUserInputDelayMs);
 }
 
-// populate all pages in display_pages_vec
-void PopulateDisplayPages() {
-  //// struct decleration in common.h
-  //struct DisplayButton {
-  //  const Cursor btn_cursor_id;
-  //  const ButtonType btn_type;
-  //  const std::string row_label;
-  //  const bool fixed_location;
-  //  int16_t btn_x;
-  //  int16_t btn_y;
-  //  uint16_t btn_w;
-  //  uint16_t btn_h;
-  //  std::string btn_value;
-  //};
-
-  DisplayButton* page_save_button = new DisplayButton{ /* Save Button */ kPageSaveButton, kClickButtonWithLabel, "", true, kSaveButtonX1, kSaveButtonY1, kSaveButtonW, kSaveButtonH, kSaveStr };
-  DisplayButton* page_back_button = new DisplayButton{ /* Back Button */ kPageBackButton, kClickButtonWithLabel, "", true, kBackButtonX1, kBackButtonY1, kBackButtonW, kBackButtonH, kBackStr };
-
-  // MAIN PAGE
-  display_pages_vec[kMainPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ /* No Selection */ kCursorNoSelection, kClickButtonWithIcon, "", true, 0, 0, 0, 0, "" },
-    new DisplayButton{ /* Settings Wheel */ kMainPageSettingsWheel, kClickButtonWithIcon, "", true, kSettingsGearX1, kSettingsGearY1, kSettingsGearWidth, kSettingsGearHeight, "" },
-    new DisplayButton{ /* Alarms Row     */ kMainPageSetAlarm, kClickButtonWithIcon, "", true, 1, kAlarmRowY1, kTftWidth - 2, kTftHeight - kAlarmRowY1 - 1, "" },
-  };
-
-  // ALARM SET PAGE
-  // this page is handled as a special case
-
+// fill in button values that depend on saved settings
+void PopulateButtonValues() {
   // SETTINGS PAGE
-  display_pages_vec[kSettingsPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ kSettingsPageWiFi, kClickButtonWithLabel, "WiFi Settings:", false, 0,0,0,0, "WIFI" },
-    new DisplayButton{ kSettingsPageLocationAndWeather, kClickButtonWithLabel, "Location Settings:", false, 0,0,0,0, "LOCATION" },
-    new DisplayButton{ kSettingsPageAlarmLongPressTime, kClickButtonWithLabel, "Long Press / Alarm Snooze Hold Time:", false, 0,0,0,0, (std::to_string(alarm_clock->alarm_long_press_seconds_) + "sec") },
-    new DisplayButton{ kSettingsPageScreensaver, kClickButtonWithLabel, "Set RGB LEDs &:", false, 0,0,0,0, "SCREENSAVER" },
-    new DisplayButton{ kSettingsPageRotateScreen, kClickButtonWithLabel, "Rotate Screen:", false, 0,0,0,0, "ROTATE" },
-    new DisplayButton{ kSettingsPageUpdate, kClickButtonWithLabel, "Firmware Update:", false, 0,0,0,0, "UPDATE" },
-    page_back_button,
-  };
+  SetButtonValue(kLongPressTimeValue, (std::to_string(alarm_clock->alarm_long_press_seconds_) + "sec").c_str());
 
   // WIFI SETTINGS PAGE
-  display_pages_vec[kWiFiSettingsPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ kWiFiSettingsPageShowSsidRow, kLabelOnlyNoClickButton, "Saved WiFi:", false, 0,0,0,0, wifi_stuff->WiFiDetailsShortString() },
-    new DisplayButton{ kWiFiSettingsPageScanNetworks, kClickButtonWithLabel, "Scan Networks:", false, 0,0,0,0, "SCAN WIFI" },
-    new DisplayButton{ kWiFiSettingsPageChangePasswd, kClickButtonWithLabel, "Change Password:", false, 0,0,0,0, "WIFI PASSWD" },
-    new DisplayButton{ kWiFiSettingsPageClearSsidAndPasswd, kClickButtonWithLabel, "Clear WiFi Details:", false, 0,0,0,0, "CLEAR" },
-    new DisplayButton{ kWiFiSettingsPageConnect, kClickButtonWithLabel, "", false, 0,0,0,0, "CONNECT WIFI" },
-    new DisplayButton{ kWiFiSettingsPageDisconnect, kClickButtonWithLabel, "", false, 0,0,0,0, "DISCONNECT" },
-    page_back_button,
-  };
-
-  // WIFI SCAN NETWORKS PAGE
-  display_pages_vec[kWiFiScanNetworksPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ kWiFiScanNetworksPageList, kClickButtonWithIcon, "", true, 0, 0, 0, 0, "" },
-    new DisplayButton{ kWiFiScanNetworksPageRescan, kClickButtonWithLabel, "", true, kRescanButtonX1, kRescanButtonY1, kRescanButtonW, kRescanButtonH, kRescanStr },
-    new DisplayButton{ kWiFiScanNetworksPageNext, kClickButtonWithLabel, "", true, kNextButtonX1, kNextButtonY1, kNextButtonW, kNextButtonH, kNextStr },
-    page_back_button,
-  };
-
-  // WIFI DETAILS SOFT AP PAGE
-  display_pages_vec[kSoftApInputsPage] = std::vector<DisplayButton*> {
-    page_save_button,
-    page_back_button,
-  };
+  SetButtonValue(kSavedWiFiValue, wifi_stuff->WiFiDetailsShortString().c_str());
 
   // LOCATION AND WEATHER SETTINGS PAGE
-  display_pages_vec[kLocationAndWeatherSettingsPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ kLocationAndWeatherSettingsPageSetLocation, kClickButtonWithLabel, "City:", false, 0,0,0,0, (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_) },
-    new DisplayButton{ kLocationAndWeatherSettingsPageUnits, kClickButtonWithLabel, "Set Units:", false, 0,0,0,0, (wifi_stuff->weather_units_metric_not_imperial_ ? kMetricUnitStr : kImperialUnitStr) },
-    new DisplayButton{ kLocationAndWeatherSettingsPageFetch, kClickButtonWithLabel, "Fetch Weather:", false, 0,0,0,0, "FETCH" },
-    new DisplayButton{ kLocationAndWeatherSettingsPageUpdateTime, kClickButtonWithLabel, "Time-Zone:", false, 0,0,0,0, "UPDATE TIME" },
-    page_back_button,
-  };
-
-  // LOCATION INPUT DETAILS PAGE
-  display_pages_vec[kLocationInputsPage] = std::vector<DisplayButton*> {
-    page_save_button,
-    page_back_button,
-  };
+  SetButtonValue(kLocationValue, (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_).c_str());
+  SetButtonValue(kWeatherUnitsValue, (wifi_stuff->weather_units_metric_not_imperial_ ? kMetricUnitStr : kImperialUnitStr));
 
   // SCREENSAVER SETTINGS PAGE
-  display_pages_vec[kScreensaverSettingsPage] = std::vector<DisplayButton*> {
-    new DisplayButton{ kScreensaverSettingsPageMotion, kClickButtonWithLabel, "Screensaver Motion:", false, 0,0,0,0, (display->screensaver_bounce_not_fly_horizontally_ ? kBounceScreensaverStr : kFlyOutScreensaverStr) },
-    new DisplayButton{ kScreensaverSettingsPageSpeed, kClickButtonWithLabel, "Screensaver Speed:", false, 0,0,0,0, (cpu_speed_mhz == 80 ? kSlowStr : (cpu_speed_mhz == 160 ? kMediumStr : kFastStr)) },
-    new DisplayButton{ kScreensaverSettingsPageRun, kClickButtonWithLabel, "Run Screensaver:", false, 0,0,0,0, "RUN" },
-    new DisplayButton{ kScreensaverSettingsPageRgbLedStripMode, kClickButtonWithLabel, "RGB LEDs Mode:", false, 0,0,0,0, RgbLedSettingString() },
-    new DisplayButton{ kScreensaverSettingsPageNightTmDimHr, kClickButtonWithLabel, ("Evening time is " + std::to_string(kEveningTimeMinutes / 60 - 12) + "PM to:"), false, 0,0,0,0, (std::to_string(nvs_preferences->RetrieveNightTimeDimHour()) + "PM") },
-    new DisplayButton{ kScreensaverSettingsPageRgbLedBrightness, kClickButtonWithLabel, "RGB LEDs Brightness:", false, 0,0,0,0, (std::to_string(int(static_cast<float>(rgb_strip_led_brightness) / 255 * 100)) + "%") },
-    page_back_button,
-  };
+  SetButtonValue(kScreensaverMotionValue, (display->screensaver_bounce_not_fly_horizontally_ ? kBounceScreensaverStr : kFlyOutScreensaverStr));
+  SetButtonValue(kScreensaverSpeedValue, (cpu_speed_mhz == 80 ? kSlowStr : (cpu_speed_mhz == 160 ? kMediumStr : kFastStr)));
+  SetButtonValue(kRgbLedModeValue, RgbLedSettingString());
+  SetButtonValue(kNightTimeDimHourValue, (std::to_string(nvs_preferences->RetrieveNightTimeDimHour()) + "PM").c_str());
+  SetButtonValue(kRgbLedBrightnessValue, (std::to_string(int(static_cast<float>(rgb_strip_led_brightness) / 255 * 100)) + "%").c_str());
+}
 
+const char* ButtonValue(const DisplayButton* button) {
+  return (button->value_slot == kFixedButtonValue ? button->fixed_value : button_values[button->value_slot]);
+}
+
+// longer values are cut to the slot, 23 characters is more than a row button has room for
+void SetButtonValue(ButtonValueSlot slot, const char* value) {
+  strncpy(button_values[slot], value, kButtonValueSize - 1);
+  button_values[slot][kButtonValueSize - 1] = '\0';
 }
 
 int DisplayPagesVecCurrentButtonIndex() {
@@ -1531,14 +1685,6 @@ int DisplayPagesVecCurrentButtonIndex() {
   return -1;
 }
 
-int DisplayPagesVecButtonIndex(ScreenPage button_page, Cursor button_cursor) {
-  for (int i = 0; i < display_pages_vec[button_page].size(); i++) {
-    if(display_pages_vec[button_page][i]->btn_cursor_id == button_cursor)
-      return i;
-  }
-  return -1;
-}
-
 void LedOnOffResponse() {
   ResponseLed(HIGH);
   delay(kUserInputDelayMs);
@@ -1555,19 +1701,23 @@ void ResponseLed(bool value) {
     default: turn On Button, wait & turn Off button
 */
 void LedButtonClickUiResponse(int response_type = 0) {
+  // the pressed button is sent to the panel right away, callers wait on it before loop() would flush the PSRAM frame
   switch (response_type) {
     case 1:   // turn On Button, wait
       display->DisplayCurrentPageButtonRow(/*is_on = */ true);
+      display->FlushFrame();
       delay(kUserInputDelayMs);
       break;
     case 2:   // turn On Button
       display->DisplayCurrentPageButtonRow(/*is_on = */ true);
+      display->FlushFrame();
       break;
     case 3:   // turn Off Button
       display->DisplayCurrentPageButtonRow(/*is_on = */ false);
       break;
     default:     // turn On Button, wait, turn Off button
       display->DisplayCurrentPageButtonRow(/*is_on = */ true);
+      display->FlushFrame();
       delay(kUserInputDelayMs);
       display->DisplayCurrentPageButtonRow(/*is_on = */ false);
   }
@@ -1631,7 +1781,7 @@ void LedButtonClickAction() {
           alarm_clock->alarm_long_press_seconds_ += 10;
         else
           alarm_clock->alarm_long_press_seconds_ = 5;
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = std::to_string(alarm_clock->alarm_long_press_seconds_) + "sec";
+        SetButtonValue(kLongPressTimeValue, (std::to_string(alarm_clock->alarm_long_press_seconds_) + "sec").c_str());
         nvs_preferences->SaveLongPressSeconds(alarm_clock->alarm_long_press_seconds_);
         LedButtonClickUiResponse();
       }
@@ -1677,8 +1827,7 @@ void LedButtonClickAction() {
         wifi_stuff->wifi_password_ = "Enter Passwd";
         wifi_stuff->SaveWiFiDetails();
         // update Settings Page WiFi ssid row
-        int index_of_ssid_button = DisplayPagesVecButtonIndex(kWiFiSettingsPage, kWiFiSettingsPageShowSsidRow);
-        display_pages_vec[kWiFiSettingsPage][index_of_ssid_button]->btn_value = wifi_stuff->WiFiDetailsShortString();
+        SetButtonValue(kSavedWiFiValue, wifi_stuff->WiFiDetailsShortString().c_str());
         SetPage(kWiFiSettingsPage, /* bool move_cursor_to_first_button = */ false);
       }
       else if(current_cursor == kWiFiSettingsPageConnect) {
@@ -1711,8 +1860,7 @@ void LedButtonClickAction() {
         wifi_stuff->WiFiScanNetworksFreeMemory();
         wifi_stuff->SaveWiFiDetails();
         // update Settings Page WiFi ssid row
-        int index_of_ssid_button = DisplayPagesVecButtonIndex(kWiFiSettingsPage, kWiFiSettingsPageShowSsidRow);
-        display_pages_vec[kWiFiSettingsPage][index_of_ssid_button]->btn_value = wifi_stuff->WiFiDetailsShortString();
+        SetButtonValue(kSavedWiFiValue, wifi_stuff->WiFiDetailsShortString().c_str());
         // get WiFi Password Input
         WiFiPasswordInputTouchAndNonTouch();
       }
@@ -1783,9 +1931,7 @@ void LedButtonClickAction() {
               wifi_stuff->location_country_code_ = returnText;
               wifi_stuff->SaveWeatherLocationDetails();
               // update new location Zip/Pin code on button
-              int display_pages_vec_location_and_weather_button_index = DisplayPagesVecButtonIndex(kLocationAndWeatherSettingsPage, kLocationAndWeatherSettingsPageSetLocation);
-              std::string location_str = (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_);
-              display_pages_vec[kLocationAndWeatherSettingsPage][display_pages_vec_location_and_weather_button_index]->btn_value = location_str;
+              SetButtonValue(kLocationValue, (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_).c_str());
               // get new location, update time and weather info
               AddSecondCoreTaskIfNotThere(kUpdateTimeFromNtpServer);
               WaitForExecutionOfSecondCoreTask();
@@ -1803,7 +1949,7 @@ void LedButtonClickAction() {
         wifi_stuff->weather_units_metric_not_imperial_ = !wifi_stuff->weather_units_metric_not_imperial_;
         wifi_stuff->SaveWeatherUnits();
         wifi_stuff->got_weather_info_ = false;
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = (wifi_stuff->weather_units_metric_not_imperial_ ? kMetricUnitStr : kImperialUnitStr);
+        SetButtonValue(kWeatherUnitsValue, (wifi_stuff->weather_units_metric_not_imperial_ ? kMetricUnitStr : kImperialUnitStr));
         LedButtonClickUiResponse(1);
         // fetch weather info in new units
         AddSecondCoreTaskIfNotThere(kGetWeatherInfo);
@@ -1840,9 +1986,7 @@ void LedButtonClickAction() {
         WaitForExecutionOfSecondCoreTask();
         wifi_stuff->got_weather_info_ = false;
         // update new location Zip/Pin code on button
-        int display_pages_vec_location_and_weather_button_index = DisplayPagesVecButtonIndex(kLocationAndWeatherSettingsPage, kLocationAndWeatherSettingsPageSetLocation);
-        std::string location_str = (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_);
-        display_pages_vec[kLocationAndWeatherSettingsPage][display_pages_vec_location_and_weather_button_index]->btn_value = location_str;
+        SetButtonValue(kLocationValue, (std::to_string(wifi_stuff->location_zip_code_) + " " + wifi_stuff->location_country_code_).c_str());
         // got new location, update time and weather info
         AddSecondCoreTaskIfNotThere(kUpdateTimeFromNtpServer);
       }
@@ -1856,13 +2000,13 @@ void LedButtonClickAction() {
     else if(current_page == kScreensaverSettingsPage) {        // SCREENSAVER SETTINGS PAGE
       if(current_cursor == kScreensaverSettingsPageMotion) {
         display->screensaver_bounce_not_fly_horizontally_ = !display->screensaver_bounce_not_fly_horizontally_;
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = (display->screensaver_bounce_not_fly_horizontally_ ? kBounceScreensaverStr : kFlyOutScreensaverStr);
+        SetButtonValue(kScreensaverMotionValue, (display->screensaver_bounce_not_fly_horizontally_ ? kBounceScreensaverStr : kFlyOutScreensaverStr));
         nvs_preferences->SaveScreensaverBounceNotFlyHorizontally(display->screensaver_bounce_not_fly_horizontally_);
         LedButtonClickUiResponse();
       }
       else if(current_cursor == kScreensaverSettingsPageSpeed) {
         CycleCpuFrequency();
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = (cpu_speed_mhz == 80 ? kSlowStr : (cpu_speed_mhz == 160 ? kMediumStr : kFastStr));
+        SetButtonValue(kScreensaverSpeedValue, (cpu_speed_mhz == 80 ? kSlowStr : (cpu_speed_mhz == 160 ? kMediumStr : kFastStr)));
         LedButtonClickUiResponse();
       }
       else if(current_cursor == kScreensaverSettingsPageRun) {
@@ -1878,7 +2022,7 @@ void LedButtonClickAction() {
           night_time_dim_hour = 7;
         nvs_preferences->SaveNightTimeDimHour(night_time_dim_hour);
         night_time_minutes = night_time_dim_hour * 60 + 720;
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = (std::to_string(night_time_dim_hour) + "PM");
+        SetButtonValue(kNightTimeDimHourValue, (std::to_string(night_time_dim_hour) + "PM").c_str());
         LedButtonClickUiResponse();
       }
       else if(current_cursor == kScreensaverSettingsPageRgbLedStripMode) {
@@ -1888,7 +2032,7 @@ void LedButtonClickAction() {
           autorun_rgb_led_strip_mode = 0;
         nvs_preferences->SaveAutorunRgbLedStripMode(autorun_rgb_led_strip_mode);
         RunRgbLedAccordingToSettings();
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = RgbLedSettingString();
+        SetButtonValue(kRgbLedModeValue, RgbLedSettingString());
         LedButtonClickUiResponse();
       }
       else if(current_cursor == kScreensaverSettingsPageRgbLedBrightness) {
@@ -1897,7 +2041,7 @@ void LedButtonClickAction() {
           rgb_strip_led_brightness += 51;
         else
           rgb_strip_led_brightness = 51;
-        display_pages_vec[current_page][DisplayPagesVecCurrentButtonIndex()]->btn_value = (std::to_string(int(static_cast<float>(rgb_strip_led_brightness) / 255 * 100)) + "%");
+        SetButtonValue(kRgbLedBrightnessValue, (std::to_string(int(static_cast<float>(rgb_strip_led_brightness) / 255 * 100)) + "%").c_str());
         nvs_preferences->SaveRgbStripLedBrightness(rgb_strip_led_brightness);
         InitializeRgbLed();
         RunRgbLedAccordingToSettings();
@@ -63,6 +63,10 @@ NvsPreferences::NvsPreferences() {
     preferences.putUChar(kRgbStripLedCountKey, kRgbStripLedCount);
   if(!preferences.isKey(kRgbStripLedBrightnessKey))
     preferences.putUChar(kRgbStripLedBrightnessKey, kRgbStripLedBrightness);
+  if(!preferences.isKey(kTimezoneKey)) {
+    String kTimezoneString = kTimezone.c_str();
+    preferences.putString(kTimezoneKey, kTimezoneString);
+  }
 
   // save new key values
   // ADD NEW KEYS ABOVE
@@ -360,3 +364,20 @@ void NvsPreferences::SaveRgbStripLedBrightness(uint8_t rgb_strip_led_brightness)
   preferences.end();
   PrintLn(__func__, rgb_strip_led_brightness);
 }
+
+std::string NvsPreferences::RetrieveTimezone() {
+  preferences.begin(kNvsDataKey, /*readOnly = */ true);
+  String kTimezoneString = preferences.getString(kTimezoneKey, kTimezone.c_str());
+  preferences.end();
+  std::string posix_tz = kTimezoneString.c_str();
+  PrintLn(__func__, posix_tz);
+  return posix_tz;
+}
+
+void NvsPreferences::SaveTimezone(std::string posix_tz) {
+  preferences.begin(kNvsDataKey, /*readOnly = */ false);
+  String kTimezoneString = posix_tz.c_str();
+  preferences.putString(kTimezoneKey, kTimezoneString);
+  preferences.end();
+  PrintLn(__func__, posix_tz);
+}
@@ -53,6 +53,8 @@ public:
   void SaveRgbStripLedCount(uint8_t rgb_strip_led_count);
   uint8_t RetrieveRgbStripLedBrightness();
   void SaveRgbStripLedBrightness(uint8_t rgb_strip_led_brightness);
+  std::string RetrieveTimezone();
+  void SaveTimezone(std::string posix_tz);
 
 private:
 
@@ -133,6 +135,9 @@ private:
   const char* kRgbStripLedBrightnessKey = "RgbLedBright";
   const uint8_t kRgbStripLedBrightness = 255;
 
+  const char* kTimezoneKey = "PosixTz";   // kPosixTzLengthMax bytes, POSIX TZ string with DST rules
+  const std::string kTimezone = "";       // none, GMT offset comes from weather location until a zone is set
+
 };
 
 #endif  // NVS_PREFERENCES_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef PAGE_LAYOUT_H
+#define PAGE_LAYOUT_H
+
+#include <stdint.h>
+#include "general_constants.h"
+
+// Settings page button geometry, no Arduino dependencies.
+// Fixed buttons have their rectangle at compile time. A row button sits right aligned in its row and is sized to its
+// value text, so the only runtime input is that text's bounds: the rectangle is worked out from them wherever it is
+// needed instead of being stored back into the page tables.
+struct ButtonRect {
+  int16_t x, y;
+  uint16_t w, h;
+
+  // touch hit, edges included
+  constexpr bool Contains(int16_t px, int16_t py) const { return px >= x && px <= x + w && py >= y && py <= y + h; }
+  // cursor highlight ring i pixels outside the button
+  constexpr ButtonRect Grown(int16_t i) const { return { (int16_t)(x - i), (int16_t)(y - i), (uint16_t)(w + 2 * i), (uint16_t)(h + 2 * i) }; }
+};
+
+namespace PageLayout {
+
+  // fixed buttons
+  constexpr ButtonRect kNoButton = { 0, 0, 0, 0 };
+  constexpr ButtonRect kSaveButton = { kSaveButtonX1, kSaveButtonY1, kSaveButtonW, kSaveButtonH };
+  constexpr ButtonRect kBackButton = { kBackButtonX1, kBackButtonY1, kBackButtonW, kBackButtonH };
+  constexpr ButtonRect kRescanButton = { kRescanButtonX1, kRescanButtonY1, kRescanButtonW, kRescanButtonH };
+  constexpr ButtonRect kNextButton = { kNextButtonX1, kNextButtonY1, kNextButtonW, kNextButtonH };
+  constexpr ButtonRect kSettingsGear = { kSettingsGearX1, kSettingsGearY1, kSettingsGearWidth, kSettingsGearHeight };
+  constexpr ButtonRect kAlarmRow = { 1, kAlarmRowY1, kTftWidth - 2, kTftHeight - kAlarmRowY1 - 1 };
+
+  // text baseline of a page's button row
+  constexpr int16_t RowTextY0(int button_index) { return (button_index + 1) * kPageRowHeight + 20; }
+
+  // row button from the bounds of its value text in the button font, a label only value has no face and sits
+  // further right
+  constexpr ButtonRect RowButton(int button_index, uint16_t text_w, uint16_t text_h, bool label_only) {
+    return { (int16_t)(kTftWidth - text_w - 3 * kDisplayTextGap + (label_only ? 2 * kDisplayTextGap : 0)),
+             (int16_t)(RowTextY0(button_index) - text_h - kDisplayTextGap),
+             (uint16_t)(text_w + 2 * kDisplayTextGap), (uint16_t)(text_h + 2 * kDisplayTextGap) };
+  }
+
+} // namespace PageLayout
+
+#endif // PAGE_LAYOUT_H
@@ -0,0 +1,107 @@
+#include "palette_canvas4.h"
+
+PaletteCanvas4::PaletteCanvas4(uint16_t w, uint16_t h, uint8_t* buffer, size_t buffer_bytes) : Adafruit_GFX(w, h) {
+  row_bytes_ = (w + 1) / 2;
+  band_rows_ = min(buffer_bytes / row_bytes_, (size_t)h);
+  buffer_ = buffer;
+  band_h_ = band_rows_;
+  setTextWrap(false);
+}
+
+void PaletteCanvas4::SetBand(int16_t band_y0, int16_t band_h) {
+  band_y0_ = band_y0;
+  band_h_ = min((uint16_t)band_h, band_rows_);
+}
+
+uint32_t PaletteCanvas4::ColorDistance(uint16_t a, uint16_t b) {
+  int32_t dr = 2 * (int32_t)((a >> 11) - (b >> 11));
+  int32_t dg = (int32_t)((a >> 5) & 0x3F) - (int32_t)((b >> 5) & 0x3F);
+  int32_t db = 2 * (int32_t)((a & 0x1F) - (b & 0x1F));
+  return 3 * dr * dr + 4 * dg * dg + 2 * db * db;
+}
+
+// palette entry of color, new colors are added while there is room and take the nearest entry after that
+uint8_t PaletteCanvas4::ColorIndex(uint16_t color) {
+  if(last_index_ != 0xFF && color == last_color_)
+    return last_index_;
+  uint8_t index = 0;
+  while(index < palette_size_ && palette_[index] != color)
+    index++;
+  if(index == palette_size_) {
+    if(palette_size_ < kPaletteSize)
+      palette_[palette_size_++] = color;
+    else {
+      unfit_lookups_++;
+      uint32_t best = UINT32_MAX;
+      for (uint8_t i = 0; i < kPaletteSize; i++) {
+        uint32_t distance = ColorDistance(color, palette_[i]);
+        if(distance < best) {
+          best = distance;
+          index = i;
+        }
+      }
+    }
+  }
+  last_color_ = color;
+  last_index_ = index;
+  return index;
+}
+
+void PaletteCanvas4::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  y -= band_y0_;
+  if(x < 0 || x >= _width || y < 0 || y >= band_h_)
+    return;
+  uint8_t* p = buffer_ + y * row_bytes_ + (x >> 1);
+  uint8_t index = ColorIndex(color);
+  if(x & 1)
+    *p = (*p & 0xF0) | index;
+  else
+    *p = (*p & 0x0F) | (index << 4);
+}
+
+void PaletteCanvas4::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  y -= band_y0_;
+  if(y < 0 || y >= band_h_ || w <= 0)
+    return;
+  if(x < 0) {
+    w += x;
+    x = 0;
+  }
+  if(x + w > _width)
+    w = _width - x;
+  if(w <= 0)
+    return;
+  uint8_t index = ColorIndex(color);
+  uint8_t* p = buffer_ + y * row_bytes_ + (x >> 1);
+  // odd leading pixel, whole bytes, odd trailing pixel
+  if(x & 1) {
+    *p = (*p & 0xF0) | index;
+    p++;
+    w--;
+  }
+  memset(p, (index << 4) | index, w >> 1);
+  if(w & 1) {
+    p += w >> 1;
+    *p = (*p & 0x0F) | (index << 4);
+  }
+}
+
+void PaletteCanvas4::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t j = 0; j < h; j++)
+    drawFastHLine(x, y + j, w, color);
+}
+
+void PaletteCanvas4::fillScreen(uint16_t color) {
+  uint8_t index = ColorIndex(color);
+  memset(buffer_, (index << 4) | index, row_bytes_ * band_h_);
+}
+
+void PaletteCanvas4::ExpandRow(int16_t j, uint16_t* buffer16Bit) {
+  const uint8_t* p = buffer_ + j * row_bytes_;
+  for (int16_t i = 0; i < _width; i += 2) {
+    uint8_t b = *p++;
+    buffer16Bit[i] = palette_[b >> 4];
+    if(i + 1 < _width)
+      buffer16Bit[i + 1] = palette_[b & 0x0F];
+  }
+}
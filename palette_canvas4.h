@@ -0,0 +1,48 @@
+#ifndef PALETTE_CANVAS4_H
+#define PALETTE_CANVAS4_H
+
+#include <Adafruit_GFX.h>
+
+// 4 bit per pixel canvas with a 16 color palette for composing multi color pages off screen, needs only Adafruit_GFX.
+// RGB565 colors drawn into it take the next free palette entry the first time they appear. Once all 16 are taken a
+// new color is drawn with the nearest palette entry instead and counted in unfit_lookups()
+// covers the full WIDTH x HEIGHT page, but only rows [band_y0, band_y0 + band_h) are stored, so a page can be
+// rendered and sent a band at a time
+// draws into a buffer owned by someone else, as many rows as fit in buffer_bytes make a band
+class PaletteCanvas4 : public Adafruit_GFX {
+public:
+  static const uint8_t kPaletteSize = 16;
+
+  PaletteCanvas4(uint16_t w, uint16_t h, uint8_t* buffer, size_t buffer_bytes);
+  void SetBand(int16_t band_y0, int16_t band_h);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  // expand pixels of band row j into RGB565 through the palette
+  void ExpandRow(int16_t j, uint16_t* buffer16Bit);
+  uint8_t* getBuffer() const { return buffer_; }
+  int16_t band_y0() const { return band_y0_; }
+  int16_t band_h() const { return band_h_; }
+  uint8_t palette_size() const { return palette_size_; }
+  // lookups of a color that had no palette entry of its own and took the nearest one, 0 unless the page used more
+  // than kPaletteSize colors
+  unsigned long unfit_lookups() const { return unfit_lookups_; }
+
+  // distance between two RGB565 colors, channels on the 6 bit green scale and weighted for how the eye sees them
+  static uint32_t ColorDistance(uint16_t a, uint16_t b);
+
+private:
+  uint8_t ColorIndex(uint16_t color);
+
+  uint8_t* buffer_ = NULL;     // band_rows of WIDTH / 2 bytes, high nibble is left pixel
+  uint16_t row_bytes_ = 0, band_rows_ = 0;
+  int16_t band_y0_ = 0, band_h_ = 0;
+  uint16_t palette_[kPaletteSize] = {};
+  uint8_t palette_size_ = 0;
+  uint16_t last_color_ = 0;
+  uint8_t last_index_ = 0xFF;
+  unsigned long unfit_lookups_ = 0;
+};
+
+#endif // PALETTE_CANVAS4_H
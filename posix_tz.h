@@ -0,0 +1,216 @@
+#ifndef POSIX_TZ_H
+#define POSIX_TZ_H
+
+#include <stdint.h>
+#include "time_math.h"
+
+// POSIX TZ rule engine, no Arduino dependencies.
+// Takes a POSIX TZ string like "PST8PDT,M3.2.0,M11.1.0" or "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0" (the format
+// of the last line of /usr/share/zoneinfo files and of https://github.com/nayarsystems/posix_tz_db) and gives the
+// UTC offset at any instant plus the next instant the offset changes, so the clock can keep local time on its own.
+// Offsets here are seconds east of UTC (local = utc + offset), POSIX strings write them west of UTC.
+class PosixTz {
+public:
+  static const int32_t kSecondsPerHour = 3600;
+
+  // false if tz is malformed, the engine then stays at UTC with no DST
+  bool Parse(const char* tz) {
+    if(tz != nullptr && ParseFields(tz)) {
+      valid_ = true;
+      return true;
+    }
+    *this = PosixTz();
+    return false;
+  }
+
+  bool valid() const { return valid_; }
+  bool has_dst() const { return has_dst_; }
+  int32_t std_offset() const { return std_offset_; }
+  int32_t dst_offset() const { return dst_offset_; }
+
+  // seconds east of UTC in effect at utc
+  int32_t OffsetAt(int64_t utc) const {
+    if(!has_dst_)
+      return std_offset_;
+    int32_t year = LocalYear(utc);
+    int64_t start = StartUtc(year), end = EndUtc(year);
+    bool dst = (start < end ? (utc >= start && utc < end) : !(utc >= end && utc < start));
+    return (dst ? dst_offset_ : std_offset_);
+  }
+
+  // first UTC second after utc at which the offset changes and the offset from then on, false when there is no DST
+  bool NextTransition(int64_t utc, int64_t* transition_utc, int32_t* offset_after) const {
+    if(!has_dst_)
+      return false;
+    int32_t year = LocalYear(utc);
+    int64_t next = INT64_MAX;
+    for(int32_t y = year; y <= year + 1; y++) {
+      int64_t start = StartUtc(y), end = EndUtc(y);
+      if(start > utc && start < next)
+        next = start;
+      if(end > utc && end < next)
+        next = end;
+    }
+    if(next == INT64_MAX)
+      return false;
+    *transition_utc = next;
+    *offset_after = OffsetAt(next);
+    return true;
+  }
+
+private:
+  // transition date: 'J' Jn (1 - 365, 29 Feb never counted), 'N' n (0 - 365), 'M' Mm.w.d (week 5 = last)
+  struct Rule {
+    char type = 'M';
+    uint16_t day = 0;
+    uint8_t month = 1, week = 1, weekday = 0;
+    int32_t time = 2 * kSecondsPerHour;   // local wall clock seconds, may be negative or past 24 h
+  };
+
+  // std and dst names, offsets and rules, valid_ left to Parse
+  bool ParseFields(const char* p) {
+    has_dst_ = false;
+    int32_t west;
+    if(!ParseName(p) || !ParseOffset(p, &west))
+      return false;
+    std_offset_ = -west;
+    dst_offset_ = std_offset_;
+    if(*p != '\0') {
+      if(!ParseName(p))
+        return false;
+      dst_offset_ = std_offset_ + kSecondsPerHour;
+      if(*p != '\0' && *p != ',') {
+        if(!ParseOffset(p, &west))
+          return false;
+        dst_offset_ = -west;
+      }
+      // no rules given: current US rules, as glibc does without a posixrules file
+      const char* rules = (*p == ',' ? p : ",M3.2.0,M11.1.0");
+      if(*rules++ != ',' || !ParseRule(rules, &start_) || *rules++ != ',' || !ParseRule(rules, &end_) || *rules != '\0')
+        return false;
+      has_dst_ = true;
+    }
+    return true;
+  }
+
+  static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+  static bool IsAlpha(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+
+  static bool ParseName(const char* &p) {
+    const char* start = p;
+    if(*p == '<') {
+      while(*p != '\0' && *p != '>')
+        p++;
+      if(*p++ != '>')
+        return false;
+      return p - start >= 5;    // < + 3 chars + >
+    }
+    while(IsAlpha(*p))
+      p++;
+    return p - start >= 3;
+  }
+
+  static bool ParseNumber(const char* &p, int32_t max, int32_t* value) {
+    if(!IsDigit(*p))
+      return false;
+    int32_t n = 0;
+    while(IsDigit(*p)) {
+      n = n * 10 + (*p++ - '0');
+      if(n > max)
+        return false;
+    }
+    *value = n;
+    return true;
+  }
+
+  // [+|-]hh[:mm[:ss]] to seconds
+  static bool ParseOffset(const char* &p, int32_t* seconds) {
+    int32_t sign = 1;
+    if(*p == '+' || *p == '-')
+      sign = (*p++ == '-' ? -1 : 1);
+    int32_t h, m = 0, s = 0;
+    if(!ParseNumber(p, 167, &h))
+      return false;
+    if(*p == ':') {
+      p++;
+      if(!ParseNumber(p, 59, &m))
+        return false;
+      if(*p == ':') {
+        p++;
+        if(!ParseNumber(p, 59, &s))
+          return false;
+      }
+    }
+    *seconds = sign * (h * kSecondsPerHour + m * 60 + s);
+    return true;
+  }
+
+  static bool ParseRule(const char* &p, Rule* rule) {
+    int32_t a, b, c;
+    *rule = Rule();
+    if(*p == 'J') {
+      p++;
+      if(!ParseNumber(p, 365, &a) || a < 1)
+        return false;
+      rule->type = 'J';
+      rule->day = a;
+    }
+    else if(*p == 'M') {
+      p++;
+      if(!ParseNumber(p, 12, &a) || a < 1 || *p++ != '.' || !ParseNumber(p, 5, &b) || b < 1 || *p++ != '.' || !ParseNumber(p, 6, &c))
+        return false;
+      rule->month = a;
+      rule->week = b;
+      rule->weekday = c;
+    }
+    else {
+      if(!ParseNumber(p, 365, &a))
+        return false;
+      rule->type = 'N';
+      rule->day = a;
+    }
+    if(*p == '/') {
+      p++;
+      if(!ParseOffset(p, &a))
+        return false;
+      rule->time = a;
+    }
+    return true;
+  }
+
+  // days since 1 Jan 1970 of the rule date in year
+  static int32_t RuleDay(const Rule& rule, int32_t year) {
+    int32_t jan_1 = TimeMath::DaysFromCivil(year, 1, 1);
+    if(rule.type == 'N')
+      return jan_1 + rule.day;
+    if(rule.type == 'J') {
+      bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+      return jan_1 + rule.day - 1 + (leap && rule.day >= 60 ? 1 : 0);
+    }
+    int32_t first = TimeMath::DaysFromCivil(year, rule.month, 1);
+    int32_t next_month = (rule.month == 12 ? TimeMath::DaysFromCivil(year + 1, 1, 1) : TimeMath::DaysFromCivil(year, rule.month + 1, 1));
+    int32_t day = first + (rule.weekday - TimeMath::WeekdayFromDays(first) + 7) % 7 + (rule.week - 1) * 7;
+    while(day >= next_month)
+      day -= 7;
+    return day;
+  }
+
+  // DST starts at a standard time wall clock reading and ends at a DST wall clock reading
+  int64_t StartUtc(int32_t year) const { return (int64_t)RuleDay(start_, year) * TimeMath::kSecondsPerDay + start_.time - std_offset_; }
+  int64_t EndUtc(int32_t year) const { return (int64_t)RuleDay(end_, year) * TimeMath::kSecondsPerDay + end_.time - dst_offset_; }
+
+  int32_t LocalYear(int64_t utc) const {
+    int64_t local = utc + std_offset_;
+    int64_t days = local / TimeMath::kSecondsPerDay - (local % TimeMath::kSecondsPerDay < 0 ? 1 : 0);
+    int32_t year;
+    uint8_t month, day;
+    TimeMath::CivilFromDays(days, year, month, day);
+    return year;
+  }
+
+  bool valid_ = false, has_dst_ = false;
+  int32_t std_offset_ = 0, dst_offset_ = 0;
+  Rule start_, end_;
+};
+
+#endif  // POSIX_TZ_H
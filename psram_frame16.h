@@ -0,0 +1,87 @@
+#ifndef PSRAM_FRAME16_H
+#define PSRAM_FRAME16_H
+
+#include <Adafruit_GFX.h>
+
+// Full screen RGB565 frame that remembers the bounding box of everything drawn since the last flush, needs only
+// Adafruit_GFX. On the board the buffer is in PSRAM, the host tests give it plain memory.
+// unrotated, same size as the panel in its landscape rotation
+class PsramFrame16 : public GFXcanvas16 {
+public:
+  // draws into buffer of w * h pixels owned by the caller
+  PsramFrame16(uint16_t w, uint16_t h, uint16_t* frame_buffer) : GFXcanvas16(w, h, false) {
+    buffer = frame_buffer;
+    ClearDirty();
+  }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    GFXcanvas16::drawPixel(x, y, color);
+    MarkDirty(x, y, 1, 1);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    GFXcanvas16::drawFastHLine(x, y, w, color);
+    MarkDirty(x, y, w, 1);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    GFXcanvas16::drawFastVLine(x, y, h, color);
+    MarkDirty(x, y, 1, h);
+  }
+  void fillScreen(uint16_t color) override {
+    GFXcanvas16::fillScreen(color);
+    MarkDirty(0, 0, WIDTH, HEIGHT);
+  }
+  bool dirty() const { return dirty_x0_ <= dirty_x1_; }
+  void DirtyRect(int16_t* x, int16_t* y, int16_t* w, int16_t* h) const {
+    *x = dirty_x0_; *y = dirty_y0_; *w = dirty_x1_ - dirty_x0_ + 1; *h = dirty_y1_ - dirty_y0_ + 1;
+  }
+  void ClearDirty() {
+    dirty_x0_ = dirty_y0_ = INT16_MAX;
+    dirty_x1_ = dirty_y1_ = -1;
+  }
+
+  // send the dirty rectangle to panel and clear it, false if nothing was drawn since the last flush
+  // panel is an Adafruit_SPITFT or anything else with its startWrite, setAddrWindow, writePixels and endWrite
+  template <class Panel>
+  bool Flush(Panel& panel) {
+    if(!dirty())
+      return false;
+    int16_t x, y, w, h;
+    DirtyRect(&x, &y, &w, &h);
+    panel.startWrite();
+    panel.setAddrWindow(x, y, w, h);
+    if(w == WIDTH)
+      // full width rows are contiguous in the frame
+      panel.writePixels(buffer + y * WIDTH, (uint32_t)w * h);
+    else
+      for (int16_t j = y; j < y + h; j++)
+        panel.writePixels(buffer + j * WIDTH + x, w);
+    panel.endWrite();
+    ClearDirty();
+    return true;
+  }
+
+private:
+  void MarkDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    // GFXcanvas16 draws negative widths and heights left of and above x, y
+    if(w < 0) {
+      w = -w;
+      x -= w - 1;
+    }
+    if(h < 0) {
+      h = -h;
+      y -= h - 1;
+    }
+    int16_t x1 = min((int)x + w - 1, WIDTH - 1), y1 = min((int)y + h - 1, HEIGHT - 1);
+    x = max(x, (int16_t)0);
+    y = max(y, (int16_t)0);
+    if(x > x1 || y > y1)
+      return;
+    dirty_x0_ = min(dirty_x0_, x);
+    dirty_y0_ = min(dirty_y0_, y);
+    dirty_x1_ = max(dirty_x1_, x1);
+    dirty_y1_ = max(dirty_y1_, y1);
+  }
+
+  int16_t dirty_x0_, dirty_y0_, dirty_x1_, dirty_y1_;
+};
+
+#endif // PSRAM_FRAME16_H
@@ -0,0 +1,120 @@
+#ifndef RENDER_PROFILER_H
+#define RENDER_PROFILER_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Render time histograms, no Arduino dependencies.
+// Buckets are 4 per power of two of microseconds (about 19% wide), 0 - 3 us get a bucket each and everything from
+// about 2 s up lands in the last bucket. When a bucket is about to pass 0xFFFF every bucket is halved (rounding up,
+// so rare slow renders stay in the tail), the percentiles then lean towards recent frames but stay consistent.
+class RenderHistogram {
+public:
+  static const uint8_t kSubBuckets = 4;
+  static const uint8_t kBuckets = 84;
+
+  void Add(uint32_t us) {
+    uint8_t i = BucketIndex(us);
+    if(counts_[i] == 0xFFFF)
+      Halve();
+    counts_[i]++;
+    bucketed_++;
+    if(count_ != 0xFFFFFFFF)
+      count_++;
+    if(us > max_us_)
+      max_us_ = us;
+  }
+
+  // upper edge of the bucket holding the pct-th percentile sample, never above the real max
+  uint32_t Percentile(uint8_t pct) const {
+    if(bucketed_ == 0)
+      return 0;
+    uint32_t rank = ((uint64_t)bucketed_ * pct + 99) / 100, seen = 0;
+    if(rank == 0)
+      rank = 1;
+    for(uint8_t i = 0; i < kBuckets; i++) {
+      seen += counts_[i];
+      if(seen >= rank)
+        return (BucketUpperUs(i) < max_us_ ? BucketUpperUs(i) : max_us_);
+    }
+    return max_us_;
+  }
+
+  // samples added since Clear, including the ones halving has thinned out
+  uint32_t count() const { return count_; }
+  uint32_t max_us() const { return max_us_; }
+  uint16_t bucket_count(uint8_t i) const { return counts_[i]; }
+  void Clear() {
+    memset(counts_, 0, sizeof(counts_));
+    bucketed_ = 0;
+    count_ = 0;
+    max_us_ = 0;
+  }
+
+  static uint8_t BucketIndex(uint32_t us) {
+    if(us < kSubBuckets)
+      return us;
+    uint8_t octave = 31 - __builtin_clz(us);
+    uint32_t i = (octave - 1) * kSubBuckets + ((us >> (octave - 2)) & (kSubBuckets - 1));
+    return (i < kBuckets ? i : kBuckets - 1);
+  }
+
+  static uint32_t BucketUpperUs(uint8_t i) {
+    if(i < kSubBuckets)
+      return i;
+    if(i == kBuckets - 1)
+      return 0xFFFFFFFF;
+    uint8_t shift = i / kSubBuckets - 1;
+    return ((uint32_t)(kSubBuckets + i % kSubBuckets + 1) << shift) - 1;
+  }
+
+private:
+  // percentile ranks come from bucketed_, always the sum of counts_
+  void Halve() {
+    bucketed_ = 0;
+    for(uint8_t i = 0; i < kBuckets; i++) {
+      counts_[i] = (counts_[i] + 1) / 2;
+      bucketed_ += counts_[i];
+    }
+  }
+
+  uint16_t counts_[kBuckets] = {};
+  uint32_t bucketed_ = 0;
+  uint32_t count_ = 0;
+  uint32_t max_us_ = 0;
+};
+
+// screens and draw steps that get a histogram
+enum RenderSection {
+  kRenderTimeUpdate,
+  kRenderScreensaverCanvas,
+  kRenderScreensaverBlit,
+  kRenderCurrentPage,
+  kRenderAlarmSetScreen,
+  kRenderAlarmTriggeredScreen,
+  kRenderKeyboard,
+  kRenderSectionCount
+};
+
+class RenderProfiler {
+public:
+  void Add(RenderSection section, uint32_t us) { histograms_[section].Add(us); }
+  const RenderHistogram& histogram(RenderSection section) const { return histograms_[section]; }
+  void Clear() {
+    for(uint8_t i = 0; i < kRenderSectionCount; i++)
+      histograms_[i].Clear();
+  }
+
+  static const char* SectionName(RenderSection section) {
+    static const char* const kNames[kRenderSectionCount] = {
+      "DisplayTimeUpdate", "Screensaver canvas", "Screensaver blit", "DisplayCurrentPage",
+      "SetAlarmScreen", "AlarmTriggeredScreen", "MakeKeyboard"
+    };
+    return kNames[section];
+  }
+
+private:
+  RenderHistogram histograms_[kRenderSectionCount];
+};
+
+#endif  // RENDER_PROFILER_H
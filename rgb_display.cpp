@@ -3,13 +3,24 @@
 #include "alarm_clock.h"
 #include "rtc.h"
 #include "nvs_preferences.h"
+#if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+  #include "driver/ledc.h"    // ledc_fade_stop
+#endif
 
 void RGBDisplay::Setup() {
 
   /* INITIALIZE DISPLAYS */
 
-  // tft display backlight control PWM output pin
-  pinMode(TFT_BL, OUTPUT);
+  // tft display backlight control PWM output pin, on LEDC for hardware fades
+  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+  // Code for version 3.x
+    // fixed channel so a running fade can be stopped through the IDF LEDC driver
+    ledcAttachChannel(TFT_BL, kBacklightPwmFreq, BacklightFader::kDutyBits, kBacklightLedcChannel);
+  #else
+  // Code for version 2.x
+    ledcSetup(kBacklightLedcChannel, kBacklightPwmFreq, BacklightFader::kDutyBits);
+    ledcAttachPin(TFT_BL, kBacklightLedcChannel);
+  #endif
 
 #if defined(DISPLAY_IS_ST7789V)
 
@@ -69,12 +80,33 @@ void RGBDisplay::Setup() {
   tft.fillScreen(kDisplayColorBlack);
   tft.setTextWrap(false);
 
+  // pre-rasterize big clock digits, without an atlas they are printed glyph by glyph
+  if(!main_time_atlas_.Build(&FreeSansBold48pt7b))
+    PrintLn("GlyphAtlas allocation failed: ", "main time");
+  if(!screensaver_time_atlas_.Build(&ComingSoon_Regular70pt7b))
+    PrintLn("GlyphAtlas allocation failed: ", "screensaver time");
+  #ifdef MORE_LOGS
+  PrintLn("GlyphAtlas built, bytes: ", (int)(main_time_atlas_.bytes() + screensaver_time_atlas_.bytes()));
+  #endif
+
+  #ifdef PSRAM_FRAMEBUFFER
+  // settings page frame, falls back to the palette canvas if PSRAM is not there
+  if(psramFound()) {
+    uint16_t* frame_buffer = (uint16_t*)ps_malloc((size_t)kTftWidth * kTftHeight * sizeof(uint16_t));
+    if(frame_buffer != NULL)
+      frame_ = new PsramFrame16(kTftWidth, kTftHeight, frame_buffer);
+  }
+  PrintLn("PSRAM frame: ", (frame_ != NULL ? (int)(kTftWidth * kTftHeight * sizeof(uint16_t)) : 0));
+  #endif
+
   // update TFT display
   DisplayTimeUpdate();
 
   // fetch night time dim hour
   night_time_minutes = nvs_preferences->RetrieveNightTimeDimHour() * 60 + 720;
   #ifdef MORE_LOGS
+  // canvas arena is part of the display object, MinRAM here already accounts for it
+  PrintLn("Canvas arena bytes: ", (int)kCanvasArenaBytes);
   PrintLn("night_time_minutes", night_time_minutes);
   PrintLn("use_photoresistor", use_photoresistor);
   #endif
@@ -82,8 +114,22 @@ void RGBDisplay::Setup() {
   if(use_photoresistor) {
     // configure Photoresistor pin
     pinMode(PHOTORESISTOR_PIN, INPUT);
+    AdcLock::Take();
     analogReadResolution(kAdcResolutionBits);
 
+    // seed the filter with one reading, then sample in the background
+    ambient_light_filter_.Reset(analogRead(PHOTORESISTOR_PIN));
+    AdcLock::Give();
+    ambient_snapshot_.store(ambient_light_filter_.Snapshot(), std::memory_order_relaxed);
+    esp_timer_create_args_t ambient_timer_args = {};
+    ambient_timer_args.callback = &AmbientLightSampleCallback;
+    ambient_timer_args.arg = this;
+    ambient_timer_args.name = "ambient_light";
+    if(esp_timer_create(&ambient_timer_args, &ambient_light_timer_) == ESP_OK)
+      esp_timer_start_periodic(ambient_light_timer_, kAmbientLightSamplePeriodUs);
+    else
+      PrintLn("Ambient light timer not created!");
+
     // set display brightness
     CheckPhotoresistorAndSetBrightness();
   }
@@ -100,13 +146,17 @@ void RGBDisplay::RotateScreen() {
   else
     screen_orientation_ = 1;
   nvs_preferences->SaveScreenOrientation(screen_orientation_);
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  StopHwScroll();
+  #endif
   tft.setRotation(screen_orientation_);
 }
 
-// set display brightness function
-void RGBDisplay::SetBrightness(int brightness) {
+// set display brightness function, fades there over fade_ms
+void RGBDisplay::SetBrightness(int brightness, uint16_t fade_ms) {
   if(current_brightness_ != brightness) {
-    analogWrite(TFT_BL, brightness);
+    backlight_fader_.Start(brightness, fade_ms, millis());
+    UpdateBacklight();
     #ifdef MORE_LOGS
     if(debug_mode)
       PrintLn("Display Brightness set to ", brightness);
@@ -128,11 +178,65 @@ void RGBDisplay::SetBrightness(int brightness) {
 
 void RGBDisplay::SetMaxBrightness() {
   if(current_brightness_ != kMaxBrightness)
-    SetBrightness(kMaxBrightness);
+    SetBrightness(kMaxBrightness, kWakeFadeMs);
+}
+
+// hand due fade segments to the LEDC, called from loop
+void RGBDisplay::UpdateBacklight() {
+  uint16_t start_duty, end_duty, segment_ms;
+  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+  // Code for version 3.x
+    // each segment is a hardware ramp, the CPU only starts it
+    // ledcFade waits for a running ramp to end, so a new target would stall loop: where the LEDC can stop a fade the
+    // running ramp is stopped, elsewhere the next segment waits until the ramp is over
+    while(true) {
+      bool ramp_running = backlight_fader_.RampRunning(millis());
+      #if !SOC_LEDC_SUPPORT_FADE_STOP
+      if(ramp_running)
+        break;
+      #endif
+      if(!backlight_fader_.NextSegment(millis(), &start_duty, &end_duty, &segment_ms))
+        break;
+      #if SOC_LEDC_SUPPORT_FADE_STOP
+      if(ramp_running)
+        ledc_fade_stop((ledc_mode_t)(kBacklightLedcChannel / SOC_LEDC_CHANNEL_NUM), (ledc_channel_t)(kBacklightLedcChannel % SOC_LEDC_CHANNEL_NUM));
+      #endif
+      if(segment_ms == 0)
+        ledcWrite(TFT_BL, end_duty);
+      else
+        ledcFade(TFT_BL, start_duty, end_duty, segment_ms);
+      backlight_fader_.RampStarted(millis(), segment_ms);
+      backlight_duty_ = end_duty;
+    }
+  #else
+  // Code for version 2.x
+    // no ledcFade, step along the planned curve every loop
+    while(backlight_fader_.NextSegment(millis(), &start_duty, &end_duty, &segment_ms)) {}
+    end_duty = backlight_fader_.CurrentDuty(millis());
+    if(end_duty != backlight_duty_) {
+      ledcWrite(kBacklightLedcChannel, end_duty);
+      backlight_duty_ = end_duty;
+    }
+  #endif
+}
+
+// runs in the esp_timer task, only this writes the filter and the snapshot
+// a sample the touchscreen holds the ADC for is skipped, the filter just waits for the next one
+void RGBDisplay::AmbientLightSampleCallback(void* arg) {
+  RGBDisplay* display = (RGBDisplay*)arg;
+  if(!AdcLock::TryTake()) {
+    display->ambient_samples_skipped_++;
+    return;
+  }
+  uint16_t raw = analogRead(PHOTORESISTOR_PIN);
+  AdcLock::Give();
+  display->ambient_light_filter_.Add(raw);
+  display->ambient_snapshot_.store(display->ambient_light_filter_.Snapshot(), std::memory_order_relaxed);
 }
 
 void RGBDisplay::CheckPhotoresistorAndSetBrightness() {
-  int photodiode_light_raw = analogRead(PHOTORESISTOR_PIN);
+  // filtered background reading, no ADC wait here
+  int photodiode_light_raw = AmbientLightFilter::SnapshotFiltered(AmbientLightSnapshot());
   // int lcd_brightness_val = max(photodiode_light_raw * kBrightnessInactiveMax / kPhotodiodeLightRawMax, 1);
   int lcd_brightness_val2 = max((int)map(photodiode_light_raw, 0.2 / 3.3 * kPhotodiodeLightRawMax, kPhotodiodeLightRawMax, kNightBrightness, kBrightnessInactiveMax), kNightBrightness);
   if(rgb_led_strip_on)
@@ -142,8 +246,13 @@ void RGBDisplay::CheckPhotoresistorAndSetBrightness() {
   #ifdef MORE_LOGS
   if(debug_mode)
     Serial.print("photodiode_light_raw"); Serial.print(photodiode_light_raw); Serial.print("lcd_brightness_val2"); Serial.println(lcd_brightness_val2);
+  if(debug_mode) {
+    Serial.print("ambient samples skipped while touch read the ADC "); Serial.println(ambient_samples_skipped_.load(std::memory_order_relaxed));
+  }
   #endif
-  SetBrightness(lcd_brightness_val2);
+  // ignore small and too frequent photoresistor changes
+  if(backlight_fader_.AcceptAmbientLevel(lcd_brightness_val2, millis()))
+    SetBrightness(lcd_brightness_val2, kAmbientFadeMs);
 }
 
 void RGBDisplay::CheckTimeAndSetBrightness() {
@@ -151,32 +260,83 @@ void RGBDisplay::CheckTimeAndSetBrightness() {
   if(rtc->year() < 2024) {
     // RTC Time is not set!
     // Keep screen on day brightness
-    SetBrightness(kDayBrightness);
+    SetBrightness(kDayBrightness, kAmbientFadeMs);
   }
   else {
     if(rtc->todays_minutes >= night_time_minutes)
-      SetBrightness(kNightBrightness);
+      SetBrightness(kNightBrightness, kAmbientFadeMs);
     else if(rtc->todays_minutes >= kEveningTimeMinutes)
-      SetBrightness(kEveningBrightness);
+      SetBrightness(kEveningBrightness, kAmbientFadeMs);
     else if(rtc->todays_minutes >= kDayTimeMinutes)
-      SetBrightness(kDayBrightness);
+      SetBrightness(kDayBrightness, kAmbientFadeMs);
     else
-      SetBrightness(kNightBrightness);
+      SetBrightness(kNightBrightness, kAmbientFadeMs);
   }
 }
 
 void RGBDisplay::ScreensaverControl(bool turnOn) {
   if(!turnOn && my_canvas_ != NULL) {
-    // delete screensaverCanvas;
-    delete my_canvas_;
-    my_canvas_ = NULL;
+    // return screensaver canvas to arena
+    ReturnCanvas();
   }
   else
     refresh_screensaver_canvas_ = true;
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  // other pages are drawn unscrolled
+  StopHwScroll();
+  #endif
   // clear screen
   tft.fillScreen(kDisplayColorBlack);
+  screensaver_paste_.PanelCleared();
   screensaver_x1_ = 0;
   screensaver_y1_ = 20;
+  screensaver_on_screen_ = false;
+  screensaver_last_frame_ms_ = millis();
+  screensaver_step_.Reset();
   redraw_display_ = true;
   PrepareTimeDayDateArrays();
 }
+
+#ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+
+// +1 if screen x increases with panel gate line (scroll direction), -1 if it decreases
+int8_t RGBDisplay::HwScrollDirection() {
+#if defined(DISPLAY_IS_ST7789V)
+  return HwScroll::Direction(HwScroll::Madctl(true, tft.getRotation()));
+#else
+  return HwScroll::Direction(HwScroll::Madctl(false, tft.getRotation()));
+#endif
+}
+
+// set controller vertical scroll start address, whole panel is the scroll area
+void RGBDisplay::SetHwScroll(uint16_t offset) {
+  if(!hw_scroll_active_) {
+    // VSCRDEF: no top or bottom fixed area, all kTftWidth gate lines scroll
+    uint8_t vscrdef[6] = { 0, 0, (uint8_t)(kTftWidth >> 8), (uint8_t)(kTftWidth & 0xFF), 0, 0 };
+    tft.sendCommand(kVscrdefCmd, vscrdef, 6);
+    hw_scroll_active_ = true;
+  }
+  else if(offset == hw_scroll_offset_)
+    return;
+  uint8_t vscrsadd[2] = { (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF) };
+  tft.sendCommand(kVscrsaddCmd, vscrsadd, 2);
+  hw_scroll_offset_ = offset;
+}
+
+// put scroll offset back to 0 and clear screen as memory no longer matches the screen
+void RGBDisplay::StopHwScroll() {
+  if(!hw_scroll_active_)
+    return;
+  SetHwScroll(0);
+  hw_scroll_active_ = false;
+  tft.fillScreen(kDisplayBackroundColor);
+  screensaver_paste_.PanelCleared();
+  screensaver_on_screen_ = false;
+}
+
+#endif
+
+void RGBDisplay::TextBounds(const GFXfont* font, const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h, int16_t* x_advance) {
+  text_layout_cache_.TextBounds(tft, font, str, x, y, x1, y1, w, h, x_advance);
+}
+
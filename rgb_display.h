@@ -2,6 +2,20 @@
 #define RGB_DISPLAY_H
 
 #include "common.h"
+#include "backlight_fader.h"
+#include "ambient_light_filter.h"
+#include "adc_lock.h"
+#include "render_profiler.h"
+#include "two_color_blit.h"
+#include "time_row_layout.h"
+#include "gfx_canvases.h"
+#include "screensaver_motion.h"
+#include "text_layout_cache.h"
+#include "palette_canvas4.h"
+#include "psram_frame16.h"
+#include "draw_list.h"
+#include "hw_scroll.h"
+#include "sun_drawing.h"
 #include <Adafruit_GFX.h>     // Core graphics library
 #if defined(DISPLAY_IS_ST7789V)
   #include <Adafruit_ST7789.h> // Hardware-specific library for ST7789
@@ -17,8 +31,8 @@
 #include "Fonts/ComingSoon_Regular70pt7b_numbers_only.h"   // from https://fonts.google.com/ and converted using https://rop.nl/truetype2gfx/ and reduced in size
 #include "Fonts/FreeSansBold48pt7b_numbers_only.h"         // from https://rop.nl/truetype2gfx/ and reduced in size
 #include "Fonts/Satisfy_Regular24pt7b.h"     // from https://fonts.google.com/ and converted using https://rop.nl/truetype2gfx/
-#include "Fonts/FreeSansBold24pt7b.h"       // from Adafruit_GFX library
-#include "Fonts/FreeSans24pt7b.h"           // from Adafruit_GFX library
+#include "Fonts/FreeSansBold24pt7b_good_morning_only.h"   // from Adafruit_GFX library and reduced in size
+#include "Fonts/FreeSans24pt7b_numbers_only.h"           // from Adafruit_GFX library and reduced in size
 #include "Fonts/FreeSans18pt7b.h"           // from Adafruit_GFX library
 #include "Fonts/Satisfy_Regular18pt7b.h"     // from https://fonts.google.com/ and converted using https://rop.nl/truetype2gfx/
 #include "Fonts/FreeSansBold12pt7b.h"       // from Adafruit_GFX library
@@ -26,6 +40,18 @@
 #include "Fonts/FreeMonoBold9pt7b.h"        // from Adafruit_GFX library
 #include "Fonts/FreeMono9pt7b.h"            // from Adafruit_GFX library
 #include <SPI.h>
+#include <climits>
+#include <atomic>
+#include "esp_timer.h"
+
+#if defined(PSRAM_FRAMEBUFFER) && !defined(MCU_IS_ESP32_S3)
+  #error "PSRAM_FRAMEBUFFER needs the ESP32-S3 N16R8 PSRAM"
+#endif
+
+// controllers with vertical scroll (VSCRDEF / VSCRSADD) along the 320 px side
+#if defined(DISPLAY_IS_ST7789V) || defined(DISPLAY_IS_ILI9341)
+  #define DISPLAY_HAS_HW_VERTICAL_SCROLL
+#endif
 #if defined(MCU_IS_ESP32)
   #include <pgmspace.h>
 #else
@@ -33,6 +59,23 @@
 #endif
 
 
+#ifdef RENDER_PROFILING
+// adds the micros() spent in its scope to a render profiler section
+class ScopedRenderTimer {
+public:
+  ScopedRenderTimer(RenderProfiler* profiler, RenderSection section) : profiler_(profiler), section_(section), start_us_(micros()) {}
+  ~ScopedRenderTimer() { profiler_->Add(section_, micros() - start_us_); }
+
+private:
+  RenderProfiler* profiler_;
+  RenderSection section_;
+  unsigned long start_us_;
+};
+  #define PROFILE_RENDER(section) ScopedRenderTimer render_timer(&render_profiler_, section)
+#else
+  #define PROFILE_RENDER(section)
+#endif
+
 class RGBDisplay {
 
 public:
@@ -57,9 +100,11 @@ public:
   void DisplayCurrentPage();
   void DisplayCurrentPageButtonRow(bool is_on);
   void DisplayCurrentPageButtonRow(int button_index, bool is_on);
-  void DisplayCurrentPageButtonRow(DisplayButton* button, int button_index, bool is_on);
-  void DisplayCursorHighlight(DisplayButton* button, bool highlight_On);
+  void DisplayCurrentPageButtonRow(const DisplayButton* button, int button_index, bool is_on);
+  void DisplayCursorHighlight(const DisplayButton* button, int button_index, bool highlight_On);
   void DisplayCursorHighlight(bool highlight_On);
+  void InvalidateRetainedPage();
+  void FlushFrame();
   Cursor CheckButtonTouch();
   void DisplayFirmwareVersionAndDate();
   void DisplayWiFiConnectionStatus();
@@ -67,8 +112,9 @@ public:
 
   // functions
   void Setup();
-  void SetBrightness(int brightness);
+  void SetBrightness(int brightness, uint16_t fade_ms = 0);
   void SetMaxBrightness();
+  void UpdateBacklight();
   void CheckPhotoresistorAndSetBrightness();
   void CheckTimeAndSetBrightness();
   void ScreensaverControl(bool turnOn);
@@ -110,6 +156,51 @@ public:
   const uint16_t kColorPickerWheel[kColorPickerWheelSize] = {0x6D9D, 0x867E, 0x897B, 0x065F, 0xF7BB, 0xDD0D, 0xF52C, 0x07FF, 0x46F9, 0xCC53, 0x67E0, 0x0653, 0x07E0, 0xAFE6, 0xF81F, 0xF897, 0xFE76, 0xFCCC, 0xFC60, 0xFBE0, 0xFA69, 0xFAF9, 0xFBBF, 0xB81F, 0x991D, 0xF840, 0xF800, 0xFB09, 0xFFFD, 0x7FE0, 0xFEE0, 0xFFE0, 0xBFE0};
   bool screensaver_bounce_not_fly_horizontally_ = true;
 
+  // main page time row: redraw only from the first changed character instead of the full row
+  bool time_row_dirty_regions_only_ = true;
+
+  // screensaver 1 px moves: send only changed pixels instead of the full canvas, not used while the colored edge is on
+  bool screensaver_motion_blit_ = true;
+  // screensaver frame scheduler: target fps by brightness band, loop idles between frames
+  uint8_t ScreensaverTargetFps();
+  unsigned long ScreensaverMsToNextFrame();
+  #ifdef MORE_LOGS
+  // screensaver frame interval range and idle time since last FPS print
+  unsigned long screensaver_frame_interval_min_ms_ = ULONG_MAX, screensaver_frame_interval_max_ms_ = 0, screensaver_idle_ms_ = 0;
+  #endif
+
+  // fly through screensaver: move the clock with the controller scroll offset instead of re-sending it
+  bool screensaver_hw_scroll_ = true;
+
+  // screensaver and time row canvases: print glyphs as row spans instead of per pixel
+  bool canvas_span_text_ = true;
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  void StopHwScroll();
+  #endif
+  #ifdef MORE_LOGS
+  // expand and transfer time of last two color bitmap blit
+  unsigned long fast_draw_expand_us_ = 0, fast_draw_transfer_us_ = 0;
+  // canvases that did not fit in the canvas arena and went to heap
+  int canvas_arena_misses_ = 0;
+  // bytes not sent by last screensaver motion blit compared to a full canvas blit
+  long motion_blit_saved_bytes_ = 0;
+  #endif
+
+  // text bounds through the layout cache, same arguments as getTextBounds plus the font to measure in
+  void TextBounds(const GFXfont* font, const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h, int16_t* x_advance = NULL);
+  TextLayoutCache text_layout_cache_;
+
+  #ifdef RENDER_PROFILING
+  // per screen draw time histograms, printed by serial 'R'
+  RenderProfiler render_profiler_;
+  #endif
+
+  // backlight fades: LEDC hardware ramps along a gamma curve, photoresistor levels through hysteresis
+  BacklightFader backlight_fader_;
+
+  // photoresistor raw and filtered reading, sampled in the background (see AmbientLightFilter::Snapshot)
+  uint32_t AmbientLightSnapshot() { return ambient_snapshot_.load(std::memory_order_relaxed); }
+
   // wifi networks scan page
   const int kWifiScanNetworksPageItems = 9;
   uint8_t current_wifi_networks_scan_page_no = 0;
@@ -119,13 +210,28 @@ private:
 
 // PRIVATE FUNCTIONS
 
+  static void AmbientLightSampleCallback(void* arg);
   void DrawSun(int16_t x0, int16_t y0, uint16_t edge, int &tone_note_index, unsigned long &next_tone_change_time);
   void DrawRays(int16_t &cx, int16_t &cy, int16_t &rr, int16_t &rl, int16_t &rw, uint8_t &rn, int16_t &degStart, uint16_t &color);
-  void DrawDenseCircle(int16_t &cx, int16_t &cy, int16_t r, uint16_t &color);
   void PickNewRandomColor();  // for screensaver
   void DrawButton(int16_t x, int16_t y, uint16_t w, uint16_t h, const char* label, uint16_t borderColor, uint16_t onFill, uint16_t offFill, bool isOn);
+  void DrawPageButtonFace(const DisplayButton* button, int button_index, bool is_on);
+  ButtonRect PageButtonRect(const DisplayButton* button, int button_index);
+  void DrawCurrentPage();
   void DrawTriangleButton(int16_t x, int16_t y, uint16_t w, uint16_t h, bool isUp, uint16_t borderColor, uint16_t fillColor);
-  void FastDrawTwoColorBitmapSpi(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg);
+  void FastDrawTwoColorBitmapSpi(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg, int16_t col0 = 0, int16_t col1 = INT16_MAX);
+  void DrawBitmapSpans(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+  void FastDrawTwoColorBitmapMotionSpi(int16_t x, int16_t y, int16_t prev_x, int16_t prev_y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg, int16_t col0 = 0, int16_t col1 = INT16_MAX);
+  bool TimeRowDirtyColumns(int16_t hh_x0, int16_t* x0, int16_t* x1);
+  void FastDrawPaletteCanvasSpi(PaletteCanvas4* canvas);
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  int8_t HwScrollDirection();
+  void SetHwScroll(uint16_t offset);
+  void HwScrollPaste();
+  void HwScrollColumns(int16_t col0, int16_t col1, int16_t y, bool erase);
+  #endif
+  GFXcanvas1* BorrowCanvas(uint16_t w, uint16_t h);
+  void ReturnCanvas();
   // keyboard functions
   void MakeKeyboard(const char type[][13], std::string label);
   void DrawKeyboardButton(int x, int y, int w, int h);
@@ -140,8 +246,17 @@ private:
   bool GetKeyboardPress_shift = false, GetKeyboardPress_lastShift = false, GetKeyboardPress_numpad = false, GetKeyboardPress_lastNumpad = false;
   bool kb_capitals_only = false, kb_numbers_only = false;
 
-  // current screen brightness
+  // current screen brightness (target of the backlight fade)
   int current_brightness_ = 0;
+  // LEDC duty last handed to the hardware
+  uint16_t backlight_duty_ = 0;
+
+  // photoresistor background sampling: esp_timer task feeds the filter, loop reads the packed snapshot
+  AmbientLightFilter ambient_light_filter_;
+  std::atomic<uint32_t> ambient_snapshot_{0};
+  // samples skipped while the touchscreen had the ADC, written by the esp_timer task only
+  std::atomic<uint32_t> ambient_samples_skipped_{0};
+  esp_timer_handle_t ambient_light_timer_ = NULL;
 
   // screensaver
   bool screensaver_move_down_ = true, screensaver_move_right_ = true;
@@ -152,6 +267,27 @@ private:
   int16_t tft_HHMM_x0_ = kTimeRowX0, tft_HHMM_y0_ = 2 * kTimeRowY0;
   uint16_t tft_HHMM_w_ = 0, tft_HHMM_h_ = 0;
   int16_t screensaver_x1_ = 0, screensaver_y1_ = 0;
+  // where screensaver canvas is on screen now, valid only if screensaver_on_screen_
+  int16_t screensaver_prev_x1_ = 0, screensaver_prev_y1_ = 0;
+  bool screensaver_on_screen_ = false;
+
+  // screensaver frame time and motion carried over to next frames
+  unsigned long screensaver_last_frame_ms_ = 0;
+  ScreensaverStep screensaver_step_;
+
+  // hardware scroll: controller scroll offset and panel memory column of fly through screensaver canvas
+  bool hw_scroll_active_ = false;
+  uint16_t hw_scroll_offset_ = 0;
+  int16_t hw_scroll_canvas_x_ = 0;
+  // canvas columns in panel memory now, row they are at and canvas height
+  int16_t hw_scroll_col0_ = 0, hw_scroll_col1_ = 0, hw_scroll_canvas_y_ = 0, hw_scroll_canvas_h_ = 0;
+  static const uint8_t kVscrdefCmd = 0x33, kVscrsaddCmd = 0x37;
+
+  // larger screensaver moves than this are sent as a full blit
+  const int16_t kMotionBlitMaxStep = 8;
+  // canvas was built with the colored edge border, its full blits leave a trail on the panel
+  bool screensaver_canvas_has_edge_ = false;
+  ScreensaverPaste screensaver_paste_;
   uint16_t screensaver_w_ = 0, screensaver_h_ = 0;
   int16_t tft_AmPm_x0_ = 0, tft_AmPm_y0_ = 0;
   int16_t tft_SS_x0_ = 0;
@@ -159,6 +295,46 @@ private:
   int16_t alarm_row_x0_ = 0;
   int16_t alarm_icon_x0_ = 0, alarm_icon_y0_ = 0;
 
+  // time row currently on screen was drawn from the correct time canvas, with HH:MM starting at time_row_hh_x0_
+  bool time_row_on_screen_ = false;
+  int16_t time_row_hh_x0_ = 0;
+  TimeRowLayout time_row_layout_ = TimeRowLayout(&FreeSansBold48pt7b, &FreeSans18pt7b);
+
+  // retained settings page: what each button row on screen was last drawn with
+  // rows drawn with the same value are not laid out again, an on / off change only redraws the button face
+  struct RetainedButtonRow {
+    bool drawn;
+    bool is_on;
+    std::string value;
+  };
+  ScreenPage retained_page_ = kNoPageSelected;
+  std::vector<RetainedButtonRow> retained_rows_;
+
+  // settings pages are drawn on page_gfx_: the panel, or the draw list while DisplayCurrentPage lays a page out once
+  // to replay it band by band onto the palette canvas in the canvas arena
+  Adafruit_GFX* page_gfx_ = &tft;
+  DrawList page_draw_list_ = DrawList(kTftWidth, kTftHeight);
+  #ifdef PSRAM_FRAMEBUFFER
+  // settings page frame in PSRAM: page_gfx_ stays on it while the page is shown. Page functions only draw,
+  // FlushFrame() sends the dirty rectangle: once from DisplayCurrentPage and then from loop() for row and cursor changes
+  PsramFrame16* frame_ = NULL;
+  #endif
+
+  // two color bitmap expander: each bitmap byte maps to 8 RGB565 pixels
+  // table is rebuilt only when the color pair changes
+  TwoColorLut two_color_lut_;
+
+  // canvas arena: reserved once with the display object and sized for a full screen 1 bit canvas
+  // my_canvas_ borrows a view of it so the render path does no heap new/delete
+  static const size_t kCanvasArenaBytes = ((kTftWidth + 7) / 8) * kTftHeight;
+  uint8_t canvas_arena_[kCanvasArenaBytes];
+  CanvasArena canvas_views_ = CanvasArena(canvas_arena_, kCanvasArenaBytes);
+  // page palette canvas rows that fit in the arena
+  static const uint16_t kPageCanvasBandRows = kCanvasArenaBytes / ((kTftWidth + 1) / 2);
+
+  // pre-rasterized big clock digits for main page time row and screensaver
+  GlyphAtlas main_time_atlas_, screensaver_time_atlas_;
+
 // PRIVATE CONSTANTS
 
   // wifi networks scan page
@@ -172,6 +348,8 @@ private:
 
   // photoresistor pin's adc resolution (for all ADCs on MCU)
   const int kPhotodiodeLightRawMax = pow(2, kAdcResolutionBits) - 1;
+  // photoresistor sample period, 50 Hz, filtered value moves every AmbientLightFilter::kDecimation samples
+  const uint64_t kAmbientLightSamplePeriodUs = 20000;
 
   // display brightness constants
   const int kNightBrightness = 1;
@@ -180,6 +358,21 @@ private:
   const int kEveningBrightness = 100;
   const int kDayBrightness = 150;
 
+  // backlight fade times: quick on user input, slow for ambient and time of day changes
+  const uint16_t kWakeFadeMs = 120;
+  const uint16_t kAmbientFadeMs = 1500;
+  // LEDC backlight PWM, channel is only used by arduino-esp32 2.x which attaches by channel
+  const uint32_t kBacklightPwmFreq = 5000;
+  const uint8_t kBacklightLedcChannel = 7;
+
+  // screensaver frame rate per brightness band and motion speed independent of frame rate
+  const uint8_t kScreensaverDayFps = 40;
+  const uint8_t kScreensaverEveningFps = 25;
+  const uint8_t kScreensaverNightFps = 10;
+  const unsigned long kScreensaverSpeedPxPerSec = 40;
+  // longest frame gap that is turned into motion, so a blocked loop does not make the clock jump
+  const unsigned long kScreensaverMaxFrameGapMs = 250;
+
 
   // color definitions
   const uint16_t  kDisplayColorBlack        = 0x0000;
@@ -4,6 +4,26 @@
 #include "rtc.h"
 #include "touchscreen.h"
 
+// BlitTwoColorBitmap sink writing straight to the panel inside one SPI transaction
+// writePixels blocks until the row is out, so a single row buffer is enough
+template <typename Tft>
+struct TftRowSink {
+  Tft& tft;
+  #ifdef MORE_LOGS
+  unsigned long transfer_us = 0;
+  #endif
+  void SetWindow(int16_t x, int16_t y, int16_t w, int16_t h) { tft.setAddrWindow(x, y, w, h); }
+  void WritePixels(uint16_t* row, int16_t w) {
+    #ifdef MORE_LOGS
+    unsigned long t0 = micros();
+    #endif
+    tft.writePixels(row, w);
+    #ifdef MORE_LOGS
+    transfer_us += micros() - t0;
+    #endif
+  }
+};
+
 /*!
     @brief  Draw a 565 RGB image at the specified (x,y) position using monochrome 8-bit image.
             Converts each bitmap rows into 16-bit RGB buffer and sends over SPI.
@@ -16,66 +36,132 @@
     @param  bitmap   Pointer to 8-bit array of monochrome image
     @param  w        Width of bitmap in pixels.
     @param  h        Height of bitmap in pixels.
+    @param  col0     First bitmap column to send.
+    @param  col1     Bitmap column after the last one to send.
 */
-void RGBDisplay::FastDrawTwoColorBitmapSpi(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
-  int16_t x2, y2;                 // Lower-right coord
-  if ((x >= kTftWidth) ||            // Off-edge right
-      (y >= kTftHeight) ||           // " top
-      ((x2 = (x + w - 1)) < 0) || // " left
-      ((y2 = (y + h - 1)) < 0))
-    return; // " bottom
-
+void RGBDisplay::FastDrawTwoColorBitmapSpi(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg, int16_t col0, int16_t col1) {
   // elapsedMillis timer1;
 
-  int bx1 = 0, by1 = 0, // Clipped top-left within bitmap
-      saveW = w,            // Save original bitmap width value
-      saveH = h;
-  if (x < 0) {              // Clip left
-    w += x;
-    bx1 = -x;
-    x = 0;
-  }
-  if (y < 0) { // Clip top
-    h += y;
-    by1 = -y;
-    y = 0;
-  }
-  if (x2 >= kTftWidth)
-    w = kTftWidth - x; // Clip right
-  if (y2 >= kTftHeight)
-    h = kTftHeight - y; // Clip bottom
+  // byte to 8 pixel lookup table for this color pair
+  two_color_lut_.Set(color, bg);
 
-  int16_t jLim = min(saveH, h + by1);
-  int16_t iLim = min(saveW, w + bx1);
+  #ifdef MORE_LOGS
+  unsigned long t0 = micros();
+  #endif
+  TftRowSink<decltype(tft)> sink{tft};
+  tft.startWrite();
+  BlitTwoColorBitmap(sink, two_color_lut_, kTftWidth, kTftHeight, x, y, bitmap, w, h, col0, col1);
+  tft.endWrite();
+  #ifdef MORE_LOGS
+  fast_draw_transfer_us_ = sink.transfer_us;
+  fast_draw_expand_us_ = micros() - t0 - sink.transfer_us;
+  #endif
+  // Serial.print(" fastDrawBitmapTime "); Serial.print(charSpace); Serial.println(timer1);
+}
 
-  // new 16 bit buffter of length w to hold 1 row colors
+// send the stored band of a palette canvas to the same rows of the panel
+void RGBDisplay::FastDrawPaletteCanvasSpi(PaletteCanvas4* canvas) {
+  int16_t w = canvas->width(), h = canvas->band_h();
   uint16_t buffer16Bit[w];
   tft.startWrite();
-  tft.setAddrWindow(x, y, w, h);
-
-  int16_t bitmapWidthBytes = (saveW + 7) >> 3;          // bitmap width in bytes
-  for (int16_t j = by1; j < jLim; j++) {
-    int bufi = 0;
-    int16_t i = bx1;
-    uint8_t currentByte = bitmap[j * bitmapWidthBytes + (i >> 3)];
-    uint8_t bitIndex = 7 - i % 8;
-    while(1) {
-      buffer16Bit[bufi] = (((currentByte >> bitIndex)  & 0x01) ? color : bg);
-      bufi++;   // next row buffer index
-      i++;  // next pixel
-      if(i >= iLim)
-        break;
-      bitIndex = 7 - i % 8; // next bit index
-      if(bitIndex == 7)  // new byte
-        currentByte = bitmap[j * bitmapWidthBytes + (i >> 3)];
-    }
+  tft.setAddrWindow(0, canvas->band_y0(), w, h);
+  for (int16_t j = 0; j < h; j++) {
+    canvas->ExpandRow(j, buffer16Bit);
     tft.writePixels(buffer16Bit, w);
   }
   tft.endWrite();
-  // Serial.print(" fastDrawBitmapTime "); Serial.print(charSpace); Serial.println(timer1);
+}
+
+/*!
+    @brief  Draw set bits of a monochrome bitmap in color, leaving unset pixels as they are (same as
+            tft.drawBitmap). Each row is scanned for runs of set bits and every run is sent as one
+            horizontal line, all inside a single SPI transaction, instead of one write per pixel.
+    @param  x        Top left corner horizontal coordinate.
+    @param  y        Top left corner vertical coordinate.
+    @param  bitmap   Pointer to 8-bit array of monochrome image
+    @param  w        Width of bitmap in pixels.
+    @param  h        Height of bitmap in pixels.
+*/
+void RGBDisplay::DrawBitmapSpans(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color) {
+  int16_t bitmapWidthBytes = (w + 7) >> 3;
+  tft.startWrite();
+  for (int16_t j = 0; j < h; j++) {
+    const uint8_t* bitmap_row = bitmap + j * bitmapWidthBytes;
+    int16_t i = 0;
+    while(i < w) {
+      // skip unset bits, whole bytes at a time
+      if(bitmap_row[i >> 3] == 0x00) {
+        i = (i | 7) + 1;
+        continue;
+      }
+      if(!(bitmap_row[i >> 3] & (0x80 >> (i & 7)))) {
+        i++;
+        continue;
+      }
+      // run of set bits
+      int16_t run_start = i;
+      while(i < w && (bitmap_row[i >> 3] & (0x80 >> (i & 7))))
+        i++;
+      tft.writeFastHLine(x + run_start, y + j, i - run_start, color);
+    }
+  }
+  tft.endWrite();
+}
+
+/*!
+    @brief  Move a two color bitmap already on screen at (prev_x, prev_y) to (x, y) by sending only
+            the panel pixels that change, see MotionBlitTwoColorBitmap.
+            Panel outside the old bitmap must be bg. Intended for the few px screensaver moves.
+    @param  x        Top left corner horizontal coordinate.
+    @param  y        Top left corner vertical coordinate.
+    @param  prev_x   Top left corner horizontal coordinate where bitmap is on screen now.
+    @param  prev_y   Top left corner vertical coordinate where bitmap is on screen now.
+    @param  bitmap   Pointer to 8-bit array of monochrome image
+    @param  w        Width of bitmap in pixels.
+    @param  h        Height of bitmap in pixels.
+    @param  col0     First bitmap column drawn.
+    @param  col1     Bitmap column after the last one drawn.
+*/
+void RGBDisplay::FastDrawTwoColorBitmapMotionSpi(int16_t x, int16_t y, int16_t prev_x, int16_t prev_y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg, int16_t col0, int16_t col1) {
+  two_color_lut_.Set(color, bg);
+
+  TftRowSink<decltype(tft)> sink{tft};
+  tft.startWrite();
+  long pixels_sent = MotionBlitTwoColorBitmap<kTftWidth>(sink, two_color_lut_, kTftHeight, x, y, prev_x, prev_y, bitmap, w, h, col0, col1);
+  tft.endWrite();
+
+  #ifdef MORE_LOGS
+  // bytes a full blit of the visible bitmap would have sent, minus bytes sent
+  long full_pixels = (long)max(0, min((int)kTftWidth, x + w) - max(0, (int)x)) * max(0, min((int)kTftHeight, y + h) - max(0, (int)y));
+  motion_blit_saved_bytes_ = 2 * (full_pixels - pixels_sent);
+  #else
+  (void)pixels_sent;
+  #endif
+}
+
+// point my_canvas_ to a w x h canvas drawing into canvas_arena_
+// falls back to heap only if the canvas is larger than the arena
+GFXcanvas1* RGBDisplay::BorrowCanvas(uint16_t w, uint16_t h) {
+  SpanTextCanvas1* canvas = canvas_views_.Borrow(w, h);
+  #ifdef MORE_LOGS
+  if(canvas_views_.misses() != canvas_arena_misses_) {
+    canvas_arena_misses_ = canvas_views_.misses();
+    PrintLn("Canvas larger than arena, heap allocated. Misses: ", canvas_arena_misses_);
+  }
+  #endif
+  canvas->span_glyphs = canvas_span_text_;
+  my_canvas_ = canvas;
+  return my_canvas_;
+}
+
+// release my_canvas_, arena views are only destroyed, heap canvases are deleted
+void RGBDisplay::ReturnCanvas() {
+  canvas_views_.Return();
+  my_canvas_ = NULL;
 }
 
 void RGBDisplay::SetAlarmScreen(bool processUserInput, bool inc_button_pressed, bool dec_button_pressed, bool push_button_pressed) {
+  PROFILE_RENDER(kRenderAlarmSetScreen);
 
   int16_t gap_x = kTftWidth / 11;
   int16_t gap_y = kTftHeight / 9;
@@ -102,7 +188,7 @@ void RGBDisplay::SetAlarmScreen(bool processUserInput, bool inc_button_pressed,
     int16_t title_x0, title_y0;
     uint16_t title_w, title_h;
     // get bounds of title on tft display (with background color as this causes a blink)
-    tft.getTextBounds(title, 0, 0, &title_x0, &title_y0, &title_w, &title_h);
+    TextBounds(&Satisfy_Regular18pt7b, title, 0, 0, &title_x0, &title_y0, &title_w, &title_h);
 
     int16_t title_x = (kTftWidth - title_w) / 2;
     int16_t title_y = 2*gap_y;
@@ -417,15 +503,13 @@ void RGBDisplay::SetAlarmScreen(bool processUserInput, bool inc_button_pressed,
 }
 
 void RGBDisplay::DrawButton(int16_t x, int16_t y, uint16_t w, uint16_t h, const char* label, uint16_t borderColor, uint16_t onFill, uint16_t offFill, bool isOn) {
-  if(current_page == kAlarmSetPage)
-    tft.setFont(&FreeSans12pt7b);
-  else
-    tft.setFont(&FreeMonoBold9pt7b);
+  const GFXfont* button_font = (current_page == kAlarmSetPage ? &FreeSans12pt7b : &FreeMonoBold9pt7b);
+  tft.setFont(button_font);
   tft.setTextColor((isOn ? onFill : offFill));
   int16_t title_x0, title_y0;
   uint16_t title_w, title_h;
   // get bounds of title on tft display (with background color as this causes a blink)
-  tft.getTextBounds(label, x, y + h, &title_x0, &title_y0, &title_w, &title_h);
+  TextBounds(button_font, label, x, y + h, &title_x0, &title_y0, &title_w, &title_h);
   // make button
   tft.fillRoundRect(x, y, w, h, kRadiusButtonRoundRect, (isOn ? onFill : offFill));
   tft.drawRoundRect(x, y, w, h, kRadiusButtonRoundRect, borderColor);
@@ -459,50 +543,71 @@ void RGBDisplay::DrawTriangleButton(int16_t x, int16_t y, uint16_t w, uint16_t h
   tft.drawTriangle(x1, y1, x2, y2, x3, y3, borderColor);
 }
 
-void RGBDisplay::DisplayCursorHighlight(DisplayButton* button, bool highlight_On) {
+// where a page button is on screen: fixed ones from the page table, row buttons sized to their value text
+ButtonRect RGBDisplay::PageButtonRect(const DisplayButton* button, int button_index) {
+  if(button->fixed_location)
+    return button->fixed_rect;
+  int16_t x1, y1;
+  uint16_t w, h;
+  TextBounds(&FreeMonoBold9pt7b, ButtonValue(button), 0, PageLayout::RowTextY0(button_index), &x1, &y1, &w, &h);
+  return PageLayout::RowButton(button_index, w, h, button->btn_type == kLabelOnlyNoClickButton);
+}
+
+void RGBDisplay::DisplayCursorHighlight(const DisplayButton* button, int button_index, bool highlight_On) {
+  Adafruit_GFX &gfx = *page_gfx_;
   // special case first
   if((current_page == kWiFiScanNetworksPage) && (current_cursor == kWiFiScanNetworksPageList)) {
     // inside WiFi Scan Networks Page List
     int cursorY = kWiFiScanNetworksList_y0_ - 0.75 * kWiFiScanNetworksList_h_ + 1 + (kWiFiScanNetworksList_h_ * current_wifi_networks_scan_page_cursor);
     if(highlight_On) {
-      tft.drawRoundRect(0, cursorY, kTftWidth - 1, kWiFiScanNetworksList_h_, kRadiusButtonRoundRect, kDisplayColorCyan);
+      gfx.drawRoundRect(0, cursorY, kTftWidth - 1, kWiFiScanNetworksList_h_, kRadiusButtonRoundRect, kDisplayColorCyan);
     }
     else {
-      tft.drawRoundRect(0, cursorY, kTftWidth - 1, kWiFiScanNetworksList_h_, kRadiusButtonRoundRect, kDisplayBackroundColor);
+      gfx.drawRoundRect(0, cursorY, kTftWidth - 1, kWiFiScanNetworksList_h_, kRadiusButtonRoundRect, kDisplayBackroundColor);
     }
   }
   else {
-    if(highlight_On) {
-      tft.drawRoundRect(button->btn_x - 1, button->btn_y - 1, button->btn_w + 2 * 1, button->btn_h + 2 * 1, kRadiusButtonRoundRect, kDisplayColorCyan);
-      tft.drawRoundRect(button->btn_x - 2, button->btn_y - 2, button->btn_w + 2 * 2, button->btn_h + 2 * 2, kRadiusButtonRoundRect, kDisplayColorCyan);
-    }
-    else {
-      tft.drawRoundRect(button->btn_x - 1, button->btn_y - 1, button->btn_w + 2 * 1, button->btn_h + 2 * 1, kRadiusButtonRoundRect, kDisplayBackroundColor);
-      tft.drawRoundRect(button->btn_x - 2, button->btn_y - 2, button->btn_w + 2 * 2, button->btn_h + 2 * 2, kRadiusButtonRoundRect, kDisplayBackroundColor);
+    ButtonRect rect = PageButtonRect(button, button_index);
+    for (int16_t i = 1; i <= 2; i++) {
+      ButtonRect ring = rect.Grown(i);
+      gfx.drawRoundRect(ring.x, ring.y, ring.w, ring.h, kRadiusButtonRoundRect, (highlight_On ? kDisplayColorCyan : kDisplayBackroundColor));
     }
   }
 }
 
 void RGBDisplay::DisplayCursorHighlight(bool highlight_On) {
   for (int i = 0; i < display_pages_vec[current_page].size(); i++) {
-    DisplayButton* button = display_pages_vec[current_page][i];
+    const DisplayButton* button = display_pages_vec[current_page][i];
     if(button->btn_cursor_id == current_cursor) {
-      DisplayCursorHighlight(button, highlight_On);
+      DisplayCursorHighlight(button, i, highlight_On);
       break;
     }
   }
 }
 
-void RGBDisplay::DisplayCurrentPageButtonRow(DisplayButton* button, int button_index, bool is_on) {
+void RGBDisplay::DisplayCurrentPageButtonRow(const DisplayButton* button, int button_index, bool is_on) {
+  Adafruit_GFX &gfx = *page_gfx_;
 
   // exclude special case: (current_page == kWiFiScanNetworksPage) && (current_cursor == kWiFiScanNetworksPageList) -> these list items are just label
   if((current_page != kWiFiScanNetworksPage) || (current_cursor != kWiFiScanNetworksPageList)) {
 
-    const int row_text_y0 = (button_index + 1) * kPageRowHeight + 20;
+    const int row_text_y0 = PageLayout::RowTextY0(button_index);
+    const char* value = ButtonValue(button);
+
+    // retained page: row already on screen with this value keeps its layout
+    bool retained = (retained_page_ == current_page && button_index < retained_rows_.size());
+    if(retained && retained_rows_[button_index].drawn && retained_rows_[button_index].value == value) {
+      if(retained_rows_[button_index].is_on != is_on && button->btn_type != kClickButtonWithIcon && button->btn_type != kLabelOnlyNoClickButton)
+        DrawPageButtonFace(button, button_index, is_on);
+      retained_rows_[button_index].is_on = is_on;
+      DisplayCursorHighlight(button, button_index, button->btn_cursor_id == current_cursor);
+      return;
+    }
 
     // clear row if item has label
-    if(button->row_label.size() > 0)
-      tft.fillRect(0, row_text_y0 - 20, kTftWidth, kPageRowHeight, kDisplayBackroundColor);
+    int row_label_length = strlen(button->row_label);
+    if(row_label_length > 0)
+      gfx.fillRect(0, row_text_y0 - 20, kTftWidth, kPageRowHeight, kDisplayBackroundColor);
 
     int space_left = kTftWidth;
 
@@ -512,114 +617,212 @@ void RGBDisplay::DisplayCurrentPageButtonRow(DisplayButton* button, int button_i
 
     // if not an icon button then make a button
     if(button->btn_type != kClickButtonWithIcon) {
-      if(button->fixed_location) {
-        // pre-fixed location button
-        tft.setFont(&FreeMonoBold9pt7b);
-        tft.setTextColor(kDisplayColorBlack);
-        // make button
-        tft.fillRoundRect(button->btn_x, button->btn_y, button->btn_w, button->btn_h, kRadiusButtonRoundRect, (is_on ? kButtonClickedFillColor : kButtonFillColor));
-        tft.drawRoundRect(button->btn_x, button->btn_y, button->btn_w, button->btn_h, kRadiusButtonRoundRect, kButtonBorderColor);
-        int16_t btn_value_x0 = button->btn_x + kDisplayTextGap, btn_value_y0 = button->btn_y + button->btn_h - kDisplayTextGap;
-        tft.setCursor(btn_value_x0, btn_value_y0);
-        tft.print(button->btn_value.c_str());
-      }
-      else {
-        // button location to be calculated at runtime
-        tft.setFont(&FreeMonoBold9pt7b);
-        tft.setTextColor(kDisplayColorBlack);
-        int16_t btn_value_x0 = 0, btn_value_y0 = row_text_y0;
-        uint16_t btn_value_w, btn_value_h;
-        tft.setCursor(btn_value_x0, row_text_y0);
-        // get bounds of title on tft display (with background color as this causes a blink)
-        tft.getTextBounds(button->btn_value.c_str(), btn_value_x0, btn_value_y0, &btn_value_x0, &btn_value_y0, &btn_value_w, &btn_value_h);
-        // Serial.printf("btn_value_x0 %d, btn_value_y0 %d, btn_value_w %d, btn_value_h %d\n", btn_value_x0, btn_value_y0, btn_value_w, btn_value_h);
-        // calculate size
-        button->btn_x = kTftWidth - btn_value_w - 3 * kDisplayTextGap;
-        button->btn_y = row_text_y0 - btn_value_h - kDisplayTextGap;
-        button->btn_w = btn_value_w + 2 * kDisplayTextGap;
-        button->btn_h = btn_value_h + 2 * kDisplayTextGap;
-        // Serial.printf("flexible button->btn_x %d, button->btn_y %d, button->btn_w %d, button->btn_h %d\n", button->btn_x, button->btn_y, button->btn_w, button->btn_h);
-        // make button
-        if(button->btn_type == kLabelOnlyNoClickButton) {
-          // special case -> only label, no click button
-          tft.setTextColor(kDisplayColorGreen);
-          button->btn_x = button->btn_x + 2 * kDisplayTextGap;
-          tft.setCursor(button->btn_x, row_text_y0);
-          tft.print(button->btn_value.c_str());
-        }
-        else {
-          tft.fillRoundRect(button->btn_x, button->btn_y, button->btn_w, button->btn_h, kRadiusButtonRoundRect, (is_on ? kButtonClickedFillColor : kButtonFillColor));
-          tft.drawRoundRect(button->btn_x, button->btn_y, button->btn_w, button->btn_h, kRadiusButtonRoundRect, kButtonBorderColor);
-          tft.setCursor(button->btn_x + kDisplayTextGap, row_text_y0);
-          tft.print(button->btn_value.c_str());
-        }
+      // fixed location from the page table, or sized to the value text
+      ButtonRect rect = PageButtonRect(button, button_index);
+      if(button->btn_type == kLabelOnlyNoClickButton) {
+        // special case -> only label, no click button
+        gfx.setFont(&FreeMonoBold9pt7b);
+        gfx.setTextColor(kDisplayColorGreen);
+        gfx.setCursor(rect.x, row_text_y0);
+        gfx.print(value);
       }
+      else
+        DrawPageButtonFace(button, button_index, is_on);
 
-      space_left = button->btn_x - kDisplayTextGap;
+      space_left = rect.x - kDisplayTextGap;
     }
 
     // item label
 
-    if(button->row_label.size() > 0) {
-      tft.setFont(&FreeMono9pt7b);
-      tft.setTextColor(kDisplayColorBlack);
+    if(row_label_length > 0) {
+      gfx.setFont(&FreeMono9pt7b);
+      gfx.setTextColor(kDisplayColorBlack);
       int16_t row_label_x0 = 0, row_label_y0 = row_text_y0;
       uint16_t row_label_w, row_label_h;
-      tft.setCursor(row_label_x0, row_text_y0);
+      gfx.setCursor(row_label_x0, row_text_y0);
       // get bounds of title on tft display (with background color as this causes a blink)
-      tft.getTextBounds(button->row_label.c_str(), row_label_x0, row_label_y0, &row_label_x0, &row_label_y0, &row_label_w, &row_label_h);
+      TextBounds(&FreeMono9pt7b, button->row_label, row_label_x0, row_label_y0, &row_label_x0, &row_label_y0, &row_label_w, &row_label_h);
       // Serial.printf("row_label_x0 %d, row_label_y0 %d, row_label_w %d, row_label_h %d\n", row_label_x0, row_label_y0, row_label_w, row_label_h);
       // check width and fit in 1 or 2 rows
       if(row_label_w + kDisplayTextGap <= space_left) {
         // label fits in 1 row
-        tft.setTextColor(kDisplayColorYellow);
-        tft.setCursor(kDisplayTextGap, row_text_y0);
-        tft.print(button->row_label.c_str());
+        gfx.setTextColor(kDisplayColorYellow);
+        gfx.setCursor(kDisplayTextGap, row_text_y0);
+        gfx.print(button->row_label);
       }
       else {
         // we give label 2 rows
-        tft.setTextColor(kDisplayColorYellow);
+        gfx.setTextColor(kDisplayColorYellow);
         // row 1
-        tft.setCursor(kDisplayTextGap, row_text_y0 - 10);
-        int row_1_label_length = button->row_label.size() / 2;
-        std::string row_1_label = button->row_label.substr(0, row_1_label_length);
-        tft.print(row_1_label.c_str());
-        tft.setCursor(kDisplayTextGap, row_text_y0 + 5);
-        std::string row_2_label = button->row_label.substr(row_1_label_length, button->row_label.size() - row_1_label_length);
-        tft.print(row_2_label.c_str());
+        gfx.setCursor(kDisplayTextGap, row_text_y0 - 10);
+        int row_1_label_length = row_label_length / 2;
+        std::string row_1_label(button->row_label, row_1_label_length);
+        gfx.print(row_1_label.c_str());
+        gfx.setCursor(kDisplayTextGap, row_text_y0 + 5);
+        gfx.print(button->row_label + row_1_label_length);
       }
     }
+
+    // remember what this row was drawn with
+    if(retained) {
+      retained_rows_[button_index].drawn = true;
+      retained_rows_[button_index].is_on = is_on;
+      retained_rows_[button_index].value = value;
+    }
   }
 
   // button highlight
   if(button->btn_cursor_id == current_cursor)
-    DisplayCursorHighlight(button, true);
+    DisplayCursorHighlight(button, button_index, true);
   else
-    DisplayCursorHighlight(button, false);
+    DisplayCursorHighlight(button, button_index, false);
+}
+
+// button rectangle and value text at its laid out position
+void RGBDisplay::DrawPageButtonFace(const DisplayButton* button, int button_index, bool is_on) {
+  Adafruit_GFX &gfx = *page_gfx_;
+  ButtonRect rect = PageButtonRect(button, button_index);
+  gfx.setFont(&FreeMonoBold9pt7b);
+  gfx.setTextColor(kDisplayColorBlack);
+  // make button
+  gfx.fillRoundRect(rect.x, rect.y, rect.w, rect.h, kRadiusButtonRoundRect, (is_on ? kButtonClickedFillColor : kButtonFillColor));
+  gfx.drawRoundRect(rect.x, rect.y, rect.w, rect.h, kRadiusButtonRoundRect, kButtonBorderColor);
+  if(button->fixed_location)
+    gfx.setCursor(rect.x + kDisplayTextGap, rect.y + rect.h - kDisplayTextGap);
+  else
+    gfx.setCursor(rect.x + kDisplayTextGap, PageLayout::RowTextY0(button_index));
+  gfx.print(ButtonValue(button));
+}
+
+// forget retained rows, screen no longer shows what DisplayCurrentPage drew
+void RGBDisplay::InvalidateRetainedPage() {
+  retained_page_ = kNoPageSelected;
+  retained_rows_.clear();
+  #ifdef PSRAM_FRAMEBUFFER
+  // next screen draws on panel
+  page_gfx_ = &tft;
+  #endif
+}
+
+// send what was drawn in the PSRAM frame since last flush, only the dirty rectangle goes over SPI
+void RGBDisplay::FlushFrame() {
+  #ifdef PSRAM_FRAMEBUFFER
+  if(frame_ == NULL || page_gfx_ != frame_ || !frame_->dirty())
+    return;
+  #ifdef MORE_LOGS
+  unsigned long t0 = micros();
+  int16_t x, y, w, h;
+  frame_->DirtyRect(&x, &y, &w, &h);
+  #endif
+  frame_->Flush(tft);
+  #ifdef MORE_LOGS
+  if(debug_mode) {
+    unsigned long flush_us = max(micros() - t0, 1UL);
+    unsigned long bytes = (unsigned long)w * h * sizeof(uint16_t);
+    Serial.printf("Frame flush %dx%d at %d,%d: %lu bytes in %lu us (%lu KB/s)\n", w, h, x, y, bytes, flush_us, bytes * 1000 / flush_us);
+  }
+  #endif
+  #endif
 }
 
 void RGBDisplay::DisplayCurrentPageButtonRow(int button_index, bool is_on) {
-  DisplayButton* button = display_pages_vec[current_page][button_index];
+  const DisplayButton* button = display_pages_vec[current_page][button_index];
   DisplayCurrentPageButtonRow(button, button_index, is_on);
 }
 
 void RGBDisplay::DisplayCurrentPageButtonRow(bool is_on) {
+  #ifdef MORE_LOGS
+  unsigned long t0 = micros();
+  #endif
   for (int i = 0; i < display_pages_vec[current_page].size(); i++) {
     if(display_pages_vec[current_page][i]->btn_cursor_id == current_cursor) {
-      DisplayButton* button = display_pages_vec[current_page][i];
+      const DisplayButton* button = display_pages_vec[current_page][i];
       DisplayCurrentPageButtonRow(button, i, is_on);
       break;
     }
   }
+  #ifdef MORE_LOGS
+  if(debug_mode)
+    PrintLn("Button row draw time (us): ", (int)(micros() - t0));
+  #endif
 }
 
 void RGBDisplay::DisplayCurrentPage() {
-  tft.fillScreen(kDisplayBackroundColor);
+  PROFILE_RENDER(kRenderCurrentPage);
+  #ifdef PSRAM_FRAMEBUFFER
+  if(frame_ != NULL) {
+    // compose the page in the PSRAM frame, it stays the draw target for row updates until page changes
+    page_gfx_ = frame_;
+    frame_->fillScreen(kDisplayBackroundColor);
+    DrawCurrentPage();
+    FlushFrame();
+    return;
+  }
+  #endif
+
+  // compose the page on a palette canvas and send it band by band instead of painting the panel item by item
+  // the page is laid out once into the draw list, each band replays the calls that reach it
+  // the canvas draws into the canvas arena, so the borrowed 1 bit canvas is given back first
+  ReturnCanvas();
+  refresh_screensaver_canvas_ = true;
+  PaletteCanvas4 page_canvas(kTftWidth, kTftHeight, canvas_arena_, kCanvasArenaBytes);
+  PaletteCanvas4* canvas = &page_canvas;
+
+  #ifdef MORE_LOGS
+  unsigned long render_us = 0, transfer_us = 0, t0 = micros();
+  #endif
+  page_draw_list_.Clear();
+  page_gfx_ = &page_draw_list_;
+  DrawCurrentPage();
+  page_gfx_ = &tft;
+  #ifdef MORE_LOGS
+  unsigned long layout_us = micros() - t0;
+  #endif
+  for (int16_t band_y0 = 0; band_y0 < kTftHeight; band_y0 += kPageCanvasBandRows) {
+    #ifdef MORE_LOGS
+    t0 = micros();
+    #endif
+    canvas->SetBand(band_y0, min((int)kPageCanvasBandRows, kTftHeight - band_y0));
+    canvas->fillScreen(kDisplayBackroundColor);
+    page_draw_list_.Replay(*canvas, band_y0, canvas->band_h());
+    #ifdef MORE_LOGS
+    render_us += micros() - t0;
+    t0 = micros();
+    #endif
+    FastDrawPaletteCanvasSpi(canvas);
+    #ifdef MORE_LOGS
+    transfer_us += micros() - t0;
+    #endif
+  }
+  #ifdef MORE_LOGS
+  size_t draw_list_calls = page_draw_list_.size();
+  #endif
+  // pages are opened now and then, the recorded calls are not kept between them
+  page_draw_list_.Release();
+  #ifdef MORE_LOGS
+  if(debug_mode) {
+    PrintLn("Page layout time (us): ", (int)layout_us);
+    PrintLn("Page draw list calls: ", (int)draw_list_calls);
+    PrintLn("Page canvas render time (us): ", (int)render_us);
+    PrintLn("Page canvas transfer time (us): ", (int)transfer_us);
+    if(canvas->unfit_lookups() > 0)
+      PrintLn("Page canvas colors past the palette, drawn with the nearest entry: ", (int)canvas->unfit_lookups());
+  }
+  #endif
+}
+
+// title, button rows and footer of current settings page, drawn on page_gfx_
+void RGBDisplay::DrawCurrentPage() {
+  Adafruit_GFX &gfx = *page_gfx_;
+
+  // rows of this page are retained from here on
+  retained_page_ = current_page;
+  retained_rows_.assign(display_pages_vec[current_page].size(), RetainedButtonRow{ false, false, "" });
 
   // Page Title
-  tft.setFont(&FreeMonoBold9pt7b);
-  tft.setTextColor(kDisplayColorGreen);
-  tft.setCursor(kDisplayTextGap, 20);
+  gfx.setFont(&FreeMonoBold9pt7b);
+  gfx.setTextColor(kDisplayColorGreen);
+  gfx.setCursor(kDisplayTextGap, 20);
   std::string title_str = "";
   switch(current_page) {
     case kScreensaverSettingsPage: title_str = "SCREENSAVER SETTINGS PAGE"; break;
@@ -628,7 +831,7 @@ void RGBDisplay::DisplayCurrentPage() {
     case kLocationAndWeatherSettingsPage: title_str = "LOCATION & WEATHER SETTINGS"; break;
     default: title_str = "Not Implemented!";
   }
-  tft.print(title_str.c_str());
+  gfx.print(title_str.c_str());
 
   // Page Body
   for (int i = 0; i < display_pages_vec[current_page].size(); i++) {
@@ -654,54 +857,56 @@ void RGBDisplay::DisplayBlankScreen() {
 }
 
 void RGBDisplay::DisplayWiFiConnectionStatus() {
+  Adafruit_GFX &gfx = *page_gfx_;
   // clear any old text
-  tft.setFont(&FreeSans12pt7b);
-  tft.setTextColor(kDisplayBackroundColor);
-  tft.setCursor(kDisplayTextGap, 190);
-  tft.print("WiFi Connected!");
-
-  tft.setFont(&FreeMono9pt7b);
-  tft.setCursor(kDisplayTextGap, 170);
-  tft.print("Could not");
-  tft.setCursor(kDisplayTextGap, 190);
-  tft.print("connect to saved");
-  tft.setCursor(kDisplayTextGap, 210);
-  tft.print("WiFi Network.");
+  gfx.setFont(&FreeSans12pt7b);
+  gfx.setTextColor(kDisplayBackroundColor);
+  gfx.setCursor(kDisplayTextGap, 190);
+  gfx.print("WiFi Connected!");
+
+  gfx.setFont(&FreeMono9pt7b);
+  gfx.setCursor(kDisplayTextGap, 170);
+  gfx.print("Could not");
+  gfx.setCursor(kDisplayTextGap, 190);
+  gfx.print("connect to saved");
+  gfx.setCursor(kDisplayTextGap, 210);
+  gfx.print("WiFi Network.");
 
   // write new text
   if(wifi_stuff->wifi_connected_) {
-    tft.setFont(&FreeSans12pt7b);
-    tft.setTextColor(kDisplayColorBlue);
-    tft.setCursor(kDisplayTextGap, 190);
-    tft.print("WiFi Connected!");
+    gfx.setFont(&FreeSans12pt7b);
+    gfx.setTextColor(kDisplayColorBlue);
+    gfx.setCursor(kDisplayTextGap, 190);
+    gfx.print("WiFi Connected!");
   }
   else {
-    tft.setFont(&FreeMono9pt7b);
-    tft.setTextColor(kDisplayColorBlue);
-    tft.setCursor(kDisplayTextGap, 170);
-    tft.print("Could not");
-    tft.setCursor(kDisplayTextGap, 190);
-    tft.print("connect to saved");
-    tft.setCursor(kDisplayTextGap, 210);
-    tft.print("WiFi Network.");
+    gfx.setFont(&FreeMono9pt7b);
+    gfx.setTextColor(kDisplayColorBlue);
+    gfx.setCursor(kDisplayTextGap, 170);
+    gfx.print("Could not");
+    gfx.setCursor(kDisplayTextGap, 190);
+    gfx.print("connect to saved");
+    gfx.setCursor(kDisplayTextGap, 210);
+    gfx.print("WiFi Network.");
   }
 }
 
 void RGBDisplay::DisplayFirmwareVersionAndDate() {
+  Adafruit_GFX &gfx = *page_gfx_;
   // Firmware Version and Date
-  tft.setFont(&FreeMono9pt7b);
-  tft.setTextColor(kDisplayColorBlue);
-  tft.setCursor(10, kTftHeight - 20);
-  tft.print("Firmware: ");
-  tft.print(kFirmwareVersion.c_str());
+  gfx.setFont(&FreeMono9pt7b);
+  gfx.setTextColor(kDisplayColorBlue);
+  gfx.setCursor(10, kTftHeight - 20);
+  gfx.print("Firmware: ");
+  gfx.print(kFirmwareVersion.c_str());
   if(wifi_stuff->firmware_update_available_str_.size() > 0) {
-    tft.setFont(&FreeMonoBold9pt7b);
-    tft.print(" (latest)");
-    tft.setFont(&FreeMono9pt7b);
+    gfx.setFont(&FreeMonoBold9pt7b);
+    gfx.print(" (latest)");
+    gfx.setFont(&FreeMono9pt7b);
   }
-  tft.setCursor(10, kTftHeight - 5);
-  tft.print("Date: ");
-  tft.print(kFirmwareDate.c_str());
+  gfx.setCursor(10, kTftHeight - 5);
+  gfx.print("Date: ");
+  gfx.print(kFirmwareDate.c_str());
 }
 
 Cursor RGBDisplay::CheckButtonTouch() {
@@ -709,8 +914,8 @@ Cursor RGBDisplay::CheckButtonTouch() {
   Serial.print("ts_x:"); Serial.print(ts_x); Serial.print(", ts_y:"); Serial.println(ts_y);
 
   for (int i = 0; i < display_pages_vec[current_page].size(); i++) {
-    DisplayButton* button = display_pages_vec[current_page][i];
-    if(ts_x >= button->btn_x && ts_x <= button->btn_x + button->btn_w && ts_y >= button->btn_y && ts_y <= button->btn_y + button->btn_h) {
+    const DisplayButton* button = display_pages_vec[current_page][i];
+    if(PageButtonRect(button, i).Contains(ts_x, ts_y)) {
       //DisplayCurrentPageButtonRow(i, true);
       //delay(kUserInputDelayMs);
       return button->btn_cursor_id;
@@ -901,6 +1106,7 @@ void RGBDisplay::LocationInputsLocalServerPage() {
 }
 
 void RGBDisplay::DisplayWeatherInfo() {
+  Adafruit_GFX &gfx = *page_gfx_;
 
   const int16_t alarm_triggered_page_title_y0 = 50;
   const int16_t long_press_alarm_seconds_y0 = alarm_triggered_page_title_y0 + 48;
@@ -914,59 +1120,59 @@ void RGBDisplay::DisplayWeatherInfo() {
 
   // show today's weather
   if(wifi_stuff->got_weather_info_) {
-    // tft.setFont(&FreeMonoBold9pt7b);
+    // gfx.setFont(&FreeMonoBold9pt7b);
     if(current_page == kLocationAndWeatherSettingsPage) {
-      tft.setFont(&FreeMonoBold9pt7b);
-      tft.setCursor(60, 50);
-      tft.setTextColor(kDisplayColorGreen);
-      tft.print(wifi_stuff->city_.c_str());
-      tft.setTextColor(kDisplayColorBlue);
+      gfx.setFont(&FreeMonoBold9pt7b);
+      gfx.setCursor(60, 50);
+      gfx.setTextColor(kDisplayColorGreen);
+      gfx.print(wifi_stuff->city_.c_str());
+      gfx.setTextColor(kDisplayColorBlue);
     }
     else {
-      tft.setFont(&FreeSans12pt7b);
-      tft.setCursor(city_x0, city_y0);
-      tft.setTextColor(kDisplayColorOrange);
-      tft.print(wifi_stuff->city_.c_str());
+      gfx.setFont(&FreeSans12pt7b);
+      gfx.setCursor(city_x0, city_y0);
+      gfx.setTextColor(kDisplayColorOrange);
+      gfx.print(wifi_stuff->city_.c_str());
     }
-    tft.setFont(&FreeSans12pt7b);
-    tft.setCursor(weather_x0, weather_main_y0);
-    tft.print(wifi_stuff->weather_main_.c_str()); tft.print(" : "); tft.print(wifi_stuff->weather_description_.c_str());
-    tft.setFont(&FreeMono9pt7b);
-    tft.setCursor(weather_x0, weather_row2_y0);
-    tft.print("Temp: "); tft.print(wifi_stuff->weather_temp_.c_str()); tft.print("  Feels: "); tft.print(wifi_stuff->weather_temp_feels_like_.c_str());
-    tft.setCursor(weather_x0, weather_row3_y0);
-    tft.print("Max : "); tft.print(wifi_stuff->weather_temp_max_.c_str()); tft.print("  Min: "); tft.print(wifi_stuff->weather_temp_min_.c_str());
-    tft.setCursor(weather_x0, weather_row4_y0);
-    tft.print("Wind: "); tft.print(wifi_stuff->weather_wind_speed_.c_str()); tft.print(" Humidity: "); tft.print(wifi_stuff->weather_humidity_.c_str());
+    gfx.setFont(&FreeSans12pt7b);
+    gfx.setCursor(weather_x0, weather_main_y0);
+    gfx.print(wifi_stuff->weather_main_.c_str()); gfx.print(" : "); gfx.print(wifi_stuff->weather_description_.c_str());
+    gfx.setFont(&FreeMono9pt7b);
+    gfx.setCursor(weather_x0, weather_row2_y0);
+    gfx.print("Temp: "); gfx.print(wifi_stuff->weather_temp_.c_str()); gfx.print("  Feels: "); gfx.print(wifi_stuff->weather_temp_feels_like_.c_str());
+    gfx.setCursor(weather_x0, weather_row3_y0);
+    gfx.print("Max : "); gfx.print(wifi_stuff->weather_temp_max_.c_str()); gfx.print("  Min: "); gfx.print(wifi_stuff->weather_temp_min_.c_str());
+    gfx.setCursor(weather_x0, weather_row4_y0);
+    gfx.print("Wind: "); gfx.print(wifi_stuff->weather_wind_speed_.c_str()); gfx.print(" Humidity: "); gfx.print(wifi_stuff->weather_humidity_.c_str());
   }
   else {
-    tft.setTextColor(kDisplayColorBlue);
-    tft.setFont(&FreeMono9pt7b);
+    gfx.setTextColor(kDisplayColorBlue);
+    gfx.setFont(&FreeMono9pt7b);
     if(wifi_stuff->openWeatherMapApiKey.size() == 0) {
-      tft.setCursor(weather_x0, weather_row2_y0);
-      tft.print("Cannot fetch/update time.");
-      tft.setCursor(weather_x0, weather_row3_y0);
-      tft.print("OpenWeatherMapApiKey empty!");
+      gfx.setCursor(weather_x0, weather_row2_y0);
+      gfx.print("Cannot fetch/update time.");
+      gfx.setCursor(weather_x0, weather_row3_y0);
+      gfx.print("OpenWeatherMapApiKey empty!");
     }
     else if(wifi_stuff->get_weather_info_wait_seconds_ > 0) {
-      tft.setCursor(weather_x0, weather_row2_y0);
-      tft.print("Wait for ");
-      tft.print(wifi_stuff->get_weather_info_wait_seconds_);
-      tft.print(" seconds");
-      tft.setCursor(weather_x0, weather_row3_y0);
-      tft.print("before next Fetch.");
+      gfx.setCursor(weather_x0, weather_row2_y0);
+      gfx.print("Wait for ");
+      gfx.print(wifi_stuff->get_weather_info_wait_seconds_);
+      gfx.print(" seconds");
+      gfx.setCursor(weather_x0, weather_row3_y0);
+      gfx.print("before next Fetch.");
     }
     else if(wifi_stuff->incorrect_zip_code) {
-      tft.setCursor(weather_x0, weather_row2_y0);
-      tft.print("Incorrect");
-      tft.setCursor(weather_x0, weather_row3_y0);
-      tft.print("Location/ZIP!");
+      gfx.setCursor(weather_x0, weather_row2_y0);
+      gfx.print("Incorrect");
+      gfx.setCursor(weather_x0, weather_row3_y0);
+      gfx.print("Location/ZIP!");
     }
     else {
-      tft.setCursor(weather_x0, weather_row2_y0);
-      tft.print("Could not fetch");
-      tft.setCursor(weather_x0, weather_row3_y0);
-      tft.print("Weather info!");
+      gfx.setCursor(weather_x0, weather_row2_y0);
+      gfx.print("Could not fetch");
+      gfx.setCursor(weather_x0, weather_row3_y0);
+      gfx.print("Weather info!");
     }
   }
 }
@@ -992,6 +1198,7 @@ void RGBDisplay::FirmwareUpdatePage() {
 }
 
 void RGBDisplay::AlarmTriggeredScreen(bool firstTime, int8_t buttonPressSecondsCounter) {
+  PROFILE_RENDER(kRenderAlarmTriggeredScreen);
 
   int16_t title_x0 = 30, title_y0 = 40;
   int16_t s_x0 = 230, s_y0 = title_y0 + 48;
@@ -1047,33 +1254,61 @@ void RGBDisplay::AlarmTriggeredScreen(bool firstTime, int8_t buttonPressSecondsC
   tft.print(timer_str);
 }
 
+// screensaver target frame rate for current display brightness
+// the colored edge moves 1 px per frame, so it needs a frame for every px at kScreensaverSpeedPxPerSec
+uint8_t RGBDisplay::ScreensaverTargetFps() {
+  uint8_t fps;
+  if(current_brightness_ <= kNonNightMinBrightness)
+    fps = kScreensaverNightFps;
+  else if(current_brightness_ < kDayBrightness)
+    fps = kScreensaverEveningFps;
+  else
+    fps = kScreensaverDayFps;
+  if(screensaver_canvas_has_edge_ && fps < kScreensaverSpeedPxPerSec)
+    fps = kScreensaverSpeedPxPerSec;
+  return fps;
+}
+
+// ms left before next screensaver frame is due, 0 if due now
+unsigned long RGBDisplay::ScreensaverMsToNextFrame() {
+  unsigned long frame_period_ms = 1000 / ScreensaverTargetFps();
+  unsigned long elapsed_ms = millis() - screensaver_last_frame_ms_;
+  return (elapsed_ms >= frame_period_ms ? 0 : frame_period_ms - elapsed_ms);
+}
+
 void RGBDisplay::Screensaver() {
   const int16_t GAP_BAND = 5;
+
+  // motion owed for time since last frame
+  unsigned long now_ms = millis();
+  unsigned long frame_interval_ms = now_ms - screensaver_last_frame_ms_;
+  screensaver_last_frame_ms_ = now_ms;
+  #ifdef MORE_LOGS
+  screensaver_frame_interval_min_ms_ = min(screensaver_frame_interval_min_ms_, frame_interval_ms);
+  screensaver_frame_interval_max_ms_ = max(screensaver_frame_interval_max_ms_, frame_interval_ms);
+  #endif
+  screensaver_step_.Add(min(frame_interval_ms, kScreensaverMaxFrameGapMs), kScreensaverSpeedPxPerSec);
+
   if(refresh_screensaver_canvas_) {
+    PROFILE_RENDER(kRenderScreensaverCanvas);
     #ifdef MORE_LOGS
     // map time
     elapsedMillis timer1;
     #endif
 
-    // delete created canvas and null the pointer
-    if(my_canvas_ != NULL) {
-      delete my_canvas_;
-      my_canvas_ = NULL;
-    }
+    // return previous canvas to arena
+    ReturnCanvas();
 
     // get bounds of HH:MM text on screen
     tft.setFont(&ComingSoon_Regular70pt7b);
     tft.setTextColor(kDisplayBackroundColor);
-    tft.getTextBounds(new_display_data_.time_HHMM, 0, 0, &gap_right_x_, &gap_up_y_, &tft_HHMM_w_, &tft_HHMM_h_);
+    TextBounds(&ComingSoon_Regular70pt7b, new_display_data_.time_HHMM, 0, 0, &gap_right_x_, &gap_up_y_, &tft_HHMM_w_, &tft_HHMM_h_);
 
     // get bounds of date string
     uint16_t date_h = 0, date_w = 0;
     int16_t date_gap_x = 0, date_gap_y = 0;
-    if(rtc->hour() >= 10)
-      tft.setFont(&Satisfy_Regular24pt7b);
-    else
-      tft.setFont(&Satisfy_Regular18pt7b);
-    tft.getTextBounds(new_display_data_.date_str, 0, 0, &date_gap_x, &date_gap_y, &date_w, &date_h);
+    const GFXfont* date_font = (rtc->hour() >= 10 ? &Satisfy_Regular24pt7b : &Satisfy_Regular18pt7b);
+    TextBounds(date_font, new_display_data_.date_str, 0, 0, &date_gap_x, &date_gap_y, &date_w, &date_h);
     
     int16_t date_x0 = GAP_BAND - date_gap_x;
     int16_t alarm_icon_w = (new_display_data_.alarm_ON ? kBellSmallWidth : kBellFallenSmallWidth);
@@ -1085,8 +1320,8 @@ void RGBDisplay::Screensaver() {
     tft_HHMM_x0_ = (screensaver_w_ - tft_HHMM_w_) / 2 - gap_right_x_;
     date_x0 = (screensaver_w_ - date_row_w) / 2 - date_gap_x;
     
-    // create canvas
-    my_canvas_ = new GFXcanvas1(screensaver_w_, screensaver_h_);
+    // borrow canvas from arena
+    BorrowCanvas(screensaver_w_, screensaver_h_);
 
     my_canvas_->setTextWrap(false);
     my_canvas_->fillScreen(kDisplayBackroundColor);
@@ -1102,7 +1337,7 @@ void RGBDisplay::Screensaver() {
     my_canvas_->setFont(&ComingSoon_Regular70pt7b);
     my_canvas_->setTextColor(randomColor);
     my_canvas_->setCursor(tft_HHMM_x0_ + GAP_BAND, GAP_BAND - gap_up_y_);
-    my_canvas_->print(new_display_data_.time_HHMM);
+    screensaver_time_atlas_.Print(my_canvas_, new_display_data_.time_HHMM, randomColor);
 
     // print date string
     if(rtc->hour() >= 10)
@@ -1128,7 +1363,8 @@ void RGBDisplay::Screensaver() {
     // get visual bounds of created canvas and time string
     // myCanvas->drawRect(tft_HHMM_x0 + GAP_BAND, GAP_BAND, tft_HHMM_w, tft_HHMM_h, Display_Color_Green);  // time border
     // myCanvas->drawRect(date_x0 + GAP_BAND, screensaver_h + date_gap_y - 2 * GAP_BAND, date_row_w, date_h, Display_Color_Cyan);  // date row border
-    if(show_colored_edge_screensaver_)
+    screensaver_canvas_has_edge_ = show_colored_edge_screensaver_;
+    if(screensaver_canvas_has_edge_)
       my_canvas_->drawRect(0,0, screensaver_w_, screensaver_h_, kDisplayColorWhite);  // canvas border
 
     if(rtc->year() < 2024) {
@@ -1138,6 +1374,9 @@ void RGBDisplay::Screensaver() {
     // stop refreshing canvas until time change or if it hits top or bottom screen edges
     refresh_screensaver_canvas_ = false;
 
+    // new canvas and color, next paste is a full blit
+    screensaver_on_screen_ = false;
+
     #ifdef MORE_LOGS
     if(debug_mode) {
       unsigned long time1 = timer1;
@@ -1148,8 +1387,9 @@ void RGBDisplay::Screensaver() {
   }
   else {
 
-    // move the time text on screen
-    const int16_t adder = 1;
+    // move the time text on screen, whole pixels owed at kScreensaverSpeedPxPerSec
+    // no further than the bg margin per frame, and 1 px with the colored edge so its trail stays solid
+    const int16_t adder = screensaver_step_.Take(screensaver_canvas_has_edge_ ? 1 : GAP_BAND);
     screensaver_x1_ += (screensaver_move_right_ ? adder : -adder);
     screensaver_y1_ += (screensaver_move_down_ ? adder : -adder);
 
@@ -1191,12 +1431,93 @@ void RGBDisplay::Screensaver() {
   }
 
   // paste the canvas on screen
+  PROFILE_RENDER(kRenderScreensaverBlit);
   // tft.drawRGBBitmap(screensaver_x1, screensaver_y1, myCanvas->getBuffer(), screensaver_w, screensaver_h); // Copy to screen
   // tft.drawBitmap(screensaver_x1, screensaver_y1, myCanvas->getBuffer(), screensaver_w, screensaver_h, colorPickerWheelBright[currentRandomColorIndex], Display_Backround_Color); // Copy to screen
-  FastDrawTwoColorBitmapSpi(screensaver_x1_, screensaver_y1_, my_canvas_->getBuffer(), screensaver_w_, screensaver_h_, kColorPickerWheel[current_random_color_index_], kDisplayBackroundColor);
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  if(!screensaver_bounce_not_fly_horizontally_ && screensaver_hw_scroll_ && !screensaver_canvas_has_edge_) {
+    // fly through: canvas stays put in panel memory and the controller scroll offset moves it horizontally
+    // not with the colored edge, its trail is made of full blits at every screen x
+    HwScrollPaste();
+  }
+  else {
+    StopHwScroll();
+  #endif
+  ScreensaverPaste::Kind paste = screensaver_paste_.Next(screensaver_motion_blit_, screensaver_on_screen_, {screensaver_x1_, screensaver_y1_, (int16_t)screensaver_w_, (int16_t)screensaver_h_}, kMotionBlitMaxStep, screensaver_canvas_has_edge_);
+  if(paste == ScreensaverPaste::kClearThenFullBlit)
+    tft.fillScreen(kDisplayBackroundColor);
+  if(paste == ScreensaverPaste::kMotionBlit)
+    FastDrawTwoColorBitmapMotionSpi(screensaver_x1_, screensaver_y1_, screensaver_prev_x1_, screensaver_prev_y1_, my_canvas_->getBuffer(), screensaver_w_, screensaver_h_, kColorPickerWheel[current_random_color_index_], kDisplayBackroundColor);
+  else
+    FastDrawTwoColorBitmapSpi(screensaver_x1_, screensaver_y1_, my_canvas_->getBuffer(), screensaver_w_, screensaver_h_, kColorPickerWheel[current_random_color_index_], kDisplayBackroundColor);
+  // parts of the previous canvas the new one does not cover
+  for (uint8_t i = 0; i < screensaver_paste_.stale_count(); i++) {
+    const ScreensaverPaste::Rect& stale = screensaver_paste_.stale(i);
+    tft.fillRect(stale.x, stale.y, stale.w, stale.h, kDisplayBackroundColor);
+  }
+  #ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+  }
+  #endif
+  screensaver_prev_x1_ = screensaver_x1_;
+  screensaver_prev_y1_ = screensaver_y1_;
+  screensaver_on_screen_ = true;
   // // color LED Strip sequentially   ->   now done in loop1() by second core
 }
 
+#ifdef DISPLAY_HAS_HW_VERTICAL_SCROLL
+// Fly through screensaver paste with the controller scroll offset. Panel memory is a ring kTftWidth wide and all of
+// it is on screen, so only the canvas columns a plain blit at screensaver_x1_ would show are kept in memory, at
+// hw_scroll_canvas_x_ + column. The clock still flies off the right edge, stays off screen for the gap and comes
+// back from the left, same as without hw scroll. Columns scrolling out are erased, columns scrolling in are drawn
+// and the vertical bounce of the ones in between is a motion blit.
+void RGBDisplay::HwScrollPaste() {
+  int8_t direction = HwScrollDirection();
+  int16_t col0, col1;
+  HwScroll::VisibleColumns(screensaver_x1_, screensaver_w_, kTftWidth, &col0, &col1);
+  if(!hw_scroll_active_) {
+    // panel has whatever the other pastes left, start from bg at offset 0
+    tft.fillScreen(kDisplayBackroundColor);
+    screensaver_paste_.PanelCleared();
+    hw_scroll_col0_ = hw_scroll_col1_ = 0;
+  }
+  if(!screensaver_on_screen_ || !hw_scroll_active_) {
+    // new canvas: erase the old one, then draw this one where the current offset shows it at screensaver_x1_
+    HwScrollColumns(hw_scroll_col0_, hw_scroll_col1_, hw_scroll_canvas_y_, true);
+    hw_scroll_canvas_x_ = HwScroll::MemoryX(screensaver_x1_, hw_scroll_offset_, direction, kTftWidth);
+    hw_scroll_canvas_h_ = screensaver_h_;
+    HwScrollColumns(col0, col1, screensaver_y1_, false);
+  }
+  else {
+    HwScroll::Plan plan = HwScroll::ColumnPlan(hw_scroll_col0_, hw_scroll_col1_, col0, col1);
+    for (uint8_t i = 0; i < plan.erase_count; i++)
+      HwScrollColumns(plan.erase[i][0], plan.erase[i][1], hw_scroll_canvas_y_, true);
+    if(plan.keep[0] < plan.keep[1] && screensaver_y1_ != hw_scroll_canvas_y_) {
+      // vertical bounce, a motion blit in memory coordinates at both ring copies
+      for (int16_t memory_x = hw_scroll_canvas_x_; memory_x > -kTftWidth; memory_x -= kTftWidth)
+        FastDrawTwoColorBitmapMotionSpi(memory_x, screensaver_y1_, memory_x, hw_scroll_canvas_y_, my_canvas_->getBuffer(), screensaver_w_, screensaver_h_, kColorPickerWheel[current_random_color_index_], kDisplayBackroundColor, plan.keep[0], plan.keep[1]);
+    }
+    for (uint8_t i = 0; i < plan.draw_count; i++)
+      HwScrollColumns(plan.draw[i][0], plan.draw[i][1], screensaver_y1_, false);
+  }
+  hw_scroll_col0_ = col0;
+  hw_scroll_col1_ = col1;
+  hw_scroll_canvas_y_ = screensaver_y1_;
+  SetHwScroll(HwScroll::Offset(screensaver_x1_, hw_scroll_canvas_x_, direction, kTftWidth));
+}
+
+// draw or erase canvas columns [col0, col1) at row y of panel memory, split where they wrap around the ring
+void RGBDisplay::HwScrollColumns(int16_t col0, int16_t col1, int16_t y, bool erase) {
+  if(col0 >= col1)
+    return;
+  for (int16_t memory_x = hw_scroll_canvas_x_; memory_x > -kTftWidth; memory_x -= kTftWidth) {
+    if(erase)
+      tft.fillRect(memory_x + col0, y, col1 - col0, hw_scroll_canvas_h_, kDisplayBackroundColor);
+    else
+      FastDrawTwoColorBitmapSpi(memory_x, y, my_canvas_->getBuffer(), screensaver_w_, screensaver_h_, kColorPickerWheel[current_random_color_index_], kDisplayBackroundColor, col0, col1);
+  }
+}
+#endif
+
 void RGBDisplay::PickNewRandomColor() {
   int newIndex = current_random_color_index_;
   while(newIndex == current_random_color_index_)
@@ -1208,6 +1529,7 @@ void RGBDisplay::PickNewRandomColor() {
 }
 
 void RGBDisplay::DisplayTimeUpdate() {
+  PROFILE_RENDER(kRenderTimeUpdate);
 
   bool isThisTheFirstTime = strcmp(displayed_data_.time_SS, "") == 0;
   if(redraw_display_) {
@@ -1221,24 +1543,32 @@ void RGBDisplay::DisplayTimeUpdate() {
 
   if(1) {   // CODE USES CANVAS AND ALWAYS PUTS HH:MM:SS AmPm on it every second
 
-    // delete canvas if it exists
-    if(my_canvas_ != NULL) {
-      delete my_canvas_;
-      my_canvas_ = NULL;
-      // myCanvas.reset(nullptr);
-    }
+    // return canvas to arena if it is borrowed
+    ReturnCanvas();
 
     // create new canvas for time row
     if(rtc->year() < 2024)  { // incorrect time
-      my_canvas_ = new GFXcanvas1(kTftWidth, kTimeRowY0IncorrectTime);
+      BorrowCanvas(kTftWidth, kTimeRowY0IncorrectTime);
 
       IncorrectTimeBanner();
 
       // draw canvas to tft   fastDrawBitmap
       FastDrawTwoColorBitmapSpi(0, 0, my_canvas_->getBuffer(), kTftWidth, kTimeRowY0IncorrectTime, kDisplayTimeColor, kDisplayBackroundColor); // Copy to screen
+      time_row_on_screen_ = false;
     }
     else {
-      my_canvas_ = new GFXcanvas1(kTftWidth, kTimeRowY0 + 6);
+      int16_t hh_x0 = kTimeRowX0 + hh_gap_x;
+
+      // only redraw the time row pixel columns that can change, a seconds tick is just the changed seconds digits
+      int16_t dirty_x0 = 0, dirty_x1 = kTftWidth - 1;
+      if(time_row_dirty_regions_only_ && time_row_on_screen_ && !isThisTheFirstTime) {
+        if(!TimeRowDirtyColumns(hh_x0, &dirty_x0, &dirty_x1))
+          // same pixels as on screen, send one column rather than skip the bookkeeping below
+          dirty_x1 = dirty_x0 = hh_x0;
+      }
+      int16_t canvas_w = dirty_x1 - dirty_x0 + 1;
+
+      BorrowCanvas(canvas_w, kTimeRowY0 + 6);
       my_canvas_->fillScreen(kDisplayBackroundColor);
       my_canvas_->setTextWrap(false);
 
@@ -1247,14 +1577,14 @@ void RGBDisplay::DisplayTimeUpdate() {
       // set font
       my_canvas_->setFont(&FreeSansBold48pt7b);
 
-      // home the cursor
-      my_canvas_->setCursor(kTimeRowX0 + hh_gap_x, kTimeRowY0);
+      // home the cursor (canvas starts at dirty_x0)
+      my_canvas_->setCursor(hh_x0 - dirty_x0, kTimeRowY0);
 
       // change the text color to foreground color
       my_canvas_->setTextColor(kDisplayTimeColor);
 
       // draw the new time value
-      my_canvas_->print(new_display_data_.time_HHMM);
+      main_time_atlas_.Print(my_canvas_, new_display_data_.time_HHMM, kDisplayTimeColor);
       // tft.setTextSize(1);
       // delay(2000);
 
@@ -1300,13 +1630,15 @@ void RGBDisplay::DisplayTimeUpdate() {
       strcpy(displayed_data_.time_SS, new_display_data_.time_SS);
 
       // draw canvas to tft   fastDrawBitmap
-      FastDrawTwoColorBitmapSpi(0, 0, my_canvas_->getBuffer(), kTftWidth, kTimeRowY0 + 6, kDisplayTimeColor, kDisplayBackroundColor); // Copy to screen
+      FastDrawTwoColorBitmapSpi(dirty_x0, 0, my_canvas_->getBuffer(), canvas_w, kTimeRowY0 + 6, kDisplayTimeColor, kDisplayBackroundColor); // Copy to screen
+
+      // remember where HH:MM is on screen for next dirty region calculation
+      time_row_hh_x0_ = hh_x0;
+      time_row_on_screen_ = true;
     }
 
-    // delete created canvas and null the pointer
-    delete my_canvas_;
-    my_canvas_ = NULL;
-    // myCanvas.reset(nullptr);
+    // return canvas to arena
+    ReturnCanvas();
 
   }
   else {    // CODE THAT CHECKS AND UPDATES ONLY CHANGES ON SCREEN HH:MM :SS AmPm
@@ -1345,7 +1677,7 @@ void RGBDisplay::DisplayTimeUpdate() {
       }
 
       // get bounds of new HH:MM string on tft display (with background color as this causes a blink)
-      tft.getTextBounds(new_display_data_.time_HHMM, 0, 0, &gap_right_x_, &gap_up_y_, &tft_HHMM_w_, &tft_HHMM_h_);
+      TextBounds(&FreeSansBold48pt7b, new_display_data_.time_HHMM, 0, 0, &gap_right_x_, &gap_up_y_, &tft_HHMM_w_, &tft_HHMM_h_);
       // Serial.print("gap_right_x "); Serial.print(gap_right_x); Serial.print(" gap_up_y "); Serial.print(gap_up_y); Serial.print(" w "); Serial.print(tft_HHMM_w); Serial.print(" h "); Serial.println(tft_HHMM_h); 
 
       // home the cursor
@@ -1400,7 +1732,7 @@ void RGBDisplay::DisplayTimeUpdate() {
         // get bounds of new AM/PM string on tft display (with background color as this causes a blink)
         int16_t tft_AmPm_x1, tft_AmPm_y1;
         uint16_t tft_AmPm_w, tft_AmPm_h;
-        tft.getTextBounds((new_display_data_.pm_not_am ? kPmLabel : kAmLabel), tft.getCursorX(), tft.getCursorY(), &tft_AmPm_x1, &tft_AmPm_y1, &tft_AmPm_w, &tft_AmPm_h);
+        TextBounds(&FreeSans18pt7b, (new_display_data_.pm_not_am ? kPmLabel : kAmLabel), tft.getCursorX(), tft.getCursorY(), &tft_AmPm_x1, &tft_AmPm_y1, &tft_AmPm_w, &tft_AmPm_h);
         // Serial.print("AmPm_x1 "); Serial.print(tft_AmPm_x1); Serial.print(" y1 "); Serial.print(tft_AmPm_y1); Serial.print(" w "); Serial.print(tft_AmPm_w); Serial.print(" h "); Serial.println(tft_AmPm_h); 
 
         // calculate tft_AmPm_y0 to align top with HH:MM
@@ -1468,7 +1800,7 @@ void RGBDisplay::DisplayTimeUpdate() {
       // if time is incorrect then don't bother drawing date row
 
       // draw settings gear
-      tft.drawBitmap(kSettingsGearX1, kSettingsGearY1, kSettingsGearBitmap, kSettingsGearWidth, kSettingsGearHeight, RGB565_Sandy_brown); // Copy to screen
+      DrawBitmapSpans(kSettingsGearX1, kSettingsGearY1, kSettingsGearBitmap, kSettingsGearWidth, kSettingsGearHeight, RGB565_Sandy_brown); // Copy to screen
     }
     else {
       // set font
@@ -1493,7 +1825,7 @@ void RGBDisplay::DisplayTimeUpdate() {
       int16_t date_row_y1;
       uint16_t date_row_w, date_row_h;
       // get bounds of new dateStr on tft display (with background color as this causes a blink)
-      tft.getTextBounds(new_display_data_.date_str, tft.getCursorX(), tft.getCursorY(), &date_row_x0_, &date_row_y1, &date_row_w, &date_row_h);
+      TextBounds(&Satisfy_Regular24pt7b, new_display_data_.date_str, tft.getCursorX(), tft.getCursorY(), &date_row_x0_, &date_row_y1, &date_row_w, &date_row_h);
       date_row_x0_ = (kSettingsGearX1 - date_row_w) / 2;
 
       // home the cursor
@@ -1506,7 +1838,7 @@ void RGBDisplay::DisplayTimeUpdate() {
       tft.print(new_display_data_.date_str);
 
       // draw settings gear
-      tft.drawBitmap(kSettingsGearX1, kSettingsGearY1, kSettingsGearBitmap, kSettingsGearWidth, kSettingsGearHeight, RGB565_Sandy_brown); // Copy to screen
+      DrawBitmapSpans(kSettingsGearX1, kSettingsGearY1, kSettingsGearBitmap, kSettingsGearWidth, kSettingsGearHeight, RGB565_Sandy_brown); // Copy to screen
 
       // and remember the new value
       strcpy(displayed_data_.date_str, new_display_data_.date_str);
@@ -1541,7 +1873,7 @@ void RGBDisplay::DisplayTimeUpdate() {
       }
 
       // erase bell
-      tft.drawBitmap(alarm_icon_x0_, alarm_icon_y0_, (displayed_data_.alarm_ON ? kBellBitmap : kBellFallenBitmap), alarm_icon_w, alarm_icon_h, kDisplayBackroundColor);
+      DrawBitmapSpans(alarm_icon_x0_, alarm_icon_y0_, (displayed_data_.alarm_ON ? kBellBitmap : kBellFallenBitmap), alarm_icon_w, alarm_icon_h, kDisplayBackroundColor);
     }
 
     //  Redraw new alarm data
@@ -1566,7 +1898,7 @@ void RGBDisplay::DisplayTimeUpdate() {
     int16_t alarm_row_y1;
     uint16_t alarm_row_w, alarm_row_h;
     // get bounds of new alarmStr on tft display (with background color as this causes a blink)
-    tft.getTextBounds(new_display_data_.alarm_str, tft.getCursorX(), tft.getCursorY(), &alarm_row_x0_, &alarm_row_y1, &alarm_row_w, &alarm_row_h);
+    TextBounds(&Satisfy_Regular24pt7b, new_display_data_.alarm_str, tft.getCursorX(), tft.getCursorY(), &alarm_row_x0_, &alarm_row_y1, &alarm_row_w, &alarm_row_h);
     uint16_t graphic_width = alarm_icon_w + alarm_row_w;
     // three equal length gaps on left center and right of graphic
     uint16_t equal_gaps = (kTftWidth - graphic_width) / 3;
@@ -1585,7 +1917,7 @@ void RGBDisplay::DisplayTimeUpdate() {
     tft.print(new_display_data_.alarm_str);
 
     // draw bell
-    tft.drawBitmap(alarm_icon_x0_, alarm_icon_y0_, (new_display_data_.alarm_ON ? kBellBitmap : kBellFallenBitmap), alarm_icon_w, alarm_icon_h, kDisplayAlarmColor);
+    DrawBitmapSpans(alarm_icon_x0_, alarm_icon_y0_, (new_display_data_.alarm_ON ? kBellBitmap : kBellFallenBitmap), alarm_icon_w, alarm_icon_h, kDisplayAlarmColor);
 
     // and remember the new value
     strcpy(displayed_data_.alarm_str, new_display_data_.alarm_str);
@@ -1612,6 +1944,15 @@ void RGBDisplay::DisplayTimeUpdate() {
   redraw_display_ = false;
 }
 
+// time row pixel columns that can differ between displayed_data_ and new_display_data_, false if none can
+bool RGBDisplay::TimeRowDirtyColumns(int16_t hh_x0, int16_t* x0, int16_t* x1) {
+  TimeRowLayout::Row new_row = {new_display_data_.time_HHMM, new_display_data_.time_SS,
+      (new_display_data_._12_hour_mode ? (new_display_data_.pm_not_am ? kPmLabel : kAmLabel) : NULL), hh_x0};
+  TimeRowLayout::Row old_row = {displayed_data_.time_HHMM, displayed_data_.time_SS,
+      (displayed_data_._12_hour_mode ? (displayed_data_.pm_not_am ? kPmLabel : kAmLabel) : NULL), time_row_hh_x0_};
+  return time_row_layout_.DirtyColumns(new_row, old_row, x0, x1);
+}
+
 void RGBDisplay::IncorrectTimeBanner() {
   // RTC Time is not Set!
   my_canvas_->fillRect(0, 0, kTftWidth, kTimeRowY0IncorrectTime, kDisplayBackroundColor);
@@ -1715,10 +2056,9 @@ void RGBDisplay::DrawSun(int16_t x0, int16_t y0, uint16_t edge, int &tone_note_i
   int16_t smile_cy = cy - sr / 2;
   int16_t smile_r = sr * 1.1, smile_w = max(sr / 15, 3);
   for(uint8_t i = 0; i <= smile_angle_deg; i=i+2) {
-    float smile_angle_rad = DEG_TO_RAD * i;
     int16_t smile_tapered_w = max(smile_w - i / 13, 1);
     // Serial.print(i); Serial.print(" "); Serial.print(smile_w); Serial.print(" "); Serial.println(smile_tapered_w);
-    int16_t smile_offset_x = smile_r * sin(smile_angle_rad), smile_offset_y = smile_r * cos(smile_angle_rad);
+    int16_t smile_offset_x = ((int32_t)smile_r * SunDrawing::SinQ15(i)) >> 15, smile_offset_y = ((int32_t)smile_r * SunDrawing::CosQ15(i)) >> 15;
     tft.fillCircle(cx - smile_offset_x, smile_cy + smile_offset_y, smile_tapered_w, background);
     tft.fillCircle(cx + smile_offset_x, smile_cy + smile_offset_y, smile_tapered_w, background);
   }
@@ -1734,19 +2074,17 @@ void RGBDisplay::DrawSun(int16_t x0, int16_t y0, uint16_t edge, int &tone_note_i
     int16_t r_variable = rr + variation;
     // draw rays
     DrawRays(cx, cy, r_variable, rl, rw, rn, i, color);
-    // increase sun size
-    // tft.drawCircle(cx, cy, sr + variation, color);
-    DrawDenseCircle(cx, cy, sr + variation, color);
+    // increase sun size, only the new outer ring
+    if(variation > variation_prev)
+      SunDrawing::DrawRing(tft, cx, cy, sr + variation_prev + 1, sr + variation, color);
     // show for sometime
     delay(30);
 
     // undraw rays
     DrawRays(cx, cy, r_variable, rl, rw, rn, i, background);
-    // reduce sun size
-    if(variation < variation_prev){
-      // tft.drawCircle(cx, cy, sr + variation_prev, background);
-      DrawDenseCircle(cx, cy, sr + variation_prev + 1, background);
-    }
+    // reduce sun size, only the ring that is now outside the sun
+    if(variation < variation_prev)
+      SunDrawing::DrawRing(tft, cx, cy, sr + variation + 1, sr + variation_prev + 1, background);
     // delay(1000);
     variation_prev = variation;
 
@@ -1764,47 +2102,18 @@ void RGBDisplay::DrawRays(int16_t &cx, int16_t &cy, int16_t &rr, int16_t &rl, in
   // rays
   for(uint8_t i = 0; i < rn; i++) {
     // find coordinates of two triangles for each ray and use fillTriangle function to draw rays
-    float theta = 2 * PI * i / rn + degStart * DEG_TO_RAD;
-    double rcos = rr * cos(theta), rlcos = (rr + rl) * cos(theta), rsin = rr * sin(theta), rlsin = (rr + rl) * sin(theta);
-    double w2sin = rw / 2 * sin(theta), w2cos = rw / 2 * cos(theta);
-    int16_t x1 = cx + rcos - w2sin;
-    int16_t x2 = cx + rcos + w2sin;
-    int16_t x3 = cx + rlcos + w2sin;
-    int16_t x4 = cx + rlcos - w2sin;
-    int16_t y1 = cy + rsin + w2cos;
-    int16_t y2 = cy + rsin - w2cos;
-    int16_t y3 = cy + rlsin - w2cos;
-    int16_t y4 = cy + rlsin + w2cos;
-    tft.fillTriangle(x1, y1, x2, y2, x3, y3, color);
-    tft.fillTriangle(x1, y1, x3, y3, x4, y4, color);
-  }
-}
-
-/* drawDenseCircle
- * densely pack a circle's circumference
- */
-void RGBDisplay::DrawDenseCircle(int16_t &cx, int16_t &cy, int16_t r, uint16_t &color) {
-  // calculate angular resolution required
-  // r*dTheta = 0.5
-  double dTheta = 0.5 / static_cast<double>(r);
-  // number of runs to cover quarter circle
-  uint32_t n = PI / 2 / dTheta;
-  // Serial.print("dTheta "); Serial.print(dTheta, 5); Serial.print(" n "); Serial.println(n);
-
-  for(uint32_t i = 0; i < n; i++) {
-    float theta = i * dTheta; // Serial.print(" theta "); Serial.println(theta);
-    int16_t rcos = r * cos(theta);
-    int16_t rsin = r * sin(theta);
-    tft.drawPixel(cx + rcos, cy + rsin, color);
-    tft.drawPixel(cx - rcos, cy + rsin, color);
-    tft.drawPixel(cx + rcos, cy - rsin, color);
-    tft.drawPixel(cx - rcos, cy - rsin, color);
+    // Q15 sin and cos of ray angle, integer math only
+    int16_t x[4], y[4];
+    SunDrawing::RayQuad(cx, cy, rr, rl, rw, 360 * i / rn + degStart, x, y);
+    tft.fillTriangle(x[0], y[0], x[1], y[1], x[2], y[2], color);
+    tft.fillTriangle(x[0], y[0], x[2], y[2], x[3], y[3], color);
   }
 }
 
 // make keyboard on screen
 // credits: Andrew Mascolo https://github.com/AndrewMascolo/Adafruit_Stuff/blob/master/Sketches/Keyboard.ino
 void RGBDisplay::MakeKeyboard(const char type[][13], std::string label) {
+  PROFILE_RENDER(kRenderKeyboard);
   // heading label
   tft.setTextSize(1);
   tft.setFont(&FreeMono9pt7b);
@@ -2120,6 +2429,7 @@ bool RGBDisplay::GetKeyboardPress(char * textBuffer, std::string label, char * t
 bool RGBDisplay::GetUserOnScreenTextInput(std::string label, char* return_text, bool numbers_only, bool capitals_only) {
   bool ret = false;
 
+  InvalidateRetainedPage();
   tft.fillScreen(kDisplayBackroundColor);
   tft.setFont(NULL);
 
@@ -1,6 +1,7 @@
 #include "lwipopts.h"
 #include "uRTCLib.h"
 #include "rtc.h"
+#include "nvs_preferences.h"
 
 // RTC constructor
 RTC::RTC() {
@@ -9,6 +10,9 @@ RTC::RTC() {
 
   // initialize Wire lib
   URTCLIB_WIRE.begin(SDA_PIN, SCL_PIN);
+
+  // timezone rules, before RTC HW time is read so DST state is worked out from the first read
+  SetTimezone(nvs_preferences->RetrieveTimezone());
   
   // setup DS3231 rtc
   Ds3231RtcSetup();
@@ -87,7 +91,7 @@ void RTC::Ds3231RtcSetup() {
 
   // set rtcHw in 12 hour mode if not already
   if(rtc_hw_.hourModeAndAmPm() == 0) {
-    rtc_hw_.set_12hour_mode(true);
+    set_12hour_mode(true);
     delay(100);
   }
 
@@ -119,7 +123,8 @@ void RTC::Ds3231RtcSetup() {
 
   // seconds interrupt pin
   pinMode(SQW_INT_PIN, INPUT_PULLUP);
-  attachInterrupt(digitalPinToInterrupt(SQW_INT_PIN), SecondsUpdateInterruptISR, RISING);
+  // writing seconds restarts the DS3231 countdown chain, SQW then goes high 500 ms later and falls with each seconds increment
+  attachInterrupt(digitalPinToInterrupt(SQW_INT_PIN), SecondsUpdateInterruptISR, FALLING);
 
 }
 
@@ -127,15 +132,13 @@ void RTC::Ds3231RtcSetup() {
 void RTC::Refresh() {
 
   // refresh time in class object from RTC HW
-  rtc_hw_.refresh();
-  rtc_refresh_reqd_ = false;
-
-  // make _second equal to rtcHw seconds -> should be 0
-  second_ = rtc_hw_.second();
+  SetClock(ReadHw());
+  twelve_hour_mode_ = (rtc_hw_.hourModeAndAmPm() != 0);
 
   // PrintLn("__RTC Refresh__ ");
 
   SetTodaysMinutes();
+  UpdateUtcOffset();
 
   #ifdef MORE_LOGS
   // Check whether RTC HW experienced a power loss and thereby know if time is up to date or not
@@ -148,30 +151,130 @@ void RTC::Refresh() {
 
 }
 
+ClockTime RTC::ReadHw() {
+  rtc_hw_.refresh();
+  ClockTime time;
+  time.year = rtc_hw_.year() + 2000;
+  time.month = rtc_hw_.month();
+  time.day = rtc_hw_.day();
+  time.day_of_week = rtc_hw_.dayOfWeek();
+  // RTC HW hour is 1 - 12 in 12 hour mode
+  uint8_t hour_mode_and_am_pm = rtc_hw_.hourModeAndAmPm();
+  time.hour = rtc_hw_.hour();
+  if(hour_mode_and_am_pm != 0)
+    time.hour = time.hour % 12 + (hour_mode_and_am_pm == 2 ? 12 : 0);
+  time.minute = rtc_hw_.minute();
+  time.second = rtc_hw_.second();
+  return time;
+}
+
+void RTC::SetClock(const ClockTime& time) {
+  portENTER_CRITICAL(&clock_mux_);
+  WriteClock(time);
+  portEXIT_CRITICAL(&clock_mux_);
+}
+
+void RTC::WriteClock(const ClockTime& time) {
+  clock_seq_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  clock_ = time;
+  clock_seq_.fetch_add(1, std::memory_order_release);
+}
+
+// seqlock read: retry if a writer was in the middle of an update
+ClockTime RTC::Now() {
+  ClockTime time;
+  uint32_t seq_start, seq_end;
+  do {
+    seq_start = clock_seq_.load(std::memory_order_acquire);
+    time = clock_;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    seq_end = clock_seq_.load(std::memory_order_relaxed);
+  } while((seq_start & 1) || seq_start != seq_end);
+  return time;
+}
+
 // clock seconds interrupt ISR
 void IRAM_ATTR RTC::SecondsUpdateInterruptISR() {
-  // update seconds
-  second_++;
-  // a flag for others that time has updated!
-  rtc_hw_sec_update_ = true;
-
-  // refresh time on rtc class object on new minute
-  if(second_ >= 60) {
-    rtc_hw_min_update_ = true;
-    rtc_refresh_reqd_ = true;
-  }
+  // advance software clock a second
+  portENTER_CRITICAL_ISR(&clock_mux_);
+  clock_seq_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bool new_minute = clock_.Tick();
+  uint8_t minute = clock_.minute;
+  clock_seq_.fetch_add(1, std::memory_order_release);
+  portEXIT_CRITICAL_ISR(&clock_mux_);
+
+  // let loop know time has updated
+  sqw_events_.Push({micros(), new_minute, minute});
 }
 
-uint8_t RTC::minute() {
-  if(rtc_refresh_reqd_)
-    Refresh();
-  return rtc_hw_.minute();
+// oldest SQW tick not handled yet, false when loop is caught up
+bool RTC::NextSqwEvent(SqwEvent* event) {
+  if(!sqw_events_.Pop(event))
+    return false;
+  unsigned long lag_us = micros() - event->micros;
+  if(lag_us > sqw_event_lag_max_us_)
+    sqw_event_lag_max_us_ = lag_us;
+
+  if(event->new_minute) {
+    // once an hour check software clock against RTC HW, keyed on the tick's minute: a drain that runs late must
+    // not skip the hour
+    if(event->new_hour()) {
+      ClockTime now = Now();
+      ClockTime hw = ReadHw();
+      if(!hw.SameDate(now) || hw.SecondsOfDay() != now.SecondsOfDay()) {
+        int32_t diff = (int32_t)hw.SecondsOfDay() - (int32_t)now.SecondsOfDay();
+        if(hw.SameDate(now) && (diff == 1 || diff == -1))
+          clock_drift_count_++;
+        else
+          clock_mismatch_count_++;
+        #ifdef MORE_LOGS
+        PrintLn("Software clock off from RTC HW by seconds: ", (int)diff);
+        #endif
+        SetClock(hw);
+      }
+    }
+    SetTodaysMinutes();
+  }
+
+  // DST change: step the clock at the second it falls on, no NTP round trip needed. Offsets differ by whole minutes,
+  // so the seconds keep running: rewriting them would restart the RTC HW countdown and lose the SetTimeAtSecond alignment
+  bool dst_step = false;
+  int32_t offset_after = 0;
+  ClockTime stepped;
+  portENTER_CRITICAL(&clock_mux_);
+  if(next_transition_utc_ != 0) {
+    int64_t utc = LocalEpoch(clock_) - utc_offset_sec_;
+    if(utc >= next_transition_utc_) {
+      stepped = FromLocalEpoch(utc + next_offset_sec_);
+      stepped.second = clock_.second;
+      WriteClock(stepped);
+      utc_offset_sec_ = offset_after = next_offset_sec_;
+      UpdateNextTransition(utc);
+      dst_step = true;
+    }
+  }
+  portEXIT_CRITICAL(&clock_mux_);
+  if(dst_step) {
+    SetHwMinuteHourDate(stepped);
+    SetTodaysMinutes();
+    PrintLn("DST change, UTC offset seconds: ", (int)offset_after);
+  }
+  return true;
 }
 
 uint8_t RTC::hour() {
-  if(rtc_refresh_reqd_)
-    Refresh();
-  return rtc_hw_.hour();
+  uint8_t hour_24 = Now().hour;
+  if(!twelve_hour_mode_)
+    return hour_24;
+  return (hour_24 % 12 == 0 ? 12 : hour_24 % 12);
+}
+
+uint8_t RTC::hourModeAndAmPm() {
+  if(!twelve_hour_mode_)
+    return 0;
+  return (Now().hour < 12 ? 1 : 2);
 }
 
 /**
@@ -187,6 +290,10 @@ uint8_t RTC::hour() {
  */
 void RTC::SetRtcTimeAndDate(uint8_t second, uint8_t minute, uint8_t hour_24_hr_mode, uint8_t dayOfWeek_Sun_is_1, uint8_t day, uint8_t month_Jan_is_1, uint16_t year) {
   // set RTC HW into 24 hour mode
+  // Set current time and date
+  // RTCLib::set(byte second, byte minute, byte hour, byte dayOfWeek, byte dayOfMonth, byte month, byte year)
+  rtc_hw_.set(second, minute, hour_24_hr_mode, dayOfWeek_Sun_is_1, day, month_Jan_is_1, year - 2000);
+  // logs after the write so they do not delay it
   #ifdef MORE_LOGS
   PrintLn("Time Update Values:");
   PrintLn("hour_24_hr_mode: ", hour_24_hr_mode);
@@ -197,9 +304,6 @@ void RTC::SetRtcTimeAndDate(uint8_t second, uint8_t minute, uint8_t hour_24_hr_m
   PrintLn("month_Jan_is_1: ", month_Jan_is_1);
   PrintLn("year: ", year);
   #endif
-  // Set current time and date
-  // RTCLib::set(byte second, byte minute, byte hour, byte dayOfWeek, byte dayOfMonth, byte month, byte year)
-  rtc_hw_.set(second, minute, hour_24_hr_mode, dayOfWeek_Sun_is_1, day, month_Jan_is_1, year - 2000);
   // refresh time from RTC HW
   Refresh();
   // set RTC HW back into 12 hour mode
@@ -208,52 +312,126 @@ void RTC::SetRtcTimeAndDate(uint8_t second, uint8_t minute, uint8_t hour_24_hr_m
   Refresh();
 }
 
-void RTC::SetTodaysMinutes() {
-  uint16_t todays_minutes_temp = minute();
-  if(hourModeAndAmPm() == 0) {
-    // 24 hour mode
-    todays_minutes_temp += hour() * 60;
-  }
-  else {
-    // 12 hour mode
-    if(hour() != 12)
-      todays_minutes_temp += hour() * 60;
-    if(hourModeAndAmPm() == 2)
-      todays_minutes_temp += 12 * 60;
-  }
-  todays_minutes = todays_minutes_temp;
+void RTC::SetHwMinuteHourDate(const ClockTime& time) {
+  auto bcd = [](uint8_t v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); };
+  // DS3231 registers 0x01 - 0x06: minutes, hours, day of week, date, month / century, year
+  uint8_t hour_reg = bcd(time.hour);
+  if(twelve_hour_mode_)
+    hour_reg = 0x40 | (time.hour >= 12 ? 0x20 : 0) | bcd(time.hour % 12 == 0 ? 12 : time.hour % 12);
+  URTCLIB_WIRE.beginTransmission(URTCLIB_ADDRESS);
+  URTCLIB_WIRE.write(0x01);
+  URTCLIB_WIRE.write(bcd(time.minute));
+  URTCLIB_WIRE.write(hour_reg);
+  URTCLIB_WIRE.write(time.day_of_week);
+  URTCLIB_WIRE.write(bcd(time.day));
+  URTCLIB_WIRE.write(bcd(time.month));
+  URTCLIB_WIRE.write(bcd(time.year - 2000));
+  URTCLIB_WIRE.endTransmission();
 }
 
-void RTC::DaysMinutesToClockTime(uint16_t todays_minutes_val, uint8_t &hour_mode_and_am_pm, uint8_t &hr, uint8_t &min) {
-  if(todays_minutes_val >= 60 * 12) {
-    hour_mode_and_am_pm = 2;
-    todays_minutes_val -= 60 * 12;
-  }
-  else
-    hour_mode_and_am_pm = 1;
+bool RTC::SetTimezone(const std::string &posix_tz) {
+  PosixTz tz;
+  bool ok = tz.Parse(posix_tz.c_str());
+  portENTER_CRITICAL(&clock_mux_);
+  tz_ = tz;
+  portEXIT_CRITICAL(&clock_mux_);
+  PrintLn("Timezone: ", posix_tz);
+  if(!ok)
+    PrintLn("Timezone does not parse, using weather GMT offset!");
+  UpdateUtcOffset();
+  return ok;
+}
 
-  min = todays_minutes_val % 60;
+void RTC::SetTimeFromUtc(uint32_t utc) {
+  int32_t year;
+  uint8_t month, day, hour_24, minute, second, day_of_week_Sun_is_0;
+  portENTER_CRITICAL(&clock_mux_);
+  int32_t offset = tz_.OffsetAt(utc);
+  portEXIT_CRITICAL(&clock_mux_);
+  TimeMath::EpochToCivil(utc + offset, year, month, day, hour_24, minute, second, day_of_week_Sun_is_0);
+  SetRtcTimeAndDate(second, minute, hour_24, day_of_week_Sun_is_0 + 1, day, month, year);
+  // exact offset from UTC, not worked back from local time
+  portENTER_CRITICAL(&clock_mux_);
+  utc_offset_sec_ = offset;
+  UpdateNextTransition(utc);
+  portEXIT_CRITICAL(&clock_mux_);
+}
 
-  uint8_t hr_temp = todays_minutes_val / 60;
+bool RTC::timezone_valid() {
+  portENTER_CRITICAL(&clock_mux_);
+  bool valid = tz_.valid();
+  portEXIT_CRITICAL(&clock_mux_);
+  return valid;
+}
 
-  if(hr_temp == 0)
-    hr = 12;
-  else
-    hr = hr_temp;
+int32_t RTC::utc_offset_sec() {
+  portENTER_CRITICAL(&clock_mux_);
+  int32_t offset = utc_offset_sec_;
+  portEXIT_CRITICAL(&clock_mux_);
+  return offset;
 }
 
-uint16_t RTC::ClockTimeToDaysMinutes(uint8_t hour_mode_and_am_pm, uint8_t hr, uint8_t min) {
-  uint16_t todays_minutes_temp = min;
-  if(hour_mode_and_am_pm == 0) {
-    // 24 hour mode
-    todays_minutes_temp += hr * 60;
-  }
+int64_t RTC::next_transition_utc() {
+  portENTER_CRITICAL(&clock_mux_);
+  int64_t transition = next_transition_utc_;
+  portEXIT_CRITICAL(&clock_mux_);
+  return transition;
+}
+
+void RTC::SetTimeAtSecond(uint32_t utc, uint32_t at_micros) {
+  // wait for the whole UTC second so the seconds write lands on the boundary
+  const int32_t wait_us = (int32_t)(at_micros - micros());
+  if(wait_us > 2000)
+    delay((wait_us - 2000) / 1000);
+  while((int32_t)(at_micros - micros()) > 0) {}
+  SetTimeFromUtc(utc);
+  #ifdef MORE_LOGS
+  PrintLn("Set RTC at UTC second boundary, waited us: ", (int)wait_us);
+  #endif
+}
+
+int64_t RTC::LocalEpoch(const ClockTime& time) {
+  return (int64_t)TimeMath::DaysFromCivil(time.year, time.month, time.day) * TimeMath::kSecondsPerDay + time.SecondsOfDay();
+}
+
+ClockTime RTC::FromLocalEpoch(int64_t local) {
+  ClockTime time;
+  int32_t year;
+  uint8_t day_of_week_Sun_is_0;
+  TimeMath::EpochToCivil((uint32_t)local, year, time.month, time.day, time.hour, time.minute, time.second, day_of_week_Sun_is_0);
+  time.year = year;
+  time.day_of_week = day_of_week_Sun_is_0 + 1;
+  return time;
+}
+
+// local time to UTC needs the offset: guess standard time, then correct with the offset in effect at that guess
+void RTC::UpdateUtcOffset() {
+  portENTER_CRITICAL(&clock_mux_);
+  if(!tz_.valid())
+    next_transition_utc_ = 0;
   else {
-    // 12 hour mode
-    if(hr != 12)
-      todays_minutes_temp += hr * 60;
-    if(hour_mode_and_am_pm == 2)
-      todays_minutes_temp += 12 * 60;
+    int64_t local = LocalEpoch(clock_);
+    utc_offset_sec_ = tz_.OffsetAt(local - tz_.std_offset());
+    utc_offset_sec_ = tz_.OffsetAt(local - utc_offset_sec_);
+    UpdateNextTransition(local - utc_offset_sec_);
   }
-  return todays_minutes_temp;
+  portEXIT_CRITICAL(&clock_mux_);
+}
+
+void RTC::UpdateNextTransition(int64_t utc) {
+  if(!tz_.NextTransition(utc, &next_transition_utc_, &next_offset_sec_))
+    next_transition_utc_ = 0;
+}
+
+void RTC::SetTodaysMinutes() {
+  ClockTime now = Now();
+  todays_minutes = now.hour * 60 + now.minute;
+}
+
+void RTC::DaysMinutesToClockTime(uint16_t todays_minutes_val, uint8_t &hour_mode_and_am_pm, uint8_t &hr, uint8_t &min) {
+  TimeMath::DaysMinutesTo12Hour(todays_minutes_val, hour_mode_and_am_pm, hr, min);
+}
+
+uint16_t RTC::ClockTimeToDaysMinutes(uint8_t hour_mode_and_am_pm, uint8_t hr, uint8_t min) {
+  return TimeMath::ClockTimeToDaysMinutes(hour_mode_and_am_pm, hr, min);
 }
@@ -3,6 +3,11 @@
 
 #include "common.h"
 #include "uRTCLib.h"
+#include "isr_event_ring.h"
+#include "clock_time.h"
+#include "time_math.h"
+#include "posix_tz.h"
+#include <atomic>
 
 class RTC {
 
@@ -13,8 +18,17 @@ public:
   // setup DS3231 rtc
   void Ds3231RtcSetup();
 
-  static inline volatile bool rtc_hw_sec_update_ = false;     // seconds flag triggered by interrupt
-  static inline volatile bool rtc_hw_min_update_ = false;     // minutes change flag
+  // one event per SQW tick, queued by the interrupt and drained by loop before its once a second work
+  using SqwEvent = ClockTick;
+  bool NextSqwEvent(SqwEvent* event);
+
+  // ticks dropped because loop was blocked for longer than the ring holds
+  uint32_t sqw_event_overflows() { return sqw_events_.overflows(); }
+  // worst delay between a tick interrupt and loop handling it
+  unsigned long sqw_event_lag_max_us_ = 0;
+
+  // hourly RTC HW read: software clock was 1 s off (drift) or more (mismatch), RTC HW wins either way
+  uint32_t clock_drift_count_ = 0, clock_mismatch_count_ = 0;
 
   uint16_t todays_minutes = 0;
 
@@ -31,12 +45,15 @@ public:
   */
   void SetRtcTimeAndDate(uint8_t second, uint8_t minute, uint8_t hour_24_hr_mode, uint8_t dayOfWeek_Sun_is_1, uint8_t day, uint8_t month_Jan_is_1, uint16_t year);
 
-  uint8_t second() { return second_; }
-  uint8_t minute();
+  // software clock snapshot, safe to call from either core and never goes to I2C
+  ClockTime Now();
+
+  uint8_t second() { return Now().second; }
+  uint8_t minute() { return Now().minute; }
   uint8_t hour();
-  uint8_t day() { return rtc_hw_.day(); }
-  uint8_t month() { return rtc_hw_.month(); }
-  uint16_t year() { return rtc_hw_.year() + 2000; }
+  uint8_t day() { return Now().day; }
+  uint8_t month() { return Now().month; }
+  uint16_t year() { return Now().year; }
   /**
   * \brief Returns actual Day Of Week
   *
@@ -49,7 +66,7 @@ public:
   *   - #URTCLIB_WEEKDAY_FRIDAY = 6
   *   - #URTCLIB_WEEKDAY_SATURDAY = 7
   */
-  uint8_t dayOfWeek() { return rtc_hw_.dayOfWeek(); }
+  uint8_t dayOfWeek() { return Now().day_of_week; }
   /**
   * \brief Returns whether clock is in 12 or 24 hour mode
   * and AM or PM if in 12 hour mode
@@ -59,7 +76,7 @@ public:
   *
   * @return byte with value 0, 1 or 2
   */
-  uint8_t hourModeAndAmPm() { return rtc_hw_.hourModeAndAmPm(); }
+  uint8_t hourModeAndAmPm();
 
   /**
   * \brief Set clock in 12 or 24 hour mode
@@ -69,7 +86,18 @@ public:
   *
   * @param twelveHrMode true or false
   */
-  void set_12hour_mode(const bool twelveHrMode) { rtc_hw_.set_12hour_mode(twelveHrMode); }
+  void set_12hour_mode(const bool twelveHrMode) { rtc_hw_.set_12hour_mode(twelveHrMode); twelve_hour_mode_ = twelveHrMode; }
+
+  // local time rules from a POSIX TZ string, false if it does not parse (clock then stays on NTP offset from weather)
+  bool SetTimezone(const std::string &posix_tz);
+  bool timezone_valid();
+  // set RTC HW and software clock to local time of a UTC epoch
+  void SetTimeFromUtc(uint32_t utc);
+  // same, written when micros() reaches at_micros, the start of UTC second utc
+  void SetTimeAtSecond(uint32_t utc, uint32_t at_micros);
+  // seconds east of UTC now, and next DST change (0 when none)
+  int32_t utc_offset_sec();
+  int64_t next_transition_utc();
 
   void DaysMinutesToClockTime(uint16_t todays_minutes_val, uint8_t &hour_mode_and_am_pm, uint8_t &hr, uint8_t &min);
 
@@ -80,17 +108,39 @@ private:
   // RTC clock object for DC3231 rtc
   uRTCLib rtc_hw_;
 
-  // seconds counter to track RTC HW seconds, without
-  // bothering it with I2C calls all the time.
-  // we'll refresh RTC time everytime second reaches 60
-  // All other parameters of RTC will not change at any other time
-  // at 60 seconds, we'll update the time row
-  static inline volatile uint8_t second_ = 0;
-
-  static inline volatile bool rtc_refresh_reqd_ = false;
+  // software clock: read from RTC HW at setup, time set and once an hour, advanced by the SQW interrupt in between
+  // writers (SQW ISR and loop) take clock_mux_, readers on either core go lock free through the clock_seq_ seqlock
+  static inline ClockTime clock_;
+  static inline std::atomic<uint32_t> clock_seq_{0};
+  static inline portMUX_TYPE clock_mux_ = portMUX_INITIALIZER_UNLOCKED;
+  bool twelve_hour_mode_ = true;
+
+  // timezone and DST rules, transitions are applied to the clock at the SQW tick they fall on.
+  // loop steps DST while the second core sets time from NTP or a new timezone, so all of these are under clock_mux_
+  PosixTz tz_;
+  int32_t utc_offset_sec_ = 0;
+  int64_t next_transition_utc_ = 0;
+  int32_t next_offset_sec_ = 0;
+  static int64_t LocalEpoch(const ClockTime& time);
+  static ClockTime FromLocalEpoch(int64_t local);
+  // utc_offset_sec_ and next transition for the current clock reading
+  void UpdateUtcOffset();
+  // with clock_mux_ held
+  void UpdateNextTransition(int64_t utc);
+  // DST step on RTC HW: minutes, hours and date registers, seconds are left running
+  void SetHwMinuteHourDate(const ClockTime& time);
+
+  // a minute of ticks, none are lost while loop is held up by a long blocking screen
+  static inline IsrEventRing<SqwEvent, 64> sqw_events_;
 
   // private function to refresh time from RTC HW and do basic power failure checks
   void Refresh();
+  // read RTC HW time in 24 hour form
+  ClockTime ReadHw();
+  // replace software clock, from either core: writers serialize on clock_mux_ with the SQW ISR
+  void SetClock(const ClockTime& time);
+  // same, with clock_mux_ held
+  static void WriteClock(const ClockTime& time);
 
   // clock seconds interrupt ISR
   static void IRAM_ATTR SecondsUpdateInterruptISR();
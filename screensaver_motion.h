@@ -0,0 +1,111 @@
+#ifndef SCREENSAVER_MOTION_H
+#define SCREENSAVER_MOTION_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Screensaver canvas paste choice, no Arduino dependencies.
+// A full blit rewrites the whole canvas rectangle. A motion blit sends only the pixels that differ between the canvas
+// at its old and new place and takes the panel outside the old rectangle to be bg. The colored edge canvas has a
+// border on its outermost pixels and full blits leave its trailing rows and columns behind, that trail is the colored
+// edge look. So an edge canvas is always full blitted, and a trail left on the panel is wiped once before motion blits
+// take over again. Without the edge, parts of the last canvas a full blit does not cover are handed back to be cleared,
+// so the panel outside the canvas stays bg.
+class ScreensaverPaste {
+public:
+  enum Kind : uint8_t {
+    kFullBlit,            // send the whole canvas
+    kMotionBlit,          // send only changed pixels
+    kClearThenFullBlit,   // clear the panel to bg, then send the whole canvas
+  };
+
+  struct Rect {
+    int16_t x, y, w, h;
+  };
+
+  // paste for canvas rectangle rect, same_canvas false if the bitmap changed since the last paste
+  // moves larger than max_step px in x or y go as a full blit
+  Kind Next(bool motion_blit_enabled, bool same_canvas, const Rect& rect, int16_t max_step, bool canvas_has_edge) {
+    Kind kind = kFullBlit;
+    stale_count_ = 0;
+    if(canvas_has_edge)
+      trail_on_panel_ = true;
+    else if(trail_on_panel_) {
+      trail_on_panel_ = false;
+      kind = kClearThenFullBlit;
+    }
+    else if(motion_blit_enabled && same_canvas && last_valid_ && abs(rect.x - last_.x) <= max_step && abs(rect.y - last_.y) <= max_step)
+      kind = kMotionBlit;
+    else if(last_valid_)
+      stale_count_ = Uncovered(last_, rect, stale_);
+    last_ = rect;
+    last_valid_ = true;
+    return kind;
+  }
+
+  // parts of the last canvas to clear to bg after this kFullBlit
+  uint8_t stale_count() const { return stale_count_; }
+  const Rect& stale(uint8_t i) const { return stale_[i]; }
+
+  // panel was cleared to bg by someone else
+  void PanelCleared() {
+    trail_on_panel_ = false;
+    last_valid_ = false;
+  }
+  bool trail_on_panel() const { return trail_on_panel_; }
+
+  // parts of a not covered by b, as up to 4 rectangles, returns how many
+  static uint8_t Uncovered(const Rect& a, const Rect& b, Rect out[4]) {
+    int16_t top = (b.y > a.y ? b.y : a.y), bottom = (b.y + b.h < a.y + a.h ? b.y + b.h : a.y + a.h);
+    int16_t left = (b.x > a.x ? b.x : a.x), right = (b.x + b.w < a.x + a.w ? b.x + b.w : a.x + a.w);
+    if(top >= bottom || left >= right) {
+      out[0] = a;
+      return 1;
+    }
+    uint8_t n = 0;
+    if(top > a.y)
+      out[n++] = {a.x, a.y, a.w, (int16_t)(top - a.y)};
+    if(a.y + a.h > bottom)
+      out[n++] = {a.x, bottom, a.w, (int16_t)(a.y + a.h - bottom)};
+    if(left > a.x)
+      out[n++] = {a.x, top, (int16_t)(left - a.x), (int16_t)(bottom - top)};
+    if(a.x + a.w > right)
+      out[n++] = {right, top, (int16_t)(a.x + a.w - right), (int16_t)(bottom - top)};
+    return n;
+  }
+
+private:
+  bool trail_on_panel_ = false;
+  Rect last_ = {0, 0, 0, 0};
+  bool last_valid_ = false;
+  Rect stale_[4];
+  uint8_t stale_count_ = 0;
+};
+
+// Whole pixel screensaver steps at a set speed whatever the frame rate, no Arduino dependencies.
+// Motion owed is kept in px * ms. A frame moves at most max_step px: the canvas has only a GAP_BAND wide bg margin to
+// wipe its own last place, and the colored edge trail is dotted by any step over 1 px. What is left over is carried
+// to the next frames, up to max_step px, so short stalls are caught up without a jump and long ones are dropped.
+class ScreensaverStep {
+public:
+  // motion owed for interval_ms more at speed_px_per_sec
+  void Add(unsigned long interval_ms, unsigned long speed_px_per_sec) { accum_ += speed_px_per_sec * interval_ms; }
+
+  // whole px to move this frame, at most max_step
+  int16_t Take(int16_t max_step) {
+    unsigned long step = accum_ / 1000;
+    if(step > (unsigned long)max_step)
+      step = max_step;
+    accum_ -= step * 1000;
+    if(accum_ > (unsigned long)max_step * 1000)
+      accum_ = (unsigned long)max_step * 1000;
+    return (int16_t)step;
+  }
+
+  void Reset() { accum_ = 0; }
+
+private:
+  unsigned long accum_ = 0;
+};
+
+#endif  // SCREENSAVER_MOTION_H
@@ -0,0 +1,84 @@
+#ifndef SNTP_MATH_H
+#define SNTP_MATH_H
+
+#include <stdint.h>
+
+// SNTP (RFC 4330) timestamp math and sample selection, no Arduino dependencies.
+// Local times are 32 bit micros() readings, server times are microseconds since 1 Jan 1970. A request sent at local
+// t1, received by the server at t2, answered at t3 and received back at local t4 has round trip
+// (t4 - t1) - (t3 - t2), and the server clock read t3 + round trip / 2 at t4. The sample with the lowest round trip
+// has the least room for asymmetric network delay, so that one is used.
+class SntpMath {
+public:
+  static const uint32_t kNtpToUnixSeconds = 2208988800UL;   // 1 Jan 1900 to 1 Jan 1970
+  static const uint8_t kPacketSize = 48;
+
+  struct Sample {
+    int64_t utc_us_at_t4;     // server time when the reply arrived
+    uint32_t t4_micros;       // local micros() when the reply arrived
+    int32_t round_trip_us;
+  };
+
+  // NTP timestamp (seconds since 1900 and 32 bit binary fraction) to microseconds since 1970
+  static int64_t NtpToUnixUs(uint32_t seconds, uint32_t fraction) {
+    return ((int64_t)seconds - kNtpToUnixSeconds) * 1000000 + (((uint64_t)fraction * 1000000) >> 32);
+  }
+
+  static uint32_t ReadBigEndian32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+  }
+
+  // client request: LI 0, version 4, mode 3 (client), cookie in the transmit timestamp comes back as originate
+  static void MakeRequest(uint8_t* packet, uint32_t cookie) {
+    for(uint8_t i = 0; i < kPacketSize; i++)
+      packet[i] = 0;
+    packet[0] = (0 << 6) | (4 << 3) | 3;
+    packet[40] = cookie >> 24;
+    packet[41] = cookie >> 16;
+    packet[42] = cookie >> 8;
+    packet[43] = cookie;
+  }
+
+  // false if reply is not a usable server answer to the request with this cookie
+  static bool ParseReply(const uint8_t* packet, uint32_t cookie, uint32_t t1_micros, uint32_t t4_micros, Sample* sample) {
+    uint8_t leap = packet[0] >> 6, mode = packet[0] & 0x07, stratum = packet[1];
+    if(mode != 4 || leap == 3 || stratum == 0 || stratum > 15)
+      return false;
+    if(ReadBigEndian32(packet + 24) != cookie || ReadBigEndian32(packet + 28) != 0)
+      return false;
+    int64_t t2_us = NtpToUnixUs(ReadBigEndian32(packet + 32), ReadBigEndian32(packet + 36));
+    int64_t t3_us = NtpToUnixUs(ReadBigEndian32(packet + 40), ReadBigEndian32(packet + 44));
+    int64_t round_trip_us = (int64_t)(uint32_t)(t4_micros - t1_micros) - (t3_us - t2_us);
+    if(round_trip_us < 0)
+      round_trip_us = 0;
+    sample->utc_us_at_t4 = t3_us + round_trip_us / 2;
+    sample->t4_micros = t4_micros;
+    sample->round_trip_us = round_trip_us;
+    return true;
+  }
+
+  // lowest round trip sample, NULL if count is 0
+  static const Sample* Best(const Sample* samples, uint8_t count) {
+    const Sample* best = nullptr;
+    for(uint8_t i = 0; i < count; i++)
+      if(best == nullptr || samples[i].round_trip_us < best->round_trip_us)
+        best = &samples[i];
+    return best;
+  }
+
+  // server time at a later local micros() reading
+  static int64_t UtcUsAt(const Sample& sample, uint32_t now_micros) {
+    return sample.utc_us_at_t4 + (uint32_t)(now_micros - sample.t4_micros);
+  }
+
+  // first whole UTC second after local now_micros, and the micros() reading it starts at. Worked out from now, not
+  // from the sample: later samples may have taken longer than the rest of the second the best one arrived in
+  static int64_t NextSecondAfter(const Sample& sample, uint32_t now_micros, uint32_t* at_micros) {
+    const int64_t utc_us = UtcUsAt(sample, now_micros);
+    const int64_t second = utc_us / 1000000 + 1;
+    *at_micros = now_micros + (uint32_t)(second * 1000000 - utc_us);
+    return second;
+  }
+};
+
+#endif  // SNTP_MATH_H
@@ -0,0 +1,92 @@
+#ifndef SUN_DRAWING_H
+#define SUN_DRAWING_H
+
+#include <Adafruit_GFX.h>
+
+// Integer math of the GoodMorningScreen sun, needs only Adafruit_GFX.
+// Q15 sin and cos of whole degrees from a quarter wave table, rings filled as horizontal spans and ray corners.
+class SunDrawing {
+public:
+  // sin of integer degrees in Q15 from quarter wave table
+  static int16_t SinQ15(int16_t deg) {
+    deg %= 360;
+    if(deg < 0)
+      deg += 360;
+    if(deg <= 90)
+      return kSinQ15[deg];
+    else if(deg <= 180)
+      return kSinQ15[180 - deg];
+    else if(deg <= 270)
+      return -kSinQ15[deg - 180];
+    else
+      return -kSinQ15[360 - deg];
+  }
+  static int16_t CosQ15(int16_t deg) { return SinQ15(deg + 90); }
+
+  // fill all pixels at distance (r_inner - 1, r_outer] from center cx, cy
+  // with integer midpoint circle edges, sent as horizontal spans in one write transaction
+  static void DrawRing(Adafruit_GFX& gfx, int16_t cx, int16_t cy, int16_t r_inner, int16_t r_outer, uint16_t color) {
+    if(r_outer < r_inner)
+      return;
+    int32_t r_out2 = (int32_t)r_outer * r_outer, r_in2 = (int32_t)(r_inner - 1) * (r_inner - 1);
+    // x extent of outer and inner circles on row dy, both only shrink as dy grows
+    int16_t x_out = r_outer, x_in = r_inner - 1;
+    gfx.startWrite();
+    for (int16_t dy = 0; dy <= r_outer; dy++) {
+      int32_t dy2 = (int32_t)dy * dy;
+      while(x_out >= 0 && (int32_t)x_out * x_out + dy2 > r_out2)
+        x_out--;
+      while(x_in >= 0 && (int32_t)x_in * x_in + dy2 > r_in2)
+        x_in--;
+      // x_in is the last pixel inside the inner circle, ring starts after it
+      int16_t span_x0 = x_in + 1;
+      if(x_out < span_x0)
+        continue;
+      if(span_x0 == 0) {
+        // row crosses center column, one span
+        gfx.writeFastHLine(cx - x_out, cy + dy, 2 * x_out + 1, color);
+        if(dy != 0)
+          gfx.writeFastHLine(cx - x_out, cy - dy, 2 * x_out + 1, color);
+      }
+      else {
+        gfx.writeFastHLine(cx - x_out, cy + dy, x_out - span_x0 + 1, color);
+        gfx.writeFastHLine(cx + span_x0, cy + dy, x_out - span_x0 + 1, color);
+        if(dy != 0) {
+          gfx.writeFastHLine(cx - x_out, cy - dy, x_out - span_x0 + 1, color);
+          gfx.writeFastHLine(cx + span_x0, cy - dy, x_out - span_x0 + 1, color);
+        }
+      }
+    }
+    gfx.endWrite();
+  }
+
+  // corners of a ray at theta_deg around cx, cy: inner radius rr, length rl, width rw
+  // drawn as triangles 0 1 2 and 0 2 3
+  static void RayQuad(int16_t cx, int16_t cy, int16_t rr, int16_t rl, int16_t rw, int16_t theta_deg, int16_t x[4], int16_t y[4]) {
+    int32_t c = CosQ15(theta_deg), s = SinQ15(theta_deg);
+    int16_t rcos = (rr * c) >> 15, rlcos = ((rr + rl) * c) >> 15, rsin = (rr * s) >> 15, rlsin = ((rr + rl) * s) >> 15;
+    int16_t w2sin = ((rw / 2) * s) >> 15, w2cos = ((rw / 2) * c) >> 15;
+    x[0] = cx + rcos - w2sin;
+    x[1] = cx + rcos + w2sin;
+    x[2] = cx + rlcos + w2sin;
+    x[3] = cx + rlcos - w2sin;
+    y[0] = cy + rsin + w2cos;
+    y[1] = cy + rsin - w2cos;
+    y[2] = cy + rlsin - w2cos;
+    y[3] = cy + rlsin + w2cos;
+  }
+
+private:
+  // sin of 0 to 90 degrees in Q15
+  static constexpr int16_t kSinQ15[91] = {
+    0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126, 5690, 6252, 6813,
+    7371, 7927, 8481, 9032, 9580, 10126, 10668, 11207, 11743, 12275, 12803, 13328, 13848,
+    14364, 14876, 15383, 15886, 16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173,
+    20621, 21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730, 25101, 25465,
+    25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087, 28377, 28659, 28932, 29196, 29451,
+    29697, 29934, 30162, 30381, 30591, 30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927,
+    32051, 32165, 32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762, 32767
+  };
+};
+
+#endif // SUN_DRAWING_H
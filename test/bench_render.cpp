@@ -0,0 +1,182 @@
+// Render hot paths against the Adafruit_GFX calls they replace, on the host CPU.
+// Absolute times differ from an ESP32, the ratios are what to look at.
+
+#include <initializer_list>
+#include <Adafruit_GFX.h>
+#include "general_constants.h"
+#include "two_color_blit.h"
+#include "time_row_draw.h"
+#include "Fonts/ComingSoon_Regular70pt7b_numbers_only.h"
+#include "Fonts/FreeMono9pt7b.h"
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "gfx_canvases.h"
+#include "text_layout_cache.h"
+#include "test_util.h"
+
+static volatile uint32_t sink;
+
+// full screen monochrome frame to RGB565, one row buffer vs Adafruit drawBitmap(color, bg) into a 16 bit canvas
+static void BenchTwoColorExpand() {
+  printf("two color expand, %dx%d frame\n", kTftWidth, kTftHeight);
+  const int row_bytes = (kTftWidth + 7) / 8;
+  static uint8_t bitmap[row_bytes * kTftHeight];
+  TestRandom rnd(7);
+  for (int i = 0; i < row_bytes * kTftHeight; i++)
+    bitmap[i] = (i % 3 == 0 ? (uint8_t)rnd.Next() : 0);
+  static GFXcanvas16 canvas16(kTftWidth, kTftHeight);
+  Bench("GFXcanvas16::drawBitmap(color, bg)", 50, [&]() {
+    canvas16.drawBitmap(0, 0, bitmap, kTftWidth, kTftHeight, 0xF800, 0x0000);
+    sink += canvas16.getBuffer()[1];
+  });
+  TwoColorLut lut;
+  lut.Set(0xF800, 0x0000);
+  uint16_t row[kTftWidth];
+  Bench("TwoColorLut::ExpandRow, all rows", 50, [&]() {
+    for (int j = 0; j < kTftHeight; j++) {
+      lut.ExpandRow(bitmap + j * row_bytes, 0, kTftWidth, row);
+      sink += row[1];
+    }
+  });
+}
+
+// main page time row each second: full row vs DirtyColumns plus a redraw of the dirty columns, over one hour of ticks
+static void BenchTimeRow() {
+  printf("time row redraw, average over an hour of second ticks\n");
+  static RowText rows[3601];
+  for (int t = 0; t <= 3600; t++)
+    rows[t] = MakeRow(13 * 3600 + t, true);
+  static GFXcanvas1 full(kTftWidth, kRowH);
+  int t = 0;
+  Bench("full row print", 3600, [&]() {
+    DrawTimeRow(full, 0, rows[++t]);
+    sink += full.getBuffer()[0];
+  });
+  TimeRowLayout layout(&FreeSansBold48pt7b, &FreeSans18pt7b);
+  static uint8_t arena[((kTftWidth + 7) / 8) * kRowH];
+  long columns = 0;
+  t = 0;
+  Bench("DirtyColumns + partial row print", 3600, [&]() {
+    t++;
+    int16_t dirty_x0 = 0, dirty_x1 = kTftWidth - 1;
+    layout.DirtyColumns(rows[t].row(), rows[t - 1].row(), &dirty_x0, &dirty_x1);
+    // stand in for the canvas arena, no malloc in the loop
+    struct View : public GFXcanvas1 {
+      View(int16_t w, uint8_t* buf) : GFXcanvas1(w, kRowH, false) { buffer = buf; }
+    } view(dirty_x1 - dirty_x0 + 1, arena);
+    DrawTimeRow(view, dirty_x0, rows[t]);
+    columns += dirty_x1 - dirty_x0 + 1;
+    sink += arena[0];
+  });
+  printf("  average redrawn width %ld of %d px\n", columns / 3600, kTftWidth);
+}
+
+// big clock digits: GlyphAtlas against GFXcanvas1 drawChar / print, one glyph and a whole time string
+static void BenchGlyphAtlas(const char* font_name, const GFXfont* font) {
+  printf("time digits, %s\n", font_name);
+  static GFXcanvas1 canvas(kTftWidth, 150);
+  canvas.setTextWrap(false);
+  canvas.setFont(font);
+  canvas.setTextColor(1);
+  GlyphAtlas atlas;
+  atlas.Build(font);
+  Bench("GFXcanvas1::drawChar('8')", 2000, [&]() {
+    canvas.drawChar(10, 120, '8', 1, 0, 1);
+    sink += canvas.getBuffer()[0];
+  });
+  Bench("GlyphAtlas::Print(\"8\")", 2000, [&]() {
+    canvas.setCursor(10, 120);
+    atlas.Print(&canvas, "8", 1);
+    sink += canvas.getBuffer()[0];
+  });
+  Bench("GFXcanvas1::print(\"12:38\")", 2000, [&]() {
+    canvas.setCursor(10, 120);
+    canvas.print("12:38");
+    sink += canvas.getBuffer()[0];
+  });
+  Bench("GlyphAtlas::Print(\"12:38\")", 2000, [&]() {
+    canvas.setCursor(10, 120);
+    atlas.Print(&canvas, "12:38", 1);
+    sink += canvas.getBuffer()[0];
+  });
+}
+
+// canvas text: SpanTextCanvas1 against GFXcanvas1 drawChar / print, one glyph and a whole string
+static void BenchSpanText(const char* font_name, const GFXfont* font, char glyph, const char* str) {
+  printf("canvas text, %s\n", font_name);
+  static GFXcanvas1 canvas(kTftWidth, 150);
+  static SpanTextCanvas1 span(kTftWidth, 150);
+  char name[64];
+  for (GFXcanvas1* c : {&canvas, (GFXcanvas1*)&span}) {
+    c->setTextWrap(false);
+    c->setFont(font);
+    c->setTextColor(1);
+  }
+  snprintf(name, sizeof(name), "GFXcanvas1::drawChar('%c')", glyph);
+  Bench(name, 2000, [&]() {
+    canvas.drawChar(10, 120, glyph, 1, 0, 1);
+    sink += canvas.getBuffer()[0];
+  });
+  snprintf(name, sizeof(name), "SpanTextCanvas1::write('%c')", glyph);
+  Bench(name, 2000, [&]() {
+    span.setCursor(10, 120);
+    span.write(glyph);
+    sink += span.getBuffer()[0];
+  });
+  snprintf(name, sizeof(name), "GFXcanvas1::print(\"%s\")", str);
+  Bench(name, 2000, [&]() {
+    canvas.setCursor(3, 120);
+    canvas.print(str);
+    sink += canvas.getBuffer()[0];
+  });
+  snprintf(name, sizeof(name), "SpanTextCanvas1::print(\"%s\")", str);
+  Bench(name, 2000, [&]() {
+    span.setCursor(3, 120);
+    span.print(str);
+    sink += span.getBuffer()[0];
+  });
+}
+
+// text measuring for one settings page redraw: row labels in FreeMono9pt7b and button values in FreeMonoBold9pt7b,
+// getTextBounds every time vs TextLayoutCache hits
+static void BenchTextBounds() {
+  printf("text bounds, screensaver settings page labels and values\n");
+  static const struct { const GFXfont* font; const char* str; } kTexts[] = {
+    { &FreeMono9pt7b, "Screensaver Motion:" }, { &FreeMonoBold9pt7b, "BOUNCE" },
+    { &FreeMono9pt7b, "Screensaver Speed:" }, { &FreeMonoBold9pt7b, "MEDIUM" },
+    { &FreeMono9pt7b, "Run Screensaver:" }, { &FreeMonoBold9pt7b, "RUN" },
+    { &FreeMono9pt7b, "RGB LEDs Mode:" }, { &FreeMonoBold9pt7b, "AUTO-SUN-DOWN" },
+    { &FreeMono9pt7b, "Evening time is 6PM to:" }, { &FreeMonoBold9pt7b, "11PM" },
+    { &FreeMono9pt7b, "RGB LEDs Brightness:" }, { &FreeMonoBold9pt7b, "100%" },
+    { &FreeMonoBold9pt7b, "BACK" },
+  };
+  static GFXcanvas1 canvas(kTftWidth, kTftHeight);
+  canvas.setTextWrap(false);
+  int16_t x1, y1;
+  uint16_t w, h;
+  Bench("getTextBounds, 13 strings", 20000, [&]() {
+    for (auto& text : kTexts) {
+      canvas.setFont(text.font);
+      canvas.getTextBounds(text.str, 0, 50, &x1, &y1, &w, &h);
+      sink += w;
+    }
+  });
+  TextLayoutCache cache;
+  Bench("TextLayoutCache::TextBounds, 13 strings", 20000, [&]() {
+    for (auto& text : kTexts) {
+      cache.TextBounds(canvas, text.font, text.str, 0, 50, &x1, &y1, &w, &h);
+      sink += w;
+    }
+  });
+  printf("  cache %lu hits, %lu misses\n", cache.hits, cache.misses);
+}
+
+int main() {
+  BenchTwoColorExpand();
+  BenchTimeRow();
+  BenchGlyphAtlas("FreeSansBold48pt7b", &FreeSansBold48pt7b);
+  BenchGlyphAtlas("ComingSoon_Regular70pt7b", &ComingSoon_Regular70pt7b);
+  BenchSpanText("ComingSoon_Regular70pt7b", &ComingSoon_Regular70pt7b, '8', "12:38");
+  BenchSpanText("FreeSans18pt7b", &FreeSans18pt7b, 'W', "Tue, Jan 9");
+  BenchTextBounds();
+  return 0;
+}
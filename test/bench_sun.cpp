@@ -0,0 +1,206 @@
+// GoodMorningScreen sun animation: the float trig rays and per pixel DrawDenseCircle it used to draw with against
+// SunDrawing's Q15 rays and span filled rings, on the host CPU. Also counts the panel transactions each version
+// would start (every lone drawPixel is one on Adafruit_SPITFT) and how many pixels the two leave different.
+// Absolute times differ from an ESP32, the ratios are what to look at.
+
+#include <math.h>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "general_constants.h"
+#include "sun_drawing.h"
+#include "test_util.h"
+
+static const uint16_t kYellow = 0xFFE0, kBlack = 0x0000;
+static volatile uint32_t sink;
+
+// RGB565 frame that counts what an SPI panel would be sent
+class CountingCanvas16 : public GFXcanvas16 {
+public:
+  CountingCanvas16() : GFXcanvas16(kTftWidth, kTftHeight) {}
+  void startWrite() override {
+    if(depth_++ == 0)
+      transactions++;
+  }
+  void endWrite() override { depth_--; }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if(depth_ == 0)
+      transactions++;
+    pixels++;
+    GFXcanvas16::drawPixel(x, y, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    if(depth_ == 0)
+      transactions++;
+    pixels += abs(w);
+    GFXcanvas16::drawFastHLine(x, y, w, color);
+  }
+  long transactions = 0, pixels = 0;
+
+private:
+  int depth_ = 0;
+};
+
+// sun geometry of RGBDisplay::DrawSun for GoodMorningScreen's 160 px square at 80, 80
+struct Sun {
+  int16_t cx = 80 + 160 / 2, cy = 80 + 160 / 2;
+  int16_t sr = 160 * 0.23, rl = 160 * 0.09, rr = sr + 160 * 0.08, rw = 5;
+  uint8_t rn = 12;
+};
+
+// the rays and ring before SunDrawing, double and float trig
+static void OldRays(Adafruit_GFX& gfx, const Sun& s, int16_t rr, int16_t deg_start, uint16_t color) {
+  for (uint8_t i = 0; i < s.rn; i++) {
+    float theta = 2 * PI * i / s.rn + deg_start * DEG_TO_RAD;
+    double rcos = rr * cos(theta), rlcos = (rr + s.rl) * cos(theta), rsin = rr * sin(theta), rlsin = (rr + s.rl) * sin(theta);
+    double w2sin = s.rw / 2 * sin(theta), w2cos = s.rw / 2 * cos(theta);
+    int16_t x1 = s.cx + rcos - w2sin, x2 = s.cx + rcos + w2sin, x3 = s.cx + rlcos + w2sin, x4 = s.cx + rlcos - w2sin;
+    int16_t y1 = s.cy + rsin + w2cos, y2 = s.cy + rsin - w2cos, y3 = s.cy + rlsin - w2cos, y4 = s.cy + rlsin + w2cos;
+    gfx.fillTriangle(x1, y1, x2, y2, x3, y3, color);
+    gfx.fillTriangle(x1, y1, x3, y3, x4, y4, color);
+  }
+}
+
+static void OldDenseCircle(Adafruit_GFX& gfx, int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+  double d_theta = 0.5 / static_cast<double>(r);
+  uint32_t n = PI / 2 / d_theta;
+  for (uint32_t i = 0; i < n; i++) {
+    float theta = i * d_theta;
+    int16_t rcos = r * cos(theta);
+    int16_t rsin = r * sin(theta);
+    gfx.drawPixel(cx + rcos, cy + rsin, color);
+    gfx.drawPixel(cx - rcos, cy + rsin, color);
+    gfx.drawPixel(cx + rcos, cy - rsin, color);
+    gfx.drawPixel(cx - rcos, cy - rsin, color);
+  }
+}
+
+static void NewRays(Adafruit_GFX& gfx, const Sun& s, int16_t rr, int16_t deg_start, uint16_t color) {
+  for (uint8_t i = 0; i < s.rn; i++) {
+    int16_t x[4], y[4];
+    SunDrawing::RayQuad(s.cx, s.cy, rr, s.rl, s.rw, 360 * i / s.rn + deg_start, x, y);
+    gfx.fillTriangle(x[0], y[0], x[1], y[1], x[2], y[2], color);
+    gfx.fillTriangle(x[0], y[0], x[2], y[2], x[3], y[3], color);
+  }
+}
+
+// one frame of DrawSun's loop, shown is called while it is on screen, before the rays are undrawn
+template <typename Shown>
+static void Frame(Adafruit_GFX& gfx, const Sun& s, bool old, int16_t i, int16_t& variation_prev, Shown shown) {
+  int16_t variation = std::min(i % 10, ((i / 10) + 1) * 10 - i);
+  int16_t r_variable = s.rr + variation;
+  if(old) {
+    OldRays(gfx, s, r_variable, i, kYellow);
+    OldDenseCircle(gfx, s.cx, s.cy, s.sr + variation, kYellow);
+    shown();
+    OldRays(gfx, s, r_variable, i, kBlack);
+    if(variation < variation_prev)
+      OldDenseCircle(gfx, s.cx, s.cy, s.sr + variation_prev + 1, kBlack);
+  }
+  else {
+    NewRays(gfx, s, r_variable, i, kYellow);
+    if(variation > variation_prev)
+      SunDrawing::DrawRing(gfx, s.cx, s.cy, s.sr + variation_prev + 1, s.sr + variation, kYellow);
+    shown();
+    NewRays(gfx, s, r_variable, i, kBlack);
+    if(variation < variation_prev)
+      SunDrawing::DrawRing(gfx, s.cx, s.cy, s.sr + variation + 1, s.sr + variation_prev + 1, kBlack);
+  }
+  variation_prev = variation;
+}
+
+// all 120 frames of one DrawSun call after the sun disc is drawn
+static void Animation(CountingCanvas16& gfx, const Sun& s, bool old) {
+  int16_t variation_prev = 0;
+  for (int16_t i = 0; i < 120; i++)
+    Frame(gfx, s, old, i, variation_prev, []() {});
+}
+
+// after a frame's rays are undrawn only a sun disc of radius r should be left: yellow pixels farther out than r are
+// left over, black pixels closer in than r - 1 are holes (the eyes and smile are not drawn here)
+static void CheckLeftOver(const GFXcanvas16& canvas, const Sun& s, int16_t r, int* left_over, int* holes) {
+  for (int16_t y = 0; y < kTftHeight; y++)
+    for (int16_t x = 0; x < kTftWidth; x++) {
+      int32_t d2 = (int32_t)(x - s.cx) * (x - s.cx) + (int32_t)(y - s.cy) * (y - s.cy);
+      uint16_t c = canvas.getBuffer()[y * kTftWidth + x];
+      *left_over += (c != kBlack && d2 > (int32_t)r * r);
+      *holes += (c == kBlack && d2 < (int32_t)(r - 1) * (r - 1));
+    }
+}
+
+static int DiffPixels(const GFXcanvas16& a, const GFXcanvas16& b) {
+  int diff = 0;
+  for (int k = 0; k < kTftWidth * kTftHeight; k++)
+    diff += (a.getBuffer()[k] != b.getBuffer()[k]);
+  return diff;
+}
+
+static void BenchSun() {
+  Sun s;
+  printf("GoodMorningScreen sun, 120 frames\n");
+  static CountingCanvas16 old_canvas, new_canvas;
+  for (bool old : { true, false }) {
+    CountingCanvas16& canvas = (old ? old_canvas : new_canvas);
+    canvas.fillScreen(kBlack);
+    canvas.fillCircle(s.cx, s.cy, s.sr, kYellow);
+    canvas.transactions = canvas.pixels = 0;
+    Animation(canvas, s, old);
+    printf("  %-44s %10ld transactions %8ld pixels\n", old ? "float rays + DrawDenseCircle" : "SunDrawing rays + DrawRing", canvas.transactions, canvas.pixels);
+  }
+  Bench("float rays + DrawDenseCircle", 20, [&]() {
+    Animation(old_canvas, s, true);
+    sink += old_canvas.getBuffer()[0];
+  });
+  Bench("SunDrawing rays + DrawRing", 20, [&]() {
+    Animation(new_canvas, s, false);
+    sink += new_canvas.getBuffer()[0];
+  });
+
+  // what is on screen during each frame's delay
+  for (CountingCanvas16* canvas : { &old_canvas, &new_canvas }) {
+    canvas->fillScreen(kBlack);
+    canvas->fillCircle(s.cx, s.cy, s.sr, kYellow);
+  }
+  int16_t old_prev = 0, new_prev = 0;
+  int max_diff = 0, sum_diff = 0, ray_diff = 0;
+  for (int16_t i = 0; i < 120; i++) {
+    std::vector<uint16_t> old_shown;
+    Frame(old_canvas, s, true, i, old_prev, [&]() {
+      old_shown.assign(old_canvas.getBuffer(), old_canvas.getBuffer() + kTftWidth * kTftHeight);
+    });
+    Frame(new_canvas, s, false, i, new_prev, [&]() {
+      int diff = 0;
+      for (int k = 0; k < kTftWidth * kTftHeight; k++)
+        diff += (old_shown[k] != new_canvas.getBuffer()[k]);
+      max_diff = std::max(max_diff, diff);
+      sum_diff += diff;
+    });
+    // ray corners alone, Q15 against double
+    for (uint8_t r = 0; r < s.rn; r++) {
+      int16_t x[4], y[4];
+      SunDrawing::RayQuad(s.cx, s.cy, s.rr, s.rl, s.rw, 360 * r / s.rn + i, x, y);
+      float theta = 2 * PI * r / s.rn + i * DEG_TO_RAD;
+      int16_t x3 = s.cx + (s.rr + s.rl) * cos(theta) + s.rw / 2 * sin(theta);
+      ray_diff = std::max(ray_diff, abs(x[2] - x3));
+    }
+  }
+  for (bool old : { true, false }) {
+    CountingCanvas16& canvas = (old ? old_canvas : new_canvas);
+    canvas.fillScreen(kBlack);
+    canvas.fillCircle(s.cx, s.cy, s.sr, kYellow);
+    int16_t prev = 0;
+    int left_over = 0, holes = 0;
+    for (int16_t i = 0; i < 120; i++) {
+      Frame(canvas, s, old, i, prev, []() {});
+      CheckLeftOver(canvas, s, s.sr + prev, &left_over, &holes);
+    }
+    printf("  %-44s %6d left over %6d holes, over all frames\n", old ? "float rays + DrawDenseCircle" : "SunDrawing rays + DrawRing", left_over, holes);
+  }
+  printf("  pixels different on screen: %d average, %d most in a frame, %d left after the last frame\n",
+         sum_diff / 120, max_diff, DiffPixels(old_canvas, new_canvas));
+  printf("  ray corners up to %d px from the double version\n", ray_diff);
+}
+
+int main() {
+  BenchSun();
+  return 0;
+}
@@ -0,0 +1 @@
+// Adafruit_GFX.h includes this, nothing from it is used on the host
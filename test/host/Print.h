@@ -0,0 +1,31 @@
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+// minimal Arduino Print: everything ends in write(uint8_t)
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while(size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *str) { return (str == NULL ? 0 : write((const uint8_t *)str, strlen(str))); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long n) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", n);
+    return write(buf);
+  }
+  size_t print(int n) { return print((long)n); }
+};
+
+#endif  // HOST_PRINT_H
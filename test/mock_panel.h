@@ -0,0 +1,51 @@
+#ifndef MOCK_PANEL_H
+#define MOCK_PANEL_H
+
+#include <stdint.h>
+#include <vector>
+#include "test_util.h"
+
+// stands in for the SPI panel: an address window filled left to right, top to bottom, like the controller RAM write
+class MockPanel {
+public:
+  MockPanel(int16_t w, int16_t h, uint16_t fill = kUntouched) : w_(w), h_(h), ram_((size_t)w * h, fill) {}
+  static const uint16_t kUntouched = 0xA5A5;
+
+  void SetWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+    CHECK(x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= w_ && y + h <= h_);
+    win_x_ = x;
+    win_y_ = y;
+    win_w_ = w;
+    win_h_ = h;
+    written_ = 0;
+    windows++;
+  }
+  void WritePixels(uint16_t* row, int16_t w) {
+    CHECK(win_w_ > 0);
+    for (int16_t k = 0; k < w; k++) {
+      CHECK(written_ < (long)win_w_ * win_h_);
+      ram_[(size_t)(win_y_ + written_ / win_w_) * w_ + win_x_ + written_ % win_w_] = row[k];
+      written_++;
+    }
+    pixels += w;
+  }
+  void Fill(uint16_t color) { ram_.assign(ram_.size(), color); }
+
+  // whole window was filled
+  bool WindowComplete() const { return windows == 0 || written_ == (long)win_w_ * win_h_; }
+  uint16_t Pixel(int16_t x, int16_t y) const { return ram_[(size_t)y * w_ + x]; }
+  int16_t width() const { return w_; }
+  int16_t height() const { return h_; }
+  bool operator==(const MockPanel& other) const { return ram_ == other.ram_; }
+
+  int windows = 0;
+  long pixels = 0;
+
+private:
+  int16_t w_, h_;
+  std::vector<uint16_t> ram_;
+  int16_t win_x_ = 0, win_y_ = 0, win_w_ = 0, win_h_ = 0;
+  long written_ = 0;
+};
+
+#endif  // MOCK_PANEL_H
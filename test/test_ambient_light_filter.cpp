@@ -0,0 +1,181 @@
+// AmbientLightFilter on modelled photoresistor traces sampled at 50 Hz like the board's esp_timer: a lamp switched
+// on and off, ADC noise with spikes, mains flicker aliased by the sample rate, a hand passing over the sensor and
+// samples lost while the resistive touchscreen holds the ADC. Also exact settling on every 10 bit value and the
+// snapshot packing.
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include "ambient_light_filter.h"
+#include "test_util.h"
+
+static const int kAdcMax = 1023;
+static const float kSampleHz = 50;
+// EMA time constant in samples
+static const float kTauSamples = AmbientLightFilter::kDecimation * (float)(1 << AmbientLightFilter::kEmaShift);
+
+static uint16_t Clamp(float raw) { return (uint16_t)std::min(std::max((int)lroundf(raw), 0), kAdcMax); }
+
+// filtered value after each sample of trace, starting from its first sample
+static std::vector<uint16_t> Run(const std::vector<uint16_t>& trace) {
+  AmbientLightFilter filter;
+  filter.Reset(trace[0]);
+  std::vector<uint16_t> out;
+  for (uint16_t raw : trace) {
+    filter.Add(raw);
+    CHECK_EQ(filter.last_raw(), raw);
+    out.push_back(filter.filtered());
+  }
+  return out;
+}
+
+// lamp switched on then off: no overshoot, steps only between blocks, 95% of the way in about 3 time constants
+static void TestLampSwitched() {
+  const uint16_t kDark = 120, kLit = 860;
+  std::vector<uint16_t> trace(50, kDark);
+  trace.resize(50 + 1500, kLit);
+  trace.resize(50 + 1500 + 1500, kDark);
+  std::vector<uint16_t> out = Run(trace);
+  int on_95 = -1, off_95 = -1;
+  for (size_t i = 1; i < out.size(); i++) {
+    CHECK(out[i] >= kDark && out[i] <= kLit);
+    if((i + 1) % AmbientLightFilter::kDecimation != 0)
+      CHECK_EQ(out[i], out[i - 1]);
+    if(i < 50 + 1500) {
+      CHECK(out[i] >= out[i - 1]);
+      if(on_95 < 0 && out[i] >= kDark + (kLit - kDark) * 95 / 100)
+        on_95 = i - 50;
+    }
+    else {
+      CHECK(out[i] <= out[i - 1]);
+      if(off_95 < 0 && out[i] <= kLit - (kLit - kDark) * 95 / 100)
+        off_95 = i - 50 - 1500;
+    }
+  }
+  CHECK_EQ(out[50 + 1500 - 1], kLit);
+  CHECK_EQ(out.back(), kDark);
+  // 3 time constants, give or take the block the step landed in
+  CHECK(on_95 > 3 * kTauSamples - 2 * AmbientLightFilter::kDecimation && on_95 < 3 * kTauSamples + 2 * AmbientLightFilter::kDecimation);
+  CHECK(off_95 > 3 * kTauSamples - 2 * AmbientLightFilter::kDecimation && off_95 < 3 * kTauSamples + 2 * AmbientLightFilter::kDecimation);
+  printf("  lamp on reaches 95%% after %.1f s, off after %.1f s\n", on_95 / kSampleHz, off_95 / kSampleHz);
+}
+
+// +-8 LSB ADC noise and a 300 LSB spike every few seconds keep the filtered level within a few LSB
+static void TestNoiseAndSpikes() {
+  TestRandom rnd(19);
+  const uint16_t kLevel = 512;
+  std::vector<uint16_t> trace;
+  for (int i = 0; i < 5000; i++) {
+    int raw = kLevel + (int)rnd.Range(-8, 8);
+    if(rnd.Range(0, 199) == 0)
+      raw += 300;
+    trace.push_back(Clamp(raw));
+  }
+  trace[0] = kLevel;
+  std::vector<uint16_t> out = Run(trace);
+  int raw_lo = kAdcMax, raw_hi = 0, lo = kAdcMax, hi = 0;
+  for (size_t i = 0; i < out.size(); i++) {
+    raw_lo = std::min<int>(raw_lo, trace[i]);
+    raw_hi = std::max<int>(raw_hi, trace[i]);
+    lo = std::min<int>(lo, out[i]);
+    hi = std::max<int>(hi, out[i]);
+  }
+  CHECK(lo >= kLevel - 3 && hi <= kLevel + 6);
+  printf("  noise: raw %d..%d, filtered %d..%d\n", raw_lo, raw_hi, lo, hi);
+}
+
+// 100 Hz lamp flicker sampled at a slightly drifting 50 Hz aliases to a slow beat, the filter keeps a small part of it
+static void TestMainsFlicker() {
+  const float kFlickerHz = 100.3f, kLevel = 600, kDepth = 60;
+  std::vector<uint16_t> trace;
+  for (int i = 0; i < 6000; i++)
+    trace.push_back(Clamp(kLevel + kDepth * sinf(2 * (float)M_PI * kFlickerHz * i / kSampleHz)));
+  std::vector<uint16_t> out = Run(trace);
+  int lo = kAdcMax, hi = 0;
+  for (size_t i = 1000; i < out.size(); i++) {
+    lo = std::min<int>(lo, out[i]);
+    hi = std::max<int>(hi, out[i]);
+  }
+  CHECK(hi - lo <= 2 * kDepth / 4);
+  CHECK(lo <= kLevel && hi >= kLevel);
+  printf("  flicker: raw swing %d, filtered swing %d\n", (int)(2 * kDepth), hi - lo);
+}
+
+// a hand over the sensor for one second dims the reading by less than half the dip and it comes back exactly
+static void TestHandShadow() {
+  const uint16_t kLevel = 700, kShadow = 300;
+  std::vector<uint16_t> trace(500, kLevel);
+  trace.resize(500 + 50, kShadow);
+  trace.resize(500 + 50 + 2000, kLevel);
+  std::vector<uint16_t> out = Run(trace);
+  uint16_t lowest = kLevel;
+  for (uint16_t v : out)
+    lowest = std::min(lowest, v);
+  CHECK(lowest < kLevel);
+  CHECK(kLevel - lowest < (kLevel - kShadow) / 2);
+  CHECK_EQ(out.back(), kLevel);
+  printf("  1 s hand shadow %d -> %d dims the filtered value to %d\n", kLevel, kShadow, lowest);
+}
+
+// samples skipped while touch holds the ADC only stretch the blocks, the filter settles on the same level
+static void TestSkippedSamples() {
+  TestRandom rnd(191);
+  AmbientLightFilter all, skipping;
+  all.Reset(100);
+  skipping.Reset(100);
+  int blocks_all = 0, blocks_skipping = 0;
+  for (int i = 0; i < 8000; i++) {
+    uint16_t raw = Clamp(740 + (int)rnd.Range(-5, 5));
+    blocks_all += all.Add(raw);
+    // touch held for runs of up to 10 samples
+    if(rnd.Range(0, 9) < 3) {
+      i += rnd.Range(0, 9);
+      continue;
+    }
+    blocks_skipping += skipping.Add(raw);
+  }
+  CHECK(blocks_skipping < blocks_all);
+  CHECK(abs((int)all.filtered() - 740) <= 2);
+  CHECK(abs((int)skipping.filtered() - 740) <= 2);
+}
+
+// from every 10 bit value to every other the filter settles on exactly the new value, no rounding offset left over
+static void TestSettlesExactly() {
+  for (int from = 0; from <= kAdcMax; from += 31) {
+    for (int to = 0; to <= kAdcMax; to++) {
+      AmbientLightFilter filter;
+      filter.Reset(from);
+      CHECK_EQ(filter.filtered(), from);
+      for (int i = 0; i < 160 * AmbientLightFilter::kDecimation; i++)
+        filter.Add(to);
+      CHECK_EQ(filter.filtered(), to);
+    }
+  }
+}
+
+static void TestSnapshot() {
+  AmbientLightFilter filter;
+  filter.Reset(kAdcMax);
+  filter.Add(3);
+  uint32_t snapshot = filter.Snapshot();
+  CHECK_EQ(AmbientLightFilter::SnapshotRaw(snapshot), 3);
+  CHECK_EQ(AmbientLightFilter::SnapshotFiltered(snapshot), kAdcMax);
+  for (int i = 1; i < AmbientLightFilter::kDecimation; i++)
+    filter.Add(3);
+  snapshot = filter.Snapshot();
+  CHECK_EQ(AmbientLightFilter::SnapshotRaw(snapshot), 3);
+  CHECK_EQ(AmbientLightFilter::SnapshotFiltered(snapshot), filter.filtered());
+  CHECK(filter.filtered() < kAdcMax);
+}
+
+int main() {
+  TestLampSwitched();
+  TestNoiseAndSpikes();
+  TestMainsFlicker();
+  TestHandShadow();
+  TestSkippedSamples();
+  TestSettlesExactly();
+  TestSnapshot();
+  printf("test_ambient_light_filter passed\n");
+  return 0;
+}
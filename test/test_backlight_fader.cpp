@@ -0,0 +1,166 @@
+// BacklightFader: gamma waypoints, segment schedule, retargets mid fade, ambient gate, and the UpdateBacklight loop
+// against a model LEDC whose fade call waits for a running ramp, so a stalled loop shows up as wait time.
+
+#include <stdint.h>
+#include <math.h>
+#include "backlight_fader.h"
+#include "test_util.h"
+
+static const uint16_t kMax = BacklightFader::kDutyMax;
+
+static float Perceived(uint16_t duty) { return powf((float)duty / kMax, 1 / BacklightFader::kGamma); }
+
+// hand out every segment of a fade as it comes due, checking times and gamma steps
+static void TestGammaSegments(uint8_t from, uint8_t to, uint16_t duration_ms) {
+  BacklightFader fader;
+  fader.Start(from, 0, 0);
+  uint16_t start, end, ms;
+  CHECK(fader.NextSegment(0, &start, &end, &ms));
+  CHECK(ms == 0 && end == BacklightFader::LevelToDuty(from));
+
+  const unsigned long t0 = 1000;
+  fader.Start(to, duration_ms, t0);
+  uint16_t prev_end = BacklightFader::LevelToDuty(from);
+  unsigned long total_ms = 0;
+  int segments = 0;
+  float step = (Perceived(BacklightFader::LevelToDuty(to)) - Perceived(BacklightFader::LevelToDuty(from))) / BacklightFader::kSegments;
+  for (unsigned long t = t0; t <= t0 + duration_ms + 10; t++) {
+    while(fader.NextSegment(t, &start, &end, &ms)) {
+      // due exactly when the last one ends, starts where it ended
+      CHECK_EQ(t - t0, total_ms);
+      CHECK_EQ(start, prev_end);
+      // equal steps in perceived brightness, monotonic in duty
+      CHECK(fabsf(Perceived(end) - Perceived(start) - step) < 0.002f);
+      CHECK((to >= from) ? end >= start : end <= start);
+      total_ms += ms;
+      prev_end = end;
+      segments++;
+    }
+    // current duty stays between the waypoints it is ramping through
+    uint16_t now = fader.CurrentDuty(t);
+    CHECK((to >= from) ? now <= prev_end || t >= t0 + duration_ms : now >= prev_end || t >= t0 + duration_ms);
+  }
+  CHECK_EQ(segments, BacklightFader::kSegments);
+  CHECK_EQ(total_ms, duration_ms);
+  CHECK_EQ(prev_end, BacklightFader::LevelToDuty(to));
+  CHECK_EQ(fader.CurrentLevel(t0 + duration_ms), to);
+}
+
+// a new target mid fade starts from where the backlight is, no jump
+static void TestRetarget() {
+  BacklightFader fader;
+  fader.Start(10, 0, 0);
+  uint16_t start, end, ms;
+  fader.NextSegment(0, &start, &end, &ms);
+  fader.Start(250, 800, 0);
+  for (unsigned long t = 0; t < 300; t++)
+    while(fader.NextSegment(t, &start, &end, &ms)) {}
+  uint16_t at = fader.CurrentDuty(300);
+  fader.Start(40, 400, 300);
+  CHECK_EQ(fader.CurrentDuty(300), at);
+  CHECK(fader.NextSegment(300, &start, &end, &ms));
+  CHECK_EQ(start, at);
+  CHECK(end < at);
+  CHECK_EQ(fader.target(), 40);
+}
+
+static void TestAmbientGate() {
+  BacklightFader fader;
+  fader.Start(100, 0, 0);
+  CHECK(fader.AcceptAmbientLevel(100, 0));     // first level always
+  fader.Start(100, 0, 0);
+  CHECK(!fader.AcceptAmbientLevel(105, 10000));   // within 1 + 100 / 16
+  CHECK(fader.AcceptAmbientLevel(108, 10000));
+  fader.Start(108, 0, 10000);
+  CHECK(!fader.AcceptAmbientLevel(200, 12000));   // too soon
+  CHECK(fader.AcceptAmbientLevel(200, 10000 + BacklightFader::kAmbientMinIntervalMs));
+}
+
+// LEDC with one ramp at a time: starting a ramp or writing while one runs waits for it, unless it was stopped
+class ModelLedc {
+public:
+  explicit ModelLedc(bool can_stop) : can_stop_(can_stop) {}
+  void Fade(unsigned long now, uint16_t from, uint16_t to, uint16_t ms) {
+    Wait(now);
+    from_ = from;
+    to_ = to;
+    start_ = now;
+    ms_ = ms;
+  }
+  void Write(unsigned long now, uint16_t duty) { Fade(now, duty, duty, 0); }
+  void Stop(unsigned long now) {
+    CHECK(can_stop_);
+    from_ = to_ = Duty(now);
+    ms_ = 0;
+  }
+  uint16_t Duty(unsigned long now) const {
+    if(now - start_ >= ms_)
+      return to_;
+    return from_ + ((int32_t)to_ - from_) * (int32_t)(now - start_) / ms_;
+  }
+  unsigned long waited_ms = 0;
+
+private:
+  void Wait(unsigned long now) {
+    if(now - start_ < ms_)
+      waited_ms += ms_ - (now - start_);
+  }
+  bool can_stop_;
+  uint16_t from_ = 0, to_ = 0, ms_ = 0;
+  unsigned long start_ = 0;
+};
+
+// RGBDisplay::UpdateBacklight 3.x branch, with and without SOC_LEDC_SUPPORT_FADE_STOP
+static void UpdateBacklight(BacklightFader& fader, ModelLedc& ledc, bool can_stop, unsigned long now) {
+  uint16_t start, end, ms;
+  while(true) {
+    bool ramp_running = fader.RampRunning(now);
+    if(!can_stop && ramp_running)
+      break;
+    if(!fader.NextSegment(now, &start, &end, &ms))
+      break;
+    if(can_stop && ramp_running)
+      ledc.Stop(now);
+    if(ms == 0)
+      ledc.Write(now, end);
+    else
+      ledc.Fade(now, start, end, ms);
+    fader.RampStarted(now, ms);
+  }
+}
+
+static void TestLoopNeverWaits(bool can_stop) {
+  TestRandom rnd(can_stop ? 21 : 22);
+  BacklightFader fader;
+  ModelLedc ledc(can_stop);
+  uint8_t target = 0;
+  unsigned long last_target_ms = 0;
+  for (unsigned long t = 0; t < 120000; t += rnd.Range(1, 40)) {
+    // ambient and time of day retargets at any point of a running fade, wake up jumps now and then
+    if(rnd.Range(0, 60) == 0) {
+      target = rnd.Range(1, 255);
+      fader.Start(target, (rnd.Range(0, 4) == 0 ? 0 : rnd.Range(200, 3000)), t);
+      last_target_ms = t;
+    }
+    UpdateBacklight(fader, ledc, can_stop, t);
+    CHECK_EQ(ledc.waited_ms, 0);
+    // the panel follows the plan within a segment's worth of delay
+    if(t - last_target_ms > 3000 + 3000 / BacklightFader::kSegments + 50)
+      CHECK_EQ(ledc.Duty(t), BacklightFader::LevelToDuty(target));
+  }
+  printf("  fade stop %d: no loop waits over 2 minutes of retargets\n", can_stop);
+}
+
+int main() {
+  CHECK_EQ(BacklightFader::LevelToDuty(0), 0);
+  CHECK_EQ(BacklightFader::LevelToDuty(255), kMax);
+  TestGammaSegments(0, 255, 2000);
+  TestGammaSegments(255, 5, 800);
+  TestGammaSegments(40, 60, 1000);
+  TestRetarget();
+  TestAmbientGate();
+  TestLoopNeverWaits(true);
+  TestLoopNeverWaits(false);
+  printf("test_backlight_fader passed\n");
+  return 0;
+}
@@ -0,0 +1,124 @@
+// CanvasArena soak: 100k frames of screensaver and main page time row drawing, the way RGBDisplay borrows its 1 bit
+// canvases, with every malloc, calloc, realloc and free counted. After boot setup the frames make no heap calls at
+// all; only a canvas larger than the arena does, and it shows up in misses().
+// The counting hooks replace glibc's allocator entry points, so this test needs a glibc host.
+
+#include <stdint.h>
+#include <string.h>
+#include <Adafruit_GFX.h>
+#include "Fonts/ComingSoon_Regular70pt7b_numbers_only.h"
+#include "Fonts/Satisfy_Regular18pt7b.h"
+#include "Fonts/Satisfy_Regular24pt7b.h"
+#include "general_constants.h"
+#include "gfx_canvases.h"
+#include "time_row_draw.h"
+#include "test_util.h"
+
+static long heap_calls = 0;
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+// operator new and delete end up here too
+void* malloc(size_t size) { heap_calls++; return __libc_malloc(size); }
+void* calloc(size_t n, size_t size) { heap_calls++; return __libc_calloc(n, size); }
+void* realloc(void* ptr, size_t size) { heap_calls++; return __libc_realloc(ptr, size); }
+void free(void* ptr) {
+  if(ptr != NULL)
+    heap_calls++;
+  __libc_free(ptr);
+}
+}
+
+static const size_t kArenaBytes = ((kTftWidth + 7) / 8) * kTftHeight;
+static uint8_t arena_buffer[kArenaBytes];
+static const uint8_t kBell[] = { 0x18, 0x3C, 0x3C, 0x7E, 0x7E, 0xFF, 0x18, 0x00 };
+
+// RGBDisplay::Screensaver: a new canvas each color change, HH:MM from the atlas, date text and the bell
+static void ScreensaverFrame(CanvasArena& arena, GlyphAtlas& atlas, TestRandom& rnd, int frame) {
+  if(frame % 7 == 0 || arena.canvas() == NULL) {
+    GFXcanvas1* canvas = arena.Borrow(rnd.Range(180, kTftWidth), rnd.Range(110, 200));
+    canvas->setTextWrap(false);
+    canvas->fillScreen(0);
+    canvas->setFont(&ComingSoon_Regular70pt7b);
+    canvas->setCursor(rnd.Range(0, 20), rnd.Range(90, 110));
+    char hhmm[kHHMM_ArraySize];
+    snprintf(hhmm, sizeof(hhmm), "%d:%02d", frame / 60 % 12 + 1, frame % 60);
+    atlas.Print(canvas, hhmm, 1);
+    canvas->setFont(frame % 2 ? &Satisfy_Regular24pt7b : &Satisfy_Regular18pt7b);
+    canvas->setCursor(rnd.Range(0, 20), canvas->height() - 10);
+    canvas->print("Sat, Oct 17");
+    canvas->drawBitmap(canvas->getCursorX() + 4, canvas->height() - 20, kBell, 8, 8, 1);
+    canvas->drawRect(0, 0, canvas->width(), canvas->height(), 1);
+  }
+}
+
+// RGBDisplay::DisplayTimeUpdate: the time row canvas, full width or from the first changed column
+static void TimeRowFrame(CanvasArena& arena, int frame) {
+  RowText r = MakeRow(frame % 86400, frame / 86400 % 2);
+  int16_t canvas_x0 = (frame % 60 == 0 ? 0 : r.hh_x0 + 120);
+  GFXcanvas1* canvas = arena.Borrow(kTftWidth - canvas_x0, kRowH);
+  DrawTimeRow(*canvas, canvas_x0, r);
+  arena.Return();
+}
+
+static void TestSoak() {
+  CanvasArena arena(arena_buffer, kArenaBytes);
+  GlyphAtlas atlas;
+  // boot: the atlas is the one heap allocation
+  CHECK(atlas.Build(&ComingSoon_Regular70pt7b));
+  TestRandom rnd(4);
+  uint32_t sum = 0;
+
+  const int kFrames = 100000;
+  heap_calls = 0;
+  for (int frame = 0; frame < kFrames; frame++) {
+    // a page change returns the screensaver canvas, as ScreensaverControl(false) does
+    if(frame % 1000 < 500)
+      ScreensaverFrame(arena, atlas, rnd, frame);
+    else {
+      if(frame % 1000 == 500)
+        arena.Return();
+      TimeRowFrame(arena, frame);
+    }
+    sum += arena_buffer[frame % kArenaBytes];
+  }
+  long soak_heap_calls = heap_calls;
+  CHECK_EQ(soak_heap_calls, 0);
+  CHECK_EQ(arena.misses(), 0);
+  printf("  %d frames, %ld heap calls, checksum %u\n", kFrames, soak_heap_calls, sum);
+}
+
+// a canvas past the arena is heap allocated and freed, the hooks see it
+static void TestMissUsesHeap() {
+  CanvasArena arena(arena_buffer, kArenaBytes);
+  heap_calls = 0;
+  GFXcanvas1* canvas = arena.Borrow(kTftWidth, kTftHeight + 1);
+  CHECK(canvas != NULL && canvas->getBuffer() != arena_buffer);
+  CHECK_EQ(arena.misses(), 1);
+  CHECK(heap_calls >= 2);
+  long borrow_calls = heap_calls;
+  arena.Return();
+  CHECK(arena.canvas() == NULL);
+  CHECK_EQ(heap_calls, 2 * borrow_calls);
+
+  // the largest canvas that fits stays in the arena
+  heap_calls = 0;
+  canvas = arena.Borrow(kTftWidth, kTftHeight);
+  CHECK(canvas->getBuffer() == arena_buffer);
+  canvas = arena.Borrow(1, 1);
+  CHECK(canvas->getBuffer() == arena_buffer && canvas->width() == 1);
+  arena.Return();
+  CHECK_EQ(heap_calls, 0);
+  CHECK_EQ(arena.misses(), 1);
+}
+
+int main() {
+  TestSoak();
+  TestMissUsesHeap();
+  printf("test_canvas_arena_soak passed\n");
+  return 0;
+}
@@ -0,0 +1,110 @@
+// ClockTime::Tick over ten years of seconds against gmtime: every rollover, leap days including 2000 and the skipped
+// one in 2100, week day, and the new minute flag. Then the SQW ticks through the event ring to a loop that drains them
+// late, which must still see every new hour once.
+
+#include <stdint.h>
+#include <time.h>
+#include "clock_time.h"
+#include "isr_event_ring.h"
+#include "test_util.h"
+
+static void CheckSame(const ClockTime& t, time_t epoch) {
+  struct tm tm;
+  gmtime_r(&epoch, &tm);
+  CHECK_EQ(t.year, tm.tm_year + 1900);
+  CHECK_EQ(t.month, tm.tm_mon + 1);
+  CHECK_EQ(t.day, tm.tm_mday);
+  CHECK_EQ(t.hour, tm.tm_hour);
+  CHECK_EQ(t.minute, tm.tm_min);
+  CHECK_EQ(t.second, tm.tm_sec);
+  CHECK_EQ(t.day_of_week, tm.tm_wday + 1);
+}
+
+static ClockTime FromEpoch(time_t epoch) {
+  struct tm tm;
+  gmtime_r(&epoch, &tm);
+  ClockTime t;
+  t.year = tm.tm_year + 1900;
+  t.month = tm.tm_mon + 1;
+  t.day = tm.tm_mday;
+  t.hour = tm.tm_hour;
+  t.minute = tm.tm_min;
+  t.second = tm.tm_sec;
+  t.day_of_week = tm.tm_wday + 1;
+  return t;
+}
+
+// tick every second for years from epoch, compare in full on every new minute
+static void TickYears(time_t epoch, int years) {
+  ClockTime t = FromEpoch(epoch);
+  CheckSame(t, epoch);
+  time_t end = epoch + (time_t)years * 365 * 86400;
+  uint32_t minutes = 0, leap_days = 0;
+  for (time_t now = epoch + 1; now <= end; now++) {
+    bool new_minute = t.Tick();
+    CHECK_EQ(new_minute, t.second == 0);
+    if(new_minute) {
+      minutes++;
+      CheckSame(t, now);
+      if(t.month == 2 && t.day == 29 && t.hour == 0 && t.minute == 0)
+        leap_days++;
+    }
+  }
+  CheckSame(t, end);
+  printf("  %d years from %lld: %u minutes, %u leap days\n", years, (long long)epoch, minutes, leap_days);
+}
+
+// ISR side ticks and queues like RTC::SecondsUpdateInterruptISR, loop drains like RTC::NextSqwEvent but only every so
+// often: gaps of a second to 63 s (a full ring), the long ones past the minute the hour started on. Every hour start must
+// be seen exactly once from the tick's own minute. Reading the clock minute at drain time instead misses the hours it is
+// late for, and checks twice when a late minute 59 tick drains in minute 0
+static void TestLateDrain() {
+  ClockTime clock = FromEpoch(1700000000);
+  IsrEventRing<ClockTick, 64> ring;
+  TestRandom rnd(3600);
+  static const uint32_t kGaps[] = { 1, 2, 5, 30, 63 };
+  uint32_t micros = 0, hours = 0, seen = 0, missed_at_drain = 0, extra_at_drain = 0;
+  const uint32_t kSeconds = 30 * 86400;
+  uint32_t next_drain = 1;
+  for (uint32_t s = 1; s <= kSeconds; s++) {
+    micros += 1000000;
+    bool new_minute = clock.Tick();
+    CHECK(ring.Push({micros, new_minute, clock.minute}));
+    if(new_minute && clock.minute == 0)
+      hours++;
+    if(s < next_drain && s != kSeconds)
+      continue;
+    next_drain = s + kGaps[rnd.Range(0, 4)];
+    ClockTick tick;
+    while(ring.Pop(&tick)) {
+      if(tick.new_hour())
+        seen++;
+      bool at_drain = tick.new_minute && clock.minute == 0;
+      if(tick.new_hour() && !at_drain)
+        missed_at_drain++;
+      if(!tick.new_hour() && at_drain)
+        extra_at_drain++;
+    }
+  }
+  CHECK_EQ(hours, 30 * 24);
+  CHECK_EQ(seen, hours);
+  CHECK(missed_at_drain > 0 && extra_at_drain > 0);
+  printf("  %u hours, drains up to 63 s late: %u checks from the tick's minute, from the minute at drain %u missed and %u extra\n", hours, seen, missed_at_drain, extra_at_drain);
+}
+
+int main() {
+  CHECK(!ClockTime::IsLeapYear(2100) && ClockTime::IsLeapYear(2000) && ClockTime::IsLeapYear(2024) && !ClockTime::IsLeapYear(2023));
+  for (uint8_t month = 1; month <= 12; month++) {
+    static const uint8_t kDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    CHECK_EQ(ClockTime::DaysInMonth(2023, month), kDays[month - 1]);
+  }
+  // default is the 1 Jan 2000 the RTC HW starts from
+  CheckSame(ClockTime(), 946684800);
+  // 31 Dec 1999 23:59:59 into 2000, a 400 year leap year, for ten years
+  TickYears(946684799, 10);
+  // across 2100, not a leap year
+  TickYears(4102444800LL - 86400LL * 365 * 5, 10);
+  TestLateDrain();
+  printf("test_clock_time passed\n");
+  return 0;
+}
@@ -0,0 +1,256 @@
+// DrawList: a page recorded once and replayed band by band onto PaletteCanvas4 comes out the same as drawing the
+// page again for every band, the way DisplayCurrentPage used to, and the same as drawing it whole on a GFXcanvas16.
+// Checked for every settings page at every cursor position with the button pressed and not, and for random
+// shapes and text that run off the screen and have negative sizes. Each band replays only the calls that reach it.
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMono9pt7b.h"
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeSans12pt7b.h"
+#include "general_constants.h"
+#include "page_layout.h"
+#include "draw_list.h"
+#include "palette_canvas4.h"
+#include "test_util.h"
+
+// colors as in rgb_display.h
+static const uint16_t kBlack = 0x0000, kBlue = 0x001F, kRed = 0xF800, kOrange = 0xfca0, kGreen = 0x07E0, kCyan = 0x07FF, kYellow = 0xFFE0;
+
+// band height DisplayCurrentPage gets from the canvas arena
+static const int16_t kBandRows = ((kTftWidth + 7) / 8) * kTftHeight / ((kTftWidth + 1) / 2);
+static const size_t kArenaBytes = ((kTftWidth + 7) / 8) * kTftHeight;
+
+// settings pages as the tables in long_press_alarm_clock.ino list them, values at their longest
+struct TestButton {
+  const char* label;
+  const char* value;
+  bool label_only;
+  const ButtonRect* fixed;
+};
+struct TestPage {
+  const char* title;
+  std::vector<TestButton> buttons;
+  const char* footer[3];
+};
+static const TestButton kBack = { "", kBackStr, false, &PageLayout::kBackButton };
+static const TestButton kSave = { "", kSaveStr, false, &PageLayout::kSaveButton };
+static const std::vector<TestPage> kPages = {
+  { "MAIN SETTINGS PAGE", {
+      { "WiFi Settings:", "WIFI", false, NULL }, { "Location Settings:", "LOCATION", false, NULL },
+      { "Long Press / Alarm Snooze Hold Time:", "25sec", false, NULL }, { "Set RGB LEDs &:", "SCREENSAVER", false, NULL },
+      { "Rotate Screen:", "ROTATE", false, NULL }, { "Firmware Update:", "UPDATE", false, NULL }, kBack },
+    { "Firmware: 3.2", "Date: 2024-11-02", NULL } },
+  { "WIFI SETTINGS PAGE", {
+      { "Saved WiFi:", "WWWWWWWWWWWWWWWW", true, NULL }, { "Scan Networks:", "SCAN WIFI", false, NULL },
+      { "Change Password:", "WIFI PASSWD", false, NULL }, { "Clear WiFi Details:", "CLEAR", false, NULL },
+      { "", "CONNECT WIFI", false, NULL }, { "", "DISCONNECT", false, NULL }, kBack },
+    { "Could not", "connect to saved", "WiFi Network." } },
+  { "", {
+      { "", kRescanStr, false, &PageLayout::kRescanButton }, { "", kNextStr, false, &PageLayout::kNextButton }, kBack },
+    { NULL, NULL, NULL } },
+  { "", { kSave, kBack }, { NULL, NULL, NULL } },
+  { "LOCATION & WEATHER SETTINGS", {
+      { "City:", "560001 IN", false, NULL }, { "Set Units:", kImperialUnitStr, false, NULL },
+      { "Fetch Weather:", "FETCH", false, NULL }, { "Time-Zone:", "UPDATE TIME", false, NULL }, kBack },
+    { "Clouds : overcast clouds", "Temp: 21.3C  Feels: 20.9C", "Wind: 3.1m/s Humidity: 81%" } },
+  { "SCREENSAVER SETTINGS PAGE", {
+      { "Screensaver Motion:", kFlyOutScreensaverStr, false, NULL }, { "Screensaver Speed:", kMediumStr, false, NULL },
+      { "Run Screensaver:", "RUN", false, NULL }, { "RGB LEDs Mode:", kSunDownStr, false, NULL },
+      { "Evening time is 6PM to:", "12PM", false, NULL }, { "RGB LEDs Brightness:", "100%", false, NULL }, kBack },
+    { NULL, NULL, NULL } },
+};
+
+static ButtonRect Rect(Adafruit_GFX& gfx, const TestButton& button, int i) {
+  if(button.fixed != NULL)
+    return *button.fixed;
+  int16_t x1, y1;
+  uint16_t w, h;
+  gfx.setFont(&FreeMonoBold9pt7b);
+  gfx.getTextBounds(button.value, 0, PageLayout::RowTextY0(i), &x1, &y1, &w, &h);
+  return PageLayout::RowButton(i, w, h, button.label_only);
+}
+
+// the calls DrawCurrentPage makes: title, rows with button face, label and highlight rings, footer text
+static void DrawPage(Adafruit_GFX& gfx, const TestPage& page, int cursor, bool is_on) {
+  gfx.setFont(&FreeMonoBold9pt7b);
+  gfx.setTextColor(kGreen);
+  gfx.setCursor(kDisplayTextGap, 20);
+  gfx.print(page.title);
+  for (int i = 0; i < (int)page.buttons.size(); i++) {
+    const TestButton& button = page.buttons[i];
+    int16_t row_text_y0 = PageLayout::RowTextY0(i);
+    if(strlen(button.label) > 0)
+      gfx.fillRect(0, row_text_y0 - 20, kTftWidth, kPageRowHeight, kBlack);
+    ButtonRect rect = Rect(gfx, button, i);
+    gfx.setFont(&FreeMonoBold9pt7b);
+    if(button.label_only) {
+      gfx.setTextColor(kGreen);
+      gfx.setCursor(rect.x, row_text_y0);
+    }
+    else {
+      gfx.setTextColor(kBlack);
+      gfx.fillRoundRect(rect.x, rect.y, rect.w, rect.h, kRadiusButtonRoundRect, (is_on && i == cursor ? kRed : kOrange));
+      gfx.drawRoundRect(rect.x, rect.y, rect.w, rect.h, kRadiusButtonRoundRect, kCyan);
+      gfx.setCursor(rect.x + kDisplayTextGap, (button.fixed != NULL ? rect.y + rect.h - kDisplayTextGap : row_text_y0));
+    }
+    gfx.print(button.value);
+    if(strlen(button.label) > 0) {
+      int16_t x1, y1;
+      uint16_t w, h;
+      gfx.setFont(&FreeMono9pt7b);
+      gfx.setTextColor(kYellow);
+      gfx.getTextBounds(button.label, 0, row_text_y0, &x1, &y1, &w, &h);
+      if(w + kDisplayTextGap <= rect.x - kDisplayTextGap) {
+        gfx.setCursor(kDisplayTextGap, row_text_y0);
+        gfx.print(button.label);
+      }
+      else {
+        size_t half = strlen(button.label) / 2;
+        gfx.setCursor(kDisplayTextGap, row_text_y0 - 10);
+        gfx.print(std::string(button.label, half).c_str());
+        gfx.setCursor(kDisplayTextGap, row_text_y0 + 5);
+        gfx.print(button.label + half);
+      }
+    }
+    for (int16_t ring = 1; ring <= 2; ring++) {
+      ButtonRect r = rect.Grown(ring);
+      gfx.drawRoundRect(r.x, r.y, r.w, r.h, kRadiusButtonRoundRect, (i == cursor ? kCyan : kBlack));
+    }
+  }
+  gfx.setTextColor(kBlue);
+  for (int k = 0; k < 3; k++) {
+    if(page.footer[k] == NULL)
+      continue;
+    gfx.setFont(k == 0 ? &FreeSans12pt7b : &FreeMono9pt7b);
+    gfx.setCursor(kDisplayTextGap, 170 + 20 * k);
+    gfx.print(page.footer[k]);
+  }
+}
+
+typedef std::vector<uint16_t> Screen;
+
+// the old banded path: the whole page drawn again for each band
+template <class Draw>
+static Screen BandsRedrawn(Draw draw) {
+  std::vector<uint8_t> arena(kArenaBytes);
+  PaletteCanvas4 canvas(kTftWidth, kTftHeight, arena.data(), arena.size());
+  Screen screen(kTftWidth * kTftHeight);
+  for (int16_t band_y0 = 0; band_y0 < kTftHeight; band_y0 += kBandRows) {
+    canvas.SetBand(band_y0, std::min<int>(kBandRows, kTftHeight - band_y0));
+    canvas.fillScreen(kBlack);
+    draw(canvas);
+    for (int16_t j = 0; j < canvas.band_h(); j++)
+      canvas.ExpandRow(j, &screen[(band_y0 + j) * kTftWidth]);
+  }
+  return screen;
+}
+
+// the new one: recorded once, replayed per band, counting the calls sent to the bands
+static Screen BandsReplayed(DrawList& list, size_t* replayed_out = NULL) {
+  std::vector<uint8_t> arena(kArenaBytes);
+  PaletteCanvas4 canvas(kTftWidth, kTftHeight, arena.data(), arena.size());
+  Screen screen(kTftWidth * kTftHeight);
+  size_t replayed = 0;
+  for (int16_t band_y0 = 0; band_y0 < kTftHeight; band_y0 += kBandRows) {
+    canvas.SetBand(band_y0, std::min<int>(kBandRows, kTftHeight - band_y0));
+    canvas.fillScreen(kBlack);
+    list.Replay(canvas, band_y0, canvas.band_h());
+    CHECK(list.replayed() <= list.size());
+    replayed += list.replayed();
+    for (int16_t j = 0; j < canvas.band_h(); j++)
+      canvas.ExpandRow(j, &screen[(band_y0 + j) * kTftWidth]);
+  }
+  if(replayed_out != NULL)
+    *replayed_out = replayed;
+  return screen;
+}
+
+template <class Draw>
+static Screen Whole(Draw draw) {
+  GFXcanvas16 canvas(kTftWidth, kTftHeight);
+  canvas.setTextWrap(false);
+  canvas.fillScreen(kBlack);
+  draw(canvas);
+  return Screen(canvas.getBuffer(), canvas.getBuffer() + kTftWidth * kTftHeight);
+}
+
+static void TestPages() {
+  DrawList list(kTftWidth, kTftHeight);
+  int checked = 0;
+  size_t most_calls = 0, calls = 0, replayed_calls = 0;
+  for (const TestPage& page : kPages) {
+    for (int cursor = -1; cursor < (int)page.buttons.size(); cursor++) {
+      for (bool is_on : { false, true }) {
+        auto draw = [&](Adafruit_GFX& gfx) { DrawPage(gfx, page, cursor, is_on); };
+        list.Clear();
+        draw(list);
+        most_calls = std::max(most_calls, list.size());
+        size_t replayed_calls_now;
+        Screen replayed = BandsReplayed(list, &replayed_calls_now);
+        // each call goes to the bands it reaches, only those spanning a band edge go to two
+        CHECK(replayed_calls_now >= list.size() && replayed_calls_now < list.size() * 5 / 4);
+        calls += list.size();
+        replayed_calls += replayed_calls_now;
+        CHECK(replayed == BandsRedrawn(draw));
+        CHECK(replayed == Whole(draw));
+        checked++;
+      }
+    }
+  }
+  printf("  %d page and cursor states in bands of %d rows, up to %zu recorded calls, %zu%% replayed to a second band\n", checked, kBandRows, most_calls, (replayed_calls - calls) * 100 / calls);
+}
+
+static void DrawRandom(Adafruit_GFX& gfx, uint32_t seed) {
+  TestRandom rnd(seed);
+  static const uint16_t kColors[] = { kBlack, kBlue, kRed, kOrange, kGreen, kCyan, kYellow, 0xFFFF };
+  static const GFXfont* const kFonts[] = { &FreeMono9pt7b, &FreeMonoBold9pt7b, &FreeSans12pt7b };
+  for (int k = 0; k < 80; k++) {
+    int16_t x = rnd.Range(-40, kTftWidth + 20), y = rnd.Range(-40, kTftHeight + 20);
+    uint16_t color = kColors[rnd.Range(0, 7)];
+    switch (rnd.Range(0, 9)) {
+      case 0: gfx.drawPixel(x, y, color); break;
+      case 1: gfx.drawFastHLine(x, y, rnd.Range(-40, 80), color); break;
+      case 2: gfx.drawFastVLine(x, y, rnd.Range(-40, 80), color); break;
+      case 3: gfx.fillRect(x, y, rnd.Range(-20, 100), rnd.Range(-20, 100), color); break;
+      case 4: gfx.drawLine(x, y, rnd.Range(-40, kTftWidth + 40), rnd.Range(-40, kTftHeight + 40), color); break;
+      case 5: gfx.fillCircle(x, y, rnd.Range(0, 40), color); break;
+      case 6: gfx.fillRoundRect(x, y, rnd.Range(12, 120), rnd.Range(12, 80), 5, color); break;
+      case 7: gfx.fillScreen(color); break;
+      default:
+        gfx.setFont(kFonts[rnd.Range(0, 2)]);
+        gfx.setTextColor(color);
+        gfx.setCursor(x, y);
+        gfx.print("gjy Wi-Fi\r 12:34|");
+        gfx.print(rnd.Range(0, 99999));
+        break;
+    }
+  }
+}
+
+static void TestRandomDrawing() {
+  DrawList list(kTftWidth, kTftHeight);
+  TestRandom rnd(11);
+  for (int trial = 0; trial < 60; trial++) {
+    uint32_t seed = rnd.Next();
+    auto draw = [&](Adafruit_GFX& gfx) { DrawRandom(gfx, seed); };
+    list.Clear();
+    draw(list);
+    Screen replayed = BandsReplayed(list);
+    CHECK(replayed == BandsRedrawn(draw));
+    // replayed whole in one band onto a canvas that draws negative sizes its own way
+    GFXcanvas16 canvas(kTftWidth, kTftHeight);
+    canvas.fillScreen(kBlack);
+    list.Replay(canvas, 0, kTftHeight);
+    CHECK(Screen(canvas.getBuffer(), canvas.getBuffer() + kTftWidth * kTftHeight) == Whole(draw));
+  }
+}
+
+int main() {
+  TestPages();
+  TestRandomDrawing();
+  printf("test_draw_list passed\n");
+  return 0;
+}
@@ -0,0 +1,81 @@
+// GlyphAtlas::Print against Adafruit_GFX print of the same font into a GFXcanvas1, pixels and cursor
+
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeSansBold48pt7b_numbers_only.h"
+#include "Fonts/ComingSoon_Regular70pt7b_numbers_only.h"
+#include "gfx_canvases.h"
+#include "test_util.h"
+
+static void RandomFill(TestRandom& rnd, GFXcanvas1& canvas) {
+  int bytes = ((canvas.width() + 7) / 8) * canvas.height();
+  uint8_t* buffer = canvas.getBuffer();
+  int kind = rnd.Range(0, 2);
+  for (int i = 0; i < bytes; i++)
+    buffer[i] = (kind == 0 ? 0x00 : (kind == 1 ? 0xFF : (uint8_t)rnd.Next()));
+}
+
+static void CheckSame(const GFXcanvas1& a, const GFXcanvas1& b) {
+  CHECK_EQ(a.getCursorX(), b.getCursorX());
+  CHECK_EQ(a.getCursorY(), b.getCursorY());
+  for (int16_t y = 0; y < a.height(); y++)
+    for (int16_t x = 0; x < a.width(); x++)
+      CHECK_EQ(a.getPixel(x, y), b.getPixel(x, y));
+}
+
+// time strings and stray characters at random cursors, clipped on every side, set and clear color
+static void TestPrintMatchesGfx(const GFXfont* font) {
+  TestRandom rnd(5);
+  GlyphAtlas atlas;
+  CHECK(atlas.Build(font));
+  CHECK(atlas.bytes() > 0);
+  // the numbers only fonts hold bitmaps for digits, ':' and space, space goes through the fallback
+  const char kChars[] = "0123456789:: ";
+  for (int trial = 0; trial < 1500; trial++) {
+    int16_t w = rnd.Range(8, 330), h = rnd.Range(8, 130);
+    char str[8];
+    int len = rnd.Range(1, 6);
+    for (int i = 0; i < len; i++)
+      str[i] = kChars[rnd.Range(0, sizeof(kChars) - 2)];
+    str[len] = '\0';
+    uint16_t color = (trial % 4 == 3 ? 0 : 1);
+    int16_t cx = rnd.Range(-120, w), cy = rnd.Range(-20, h + 100);
+
+    GFXcanvas1 ref(w, h), out(w, h);
+    RandomFill(rnd, ref);
+    memcpy(out.getBuffer(), ref.getBuffer(), ((w + 7) / 8) * h);
+    for (GFXcanvas1* c : {&ref, &out}) {
+      c->setTextWrap(false);
+      c->setFont(font);
+      c->setTextColor(color);
+      c->setCursor(cx, cy);
+    }
+    ref.print(str);
+    atlas.Print(&out, str, color);
+    CheckSame(ref, out);
+  }
+}
+
+// rotated canvases fall back to regular glyph printing
+static void TestRotatedFallsBack() {
+  GlyphAtlas atlas;
+  CHECK(atlas.Build(&FreeSansBold48pt7b));
+  GFXcanvas1 ref(120, 200), out(120, 200);
+  for (GFXcanvas1* c : {&ref, &out}) {
+    c->setRotation(1);
+    c->setTextWrap(false);
+    c->setFont(&FreeSansBold48pt7b);
+    c->setTextColor(1);
+    c->setCursor(3, 90);
+  }
+  ref.print("12:34");
+  atlas.Print(&out, "12:34", 1);
+  CheckSame(ref, out);
+}
+
+int main() {
+  TestPrintMatchesGfx(&FreeSansBold48pt7b);
+  TestPrintMatchesGfx(&ComingSoon_Regular70pt7b);
+  TestRotatedFallsBack();
+  printf("test_glyph_atlas passed\n");
+  return 0;
+}
@@ -0,0 +1,224 @@
+// Hardware scroll address arithmetic per controller and screen_orientation_, and a fly through simulation: the screen
+// seen through the scroll offset must always equal a plain blit of the canvas at its screen x, off screen gap included.
+
+#include <stdint.h>
+#include <vector>
+#include "general_constants.h"
+#include "two_color_blit.h"
+#include "hw_scroll.h"
+#include "test_util.h"
+#include "mock_panel.h"
+
+static const int16_t kGapBand = 5;          // GAP_BAND in Screensaver()
+static const uint16_t kBg = 0x0000;
+
+// memory line a setAddrWindow column lands on
+static int16_t MemoryLine(int16_t memory_x, uint8_t madctl) {
+  return ((madctl & HwScroll::kMadctlMY) ? kTftWidth - 1 - memory_x : memory_x);
+}
+
+// screen x of content written at memory column memory_x with scroll start address s: physical line L shows memory
+// line (L + s) mod ring, and with s = 0 a column shows where it was addressed
+static int16_t ModelScreenX(int16_t memory_x, uint16_t s, uint8_t madctl) {
+  int16_t line = HwScroll::PositiveMod((int32_t)MemoryLine(memory_x, madctl) - s, kTftWidth);
+  for (int16_t x = 0; x < kTftWidth; x++)
+    if(MemoryLine(x, madctl) == line)
+      return x;
+  return -1;
+}
+
+static void TestOrientations() {
+  // screen_orientation_ is 1 or 3
+  struct { bool st7789; uint8_t rotation; int8_t direction; } cases[] = {
+    { true, 1, -1 }, { true, 3, 1 }, { false, 1, 1 }, { false, 3, -1 },
+  };
+  for (auto& c : cases) {
+    uint8_t madctl = HwScroll::Madctl(c.st7789, c.rotation);
+    CHECK(madctl & HwScroll::kMadctlMV);
+    int8_t direction = HwScroll::Direction(madctl);
+    CHECK_EQ(direction, c.direction);
+    for (uint16_t s = 0; s < kTftWidth; s += 7)
+      for (int16_t m = 0; m < kTftWidth; m++) {
+        int16_t screen_x = ModelScreenX(m, s, madctl);
+        CHECK_EQ(HwScroll::PositiveMod(m - direction * (int32_t)s, kTftWidth), screen_x);
+        CHECK_EQ(HwScroll::MemoryX(screen_x, s, direction, kTftWidth), m);
+        CHECK_EQ(HwScroll::Offset(screen_x, m, direction, kTftWidth), s);
+      }
+    // screen x off the ring wraps like the memory does
+    for (int16_t screen_x = -2 * kTftWidth; screen_x < 2 * kTftWidth; screen_x += 13) {
+      uint16_t s = HwScroll::Offset(screen_x, 100, direction, kTftWidth);
+      CHECK_EQ(ModelScreenX(100, s, madctl), HwScroll::PositiveMod(screen_x, kTftWidth));
+    }
+  }
+}
+
+static void TestVisibleColumns() {
+  int16_t c0, c1;
+  HwScroll::VisibleColumns(-30, 200, kTftWidth, &c0, &c1);
+  CHECK(c0 == 30 && c1 == 200);
+  HwScroll::VisibleColumns(250, 200, kTftWidth, &c0, &c1);
+  CHECK(c0 == 0 && c1 == 70);
+  HwScroll::VisibleColumns(kTftWidth, 200, kTftWidth, &c0, &c1);
+  CHECK(c0 == 0 && c1 == 0);
+  HwScroll::VisibleColumns(-kTftWidth, 200, kTftWidth, &c0, &c1);
+  CHECK(c0 == 0 && c1 == 0);
+
+  HwScroll::Plan plan = HwScroll::ColumnPlan(30, 200, 33, 200);
+  CHECK(plan.erase_count == 1 && plan.erase[0][0] == 30 && plan.erase[0][1] == 33);
+  CHECK(plan.draw_count == 0 && plan.keep[0] == 33 && plan.keep[1] == 200);
+  plan = HwScroll::ColumnPlan(0, 0, 0, 4);
+  CHECK(plan.erase_count == 0 && plan.draw_count == 1 && plan.draw[0][1] == 4 && plan.keep[0] == plan.keep[1]);
+}
+
+struct Canvas {
+  int16_t w, h;
+  std::vector<uint8_t> bits;
+  uint16_t color;
+};
+
+static Canvas MakeCanvas(TestRandom& rnd) {
+  Canvas c;
+  c.w = rnd.Range(150, 210);
+  c.h = rnd.Range(100, 130);
+  c.color = (uint16_t)(rnd.Next() | 1);
+  int16_t row_bytes = (c.w + 7) / 8;
+  c.bits.assign(row_bytes * c.h, 0);
+  for (int16_t y = kGapBand; y < c.h - kGapBand; y++)
+    for (int16_t x = kGapBand; x < c.w - kGapBand; x++)
+      if(((x / 7 + y / 11) & 1) && (rnd.Next() & 7))
+        c.bits[y * row_bytes + x / 8] |= 0x80 >> (x & 7);
+  return c;
+}
+
+// RGBDisplay::HwScrollPaste on panel memory
+class HwScrollSim {
+public:
+  explicit HwScrollSim(int8_t direction) : memory(kTftWidth, kTftHeight, kBg), direction_(direction) {}
+
+  void Paste(const Canvas& c, int16_t x1, int16_t y1, bool same_canvas) {
+    lut_.Set(c.color, kBg);
+    int16_t col0, col1;
+    HwScroll::VisibleColumns(x1, c.w, kTftWidth, &col0, &col1);
+    if(!same_canvas) {
+      Columns(c, col0_, col1_, canvas_y_, true);
+      canvas_x_ = HwScroll::MemoryX(x1, offset, direction_, kTftWidth);
+      canvas_h_ = c.h;
+      Columns(c, col0, col1, y1, false);
+    }
+    else {
+      HwScroll::Plan plan = HwScroll::ColumnPlan(col0_, col1_, col0, col1);
+      for (uint8_t i = 0; i < plan.erase_count; i++)
+        Columns(c, plan.erase[i][0], plan.erase[i][1], canvas_y_, true);
+      if(plan.keep[0] < plan.keep[1] && y1 != canvas_y_)
+        for (int16_t memory_x = canvas_x_; memory_x > -kTftWidth; memory_x -= kTftWidth)
+          MotionBlitTwoColorBitmap<kTftWidth>(memory, lut_, kTftHeight, memory_x, y1, memory_x, canvas_y_, c.bits.data(), c.w, c.h, plan.keep[0], plan.keep[1]);
+      for (uint8_t i = 0; i < plan.draw_count; i++)
+        Columns(c, plan.draw[i][0], plan.draw[i][1], y1, false);
+    }
+    col0_ = col0;
+    col1_ = col1;
+    canvas_y_ = y1;
+    offset = HwScroll::Offset(x1, canvas_x_, direction_, kTftWidth);
+  }
+
+  // what the screen shows at x, y
+  uint16_t Screen(int16_t x, int16_t y) const {
+    return memory.Pixel(HwScroll::MemoryX(x, offset, direction_, kTftWidth), y);
+  }
+
+  MockPanel memory;
+  uint16_t offset = 0;
+
+private:
+  void Columns(const Canvas& c, int16_t col0, int16_t col1, int16_t y, bool erase) {
+    if(col0 >= col1)
+      return;
+    for (int16_t memory_x = canvas_x_; memory_x > -kTftWidth; memory_x -= kTftWidth) {
+      if(erase) {
+        for (int16_t py = y; py < y + canvas_h_; py++)
+          for (int16_t px = memory_x + col0; px < memory_x + col1; px++)
+            if(px >= 0 && py >= 0 && px < kTftWidth && py < kTftHeight) {
+              uint16_t bg = kBg;
+              memory.SetWindow(px, py, 1, 1);
+              memory.WritePixels(&bg, 1);
+            }
+      }
+      else
+        BlitTwoColorBitmap(memory, lut_, kTftWidth, kTftHeight, memory_x, y, c.bits.data(), c.w, c.h, col0, col1);
+    }
+  }
+
+  int8_t direction_;
+  TwoColorLut lut_;
+  int16_t canvas_x_ = 0, canvas_y_ = 0, canvas_h_ = 0, col0_ = 0, col1_ = 0;
+};
+
+// screen through the scroll offset equals bg plus the canvas clipped at (x1, y1)
+static void CheckScreen(const HwScrollSim& sim, const Canvas& c, int16_t x1, int16_t y1) {
+  int16_t row_bytes = (c.w + 7) / 8;
+  for (int16_t y = 0; y < kTftHeight; y++)
+    for (int16_t x = 0; x < kTftWidth; x++) {
+      uint16_t expected = kBg;
+      int16_t i = x - x1, j = y - y1;
+      if(i >= 0 && j >= 0 && i < c.w && j < c.h && (c.bits[j * row_bytes + i / 8] & (0x80 >> (i & 7))))
+        expected = c.color;
+      CHECK_EQ(sim.Screen(x, y), expected);
+    }
+}
+
+// fly through path with the same edge rules as RGBDisplay::Screensaver
+static void RunFlyThrough(int8_t direction, uint32_t seed) {
+  TestRandom rnd(seed);
+  HwScrollSim sim(direction);
+  Canvas canvas = MakeCanvas(rnd);
+  int16_t x = -100, y = 20;
+  bool down = true, refresh = false, same_canvas = false;
+  int wraps = 0, frames_off_screen = 0;
+
+  for (int frame = 0; frame < 3000; frame++) {
+    if(refresh) {
+      canvas = MakeCanvas(rnd);
+      refresh = false;
+      same_canvas = false;
+    }
+    else {
+      int16_t adder = (rnd.Range(0, 9) == 0 ? rnd.Range(1, kGapBand) : 1);
+      x += adder;
+      y += (down ? adder : -adder);
+      if(x + canvas.w - 2 * kGapBand >= kTftWidth && x > kTftWidth) {
+        x = -kTftWidth;
+        wraps++;
+      }
+      if(y + kGapBand <= 0) {
+        if(!down) {
+          down = true;
+          refresh = true;
+        }
+      }
+      else if(y + canvas.h - kGapBand >= kTftHeight) {
+        if(down) {
+          down = false;
+          refresh = true;
+        }
+      }
+    }
+    sim.Paste(canvas, x, y, same_canvas);
+    same_canvas = true;
+    if(x >= kTftWidth || x + canvas.w <= 0)
+      frames_off_screen++;
+    if(frame % 5 == 0 || x < 0 || x + canvas.w > kTftWidth)
+      CheckScreen(sim, canvas, x, y);
+  }
+  CHECK(wraps > 0 && frames_off_screen > 0);
+  printf("  direction %d, seed %u: %d wraps, %d frames off screen\n", direction, seed, wraps, frames_off_screen);
+}
+
+int main() {
+  TestOrientations();
+  TestVisibleColumns();
+  for (int8_t direction = -1; direction <= 1; direction += 2)
+    for (uint32_t seed : {1u, 5u})
+      RunFlyThrough(direction, seed);
+  printf("test_hw_scroll passed\n");
+  return 0;
+}
@@ -0,0 +1,109 @@
+// PageLayout: fixed buttons and row buttons sized to every value text the settings pages show. Each button and its
+// cursor highlight ring stays on screen, buttons sharing a page never overlap so a touch finds one, the value text
+// printed where DrawPageButtonFace puts it lands inside its button, and row buttons match the rectangle
+// DisplayCurrentPageButtonRow used to store into the page tables.
+
+#include <initializer_list>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "page_layout.h"
+#include "test_util.h"
+
+// rows above the back button on the longest page, the WiFi settings page
+static const int kMaxRows = 6;
+
+static bool OnScreen(const ButtonRect& r) {
+  return r.x >= 0 && r.y >= 0 && r.x + r.w <= kTftWidth && r.y + r.h <= kTftHeight;
+}
+
+static bool Overlap(const ButtonRect& a, const ButtonRect& b) {
+  return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+// Contains agrees with the touch test it replaced, edges included
+static void CheckContains(const ButtonRect& r) {
+  for (int16_t y = r.y - 3; y <= r.y + r.h + 3; y++)
+    for (int16_t x = r.x - 3; x <= r.x + r.w + 3; x++)
+      CHECK_EQ(r.Contains(x, y), (x >= r.x && x <= r.x + r.w && y >= r.y && y <= r.y + r.h));
+}
+
+static void TestFixedButtons() {
+  for (const ButtonRect& r : { PageLayout::kSaveButton, PageLayout::kBackButton, PageLayout::kRescanButton, PageLayout::kNextButton, PageLayout::kSettingsGear, PageLayout::kAlarmRow }) {
+    CHECK(OnScreen(r));
+    CheckContains(r);
+  }
+  // highlighted bottom row buttons
+  for (const ButtonRect& r : { PageLayout::kSaveButton, PageLayout::kBackButton, PageLayout::kRescanButton, PageLayout::kNextButton })
+    CHECK(OnScreen(r.Grown(2)));
+  // buttons that share a page: save and back, rescan next and back, settings gear and alarm row
+  CHECK(!Overlap(PageLayout::kSaveButton.Grown(2), PageLayout::kBackButton.Grown(2)));
+  CHECK(!Overlap(PageLayout::kRescanButton.Grown(2), PageLayout::kNextButton.Grown(2)));
+  CHECK(!Overlap(PageLayout::kNextButton.Grown(2), PageLayout::kBackButton.Grown(2)));
+  CHECK(!Overlap(PageLayout::kSettingsGear, PageLayout::kAlarmRow));
+}
+
+static GFXcanvas1 screen(kTftWidth, kTftHeight);
+
+// every value a row button shows: fixed ones, each setting's values and the longest saved WiFi and location
+static const char* const kValues[] = {
+  "WIFI", "LOCATION", "SCREENSAVER", "ROTATE", "UPDATE", "SCAN WIFI", "WIFI PASSWD", "CLEAR", "CONNECT WIFI",
+  "DISCONNECT", "FETCH", "UPDATE TIME", "RUN", kSlowStr, kMediumStr, kFastStr, kFlyOutScreensaverStr,
+  kBounceScreensaverStr, kMetricUnitStr, kImperialUnitStr, kManualOffStr, kManualOnStr, kEveningStr, kSunDownStr,
+  "5sec", "25sec", "9PM", "12PM", "0%", "100%", "560001 IN", "99999 US", "WWWWWWWWWWWWWWWW", "", "i",
+};
+
+static void TestRowButtons() {
+  screen.setFont(&FreeMonoBold9pt7b);
+  screen.setTextWrap(false);
+  int checked = 0;
+  uint16_t widest = 0;
+  for (const char* value : kValues) {
+    int16_t x1, y1;
+    uint16_t w, h;
+    screen.getTextBounds(value, 0, PageLayout::RowTextY0(0), &x1, &y1, &w, &h);
+    widest = (w > widest ? w : widest);
+    for (bool label_only : { false, true }) {
+      for (int i = 0; i < kMaxRows; i++) {
+        ButtonRect r = PageLayout::RowButton(i, w, h, label_only);
+        int16_t row_text_y0 = PageLayout::RowTextY0(i);
+        CheckContains(r);
+
+        // what DisplayCurrentPageButtonRow computed and stored before
+        int16_t old_x = kTftWidth - w - 3 * kDisplayTextGap;
+        if(label_only)
+          old_x += 2 * kDisplayTextGap;
+        CHECK_EQ(r.x, old_x);
+        CHECK_EQ(r.y, row_text_y0 - h - kDisplayTextGap);
+        CHECK_EQ(r.w, w + 2 * kDisplayTextGap);
+        CHECK_EQ(r.h, h + 2 * kDisplayTextGap);
+
+        // highlight ring on screen, clear of the next row's ring and of the back and save buttons below
+        if(!label_only) {
+          CHECK(OnScreen(r.Grown(2)));
+          if(i + 1 < kMaxRows)
+            CHECK(!Overlap(r.Grown(2), PageLayout::RowButton(i + 1, w, h, false).Grown(2)));
+          CHECK(!Overlap(r.Grown(2), PageLayout::kBackButton.Grown(2)));
+          CHECK(!Overlap(r.Grown(2), PageLayout::kSaveButton.Grown(2)));
+        }
+
+        // value text where it is printed: inside the face for a button, left edge at r.x for a label only value
+        screen.fillScreen(0);
+        screen.setCursor(r.x + (label_only ? 0 : kDisplayTextGap), row_text_y0);
+        screen.print(value);
+        for (int16_t y = 0; y < kTftHeight; y++)
+          for (int16_t x = 0; x < kTftWidth; x++)
+            if(screen.getPixel(x, y))
+              CHECK(r.Contains(x, y) && x < kTftWidth);
+        checked++;
+      }
+    }
+  }
+  printf("  %d row buttons, widest value %u px\n", checked, widest);
+}
+
+int main() {
+  TestFixedButtons();
+  TestRowButtons();
+  printf("test_page_layout passed\n");
+  return 0;
+}
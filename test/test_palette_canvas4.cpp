@@ -0,0 +1,137 @@
+// PaletteCanvas4: pages of random rectangles, lines, circles and text in up to 16 colors drawn band by band and
+// expanded through the palette match the same page drawn on a GFXcanvas16, for odd and even widths and shapes that
+// run off every edge. Past 16 colors a new color takes the nearest palette entry instead of entry 0.
+
+#include <initializer_list>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeSans12pt7b.h"
+#include "palette_canvas4.h"
+#include "test_util.h"
+
+// what a page draws, replayed on each band and on the reference canvas
+static void DrawPage(Adafruit_GFX& gfx, uint32_t seed, const std::vector<uint16_t>& colors) {
+  TestRandom rnd(seed);
+  int16_t w = gfx.width(), h = gfx.height();
+  auto color = [&]() { return colors[rnd.Range(0, colors.size() - 1)]; };
+  for (int k = 0; k < 60; k++) {
+    int16_t x = rnd.Range(-30, w + 10), y = rnd.Range(-30, h + 10);
+    switch (rnd.Range(0, 6)) {
+      case 0: gfx.fillRect(x, y, rnd.Range(0, 60), rnd.Range(0, 40), color()); break;
+      case 1: gfx.drawFastHLine(x, y, rnd.Range(-5, w + 40), color()); break;
+      case 2: gfx.drawFastVLine(x, y, rnd.Range(-5, h + 40), color()); break;
+      case 3: gfx.drawLine(x, y, rnd.Range(-30, w + 30), rnd.Range(-30, h + 30), color()); break;
+      case 4: gfx.fillCircle(x, y, rnd.Range(1, 25), color()); break;
+      case 5: gfx.drawRoundRect(x, y, rnd.Range(10, 80), rnd.Range(10, 50), 4, color()); break;
+      default:
+        gfx.setFont(rnd.Range(0, 1) ? &FreeMonoBold9pt7b : &FreeSans12pt7b);
+        gfx.setTextColor(color());
+        gfx.setCursor(x, y);
+        gfx.print("Wi-Fi 12:34 gj");
+        break;
+    }
+  }
+}
+
+static std::vector<uint16_t> RandomColors(TestRandom& rnd, int n) {
+  std::vector<uint16_t> colors;
+  while((int)colors.size() < n) {
+    uint16_t c = rnd.Range(0, 0xFFFF);
+    bool repeat = false;
+    for (uint16_t other : colors)
+      repeat |= (other == c);
+    if(!repeat)
+      colors.push_back(c);
+  }
+  return colors;
+}
+
+static void TestAgainstCanvas16() {
+  TestRandom rnd(14);
+  int pages = 0;
+  for (int16_t w : { 320, 319, 7, 1 }) {
+    for (int16_t h : { 240, 61 }) {
+      for (int16_t band_rows : { 60, 7, 1 }) {
+        uint32_t seed = rnd.Next();
+        // fillScreen takes the first entry, so the page uses at most 16 colors with the background
+        std::vector<uint16_t> colors = RandomColors(rnd, rnd.Range(1, 16));
+        GFXcanvas16 reference(w, h);
+        reference.setTextWrap(false);
+        reference.fillScreen(colors[0]);
+        DrawPage(reference, seed, colors);
+
+        std::vector<uint8_t> arena((w + 1) / 2 * band_rows);
+        PaletteCanvas4 canvas(w, h, arena.data(), arena.size());
+        std::vector<uint16_t> row(w);
+        for (int16_t band_y0 = 0; band_y0 < h; band_y0 += band_rows) {
+          canvas.SetBand(band_y0, std::min<int>(band_rows, h - band_y0));
+          CHECK_EQ(canvas.band_h(), std::min<int>(band_rows, h - band_y0));
+          canvas.fillScreen(colors[0]);
+          DrawPage(canvas, seed, colors);
+          for (int16_t j = 0; j < canvas.band_h(); j++) {
+            canvas.ExpandRow(j, row.data());
+            for (int16_t i = 0; i < w; i++)
+              CHECK_EQ(row[i], reference.getBuffer()[(band_y0 + j) * w + i]);
+          }
+        }
+        CHECK(canvas.palette_size() <= colors.size());
+        CHECK_EQ(canvas.unfit_lookups(), 0);
+        pages++;
+      }
+    }
+  }
+  printf("  %d pages match GFXcanvas16\n", pages);
+}
+
+// 16 colors fill the palette, each later color is drawn with whichever of them is closest
+static void TestNearestEntry() {
+  const int16_t w = 32, h = 1;
+  uint8_t arena[(w + 1) / 2 * h];
+  TestRandom rnd(141);
+  for (int trial = 0; trial < 200; trial++) {
+    std::vector<uint16_t> colors = RandomColors(rnd, 16 + 16);
+    PaletteCanvas4 canvas(w, h, arena, sizeof(arena));
+    for (int i = 0; i < 16; i++)
+      canvas.drawPixel(i, 0, colors[i]);
+    CHECK_EQ(canvas.palette_size(), 16);
+    CHECK_EQ(canvas.unfit_lookups(), 0);
+    for (int i = 16; i < 32; i++) {
+      canvas.drawFastHLine(i, 0, 1, colors[i]);
+      uint32_t best = UINT32_MAX;
+      for (int k = 0; k < 16; k++)
+        best = std::min(best, PaletteCanvas4::ColorDistance(colors[i], colors[k]));
+      uint16_t row[w];
+      canvas.ExpandRow(0, row);
+      CHECK_EQ(PaletteCanvas4::ColorDistance(colors[i], row[i]), best);
+      // the palette is unchanged, earlier pixels keep their color
+      for (int k = 0; k < 16; k++)
+        CHECK_EQ(row[k], colors[k]);
+    }
+    CHECK_EQ(canvas.palette_size(), 16);
+    CHECK_EQ(canvas.unfit_lookups(), 16);
+  }
+
+  // a light grey past a palette of black, white and primaries is drawn white, not black from entry 0
+  const uint16_t kBlack = 0x0000, kWhite = 0xFFFF, kLightGrey = 0xC618;
+  PaletteCanvas4 canvas(w, h, arena, sizeof(arena));
+  canvas.fillScreen(kBlack);
+  canvas.drawPixel(1, 0, kWhite);
+  for (int i = 2; i < 16; i++)
+    canvas.drawPixel(i, 0, (uint16_t)(0xF800 >> (i % 3 * 5)) + i);
+  canvas.drawPixel(20, 0, kLightGrey);
+  uint16_t row[w];
+  canvas.ExpandRow(0, row);
+  CHECK_EQ(row[20], kWhite);
+  CHECK_EQ(canvas.unfit_lookups(), 1);
+
+  CHECK_EQ(PaletteCanvas4::ColorDistance(kLightGrey, kLightGrey), 0);
+  CHECK(PaletteCanvas4::ColorDistance(kBlack, kWhite) > PaletteCanvas4::ColorDistance(kLightGrey, kWhite));
+}
+
+int main() {
+  TestAgainstCanvas16();
+  TestNearestEntry();
+  printf("test_palette_canvas4 passed\n");
+  return 0;
+}
@@ -0,0 +1,98 @@
+// PosixTz against glibc reading the same TZ string: UTC offset every hour from 2000 to 2060 and to the second around
+// each transition NextTransition reports, for zones north and south of the equator, odd offsets and every rule form.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "posix_tz.h"
+#include "test_util.h"
+
+// glibc looks a TZ string up as a zoneinfo file first and takes rules left out from the posixrules file (US rules
+// back to 1967), so strings that are file names or have no rules are given to it with the current US rules spelled out
+static const struct { const char* zone; const char* glibc_zone; } kZones[] = {
+  { "PST8PDT,M3.2.0,M11.1.0", nullptr },
+  { "EST5EDT", "<EST>5<EDT>,M3.2.0,M11.1.0" },
+  { "MST7MDT", "<MST>7<MDT>,M3.2.0,M11.1.0" },
+  { "CET-1CEST,M3.5.0,M10.5.0/3", nullptr },
+  { "GMT0BST,M3.5.0/1,M10.5.0", nullptr },
+  { "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0", nullptr }, // Lord Howe, half hour DST in the south
+  { "AEST-10AEDT,M10.1.0,M4.1.0/3", nullptr },
+  { "NZST-12NZDT,M9.5.0,M4.1.0/3", nullptr },
+  { "<-03>3<-02>,M3.2.0,M11.1.0", nullptr },
+  { "IST-2IDT,M3.4.4/26,M10.5.0", nullptr }, // transition past 24 h
+  { "<-01>1<+00>,M3.5.0/0,M10.5.0/1", nullptr },
+  { "WART4WARST,J60/2,J300/2", nullptr }, // Julian days, 29 Feb never counted
+  { "XXX3YYY,10/2,300/2", nullptr }, // zero based days
+  { "<+0545>-5:45", nullptr },
+  { "IST-5:30", nullptr },
+  { "UTC0", nullptr },
+  { "HST10", nullptr },
+};
+
+static int32_t GlibcOffset(int64_t utc) {
+  time_t t = utc;
+  struct tm tm;
+  localtime_r(&t, &tm);
+  return tm.tm_gmtoff;
+}
+
+static void TestZone(const char* zone, const char* glibc_zone) {
+  PosixTz tz;
+  CHECK(tz.Parse(zone));
+  setenv("TZ", glibc_zone ? glibc_zone : zone, 1);
+  tzset();
+
+  const int64_t from = 946684800, to = 2840140800;   // 2000 - 2060
+  for (int64_t utc = from; utc < to; utc += 3600)
+    CHECK_EQ(tz.OffsetAt(utc), GlibcOffset(utc));
+
+  int transitions = 0;
+  int64_t utc = from, next;
+  int32_t offset_after;
+  while(tz.NextTransition(utc, &next, &offset_after) && next < to) {
+    CHECK(next > utc);
+    CHECK_EQ(offset_after, GlibcOffset(next));
+    CHECK(GlibcOffset(next - 1) != offset_after);
+    for (int64_t t = next - 2; t <= next + 2; t++)
+      CHECK_EQ(tz.OffsetAt(t), GlibcOffset(t));
+    // nothing in between was missed
+    CHECK_EQ(tz.OffsetAt(next - 1), GlibcOffset(utc));
+    utc = next;
+    transitions++;
+  }
+  CHECK_EQ(transitions, tz.has_dst() ? 120 : 0);
+  printf("  %-38s %3d transitions\n", zone, transitions);
+}
+
+// DST all year, the way tzdata writes it: tzcode reads this as never leaving DST, glibc drops to standard time for the
+// hours between 1 Jan 00:00 UTC and the start rule, so it is checked on its own
+static void TestAllYearDst() {
+  PosixTz tz;
+  CHECK(tz.Parse("WART4WARST,J1/0,J365/25"));
+  for (int64_t utc = 946684800; utc < 2840140800; utc += 1800)
+    CHECK_EQ(tz.OffsetAt(utc), -3 * 3600);
+}
+
+static void TestMalformed() {
+  static const char* kBad[] = {
+    "", "PS", "PST", "PST8PDT,M3.2.0", "PST8PDT,M13.2.0,M11.1.0", "PST8PDT,M3.6.0,M11.1.0", "PST8PDT,M3.2.7,M11.1.0",
+    "PST8PDT,J0,J100", "PST8PDT,M3.2.0,M11.1.0,", "<+10", "PST168", "PST8:60",
+  };
+  for (const char* zone : kBad) {
+    PosixTz tz;
+    CHECK(!tz.Parse(zone));
+    CHECK(!tz.valid());
+    CHECK_EQ(tz.OffsetAt(1700000000), 0);
+  }
+  PosixTz tz;
+  CHECK(!tz.Parse(nullptr));
+}
+
+int main() {
+  for (auto& z : kZones)
+    TestZone(z.zone, z.glibc_zone);
+  TestAllYearDst();
+  TestMalformed();
+  printf("test_posix_tz passed\n");
+  return 0;
+}
@@ -0,0 +1,175 @@
+// PsramFrame16: random drawing between flushes, primitives off every edge and with negative sizes. The dirty
+// rectangle holds every pixel that changed, is exact for a single clipped rectangle, and Flush sends it to a panel
+// that afterwards matches the frame pixel for pixel: one write for full width rows, one per row otherwise.
+
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeSans12pt7b.h"
+#include "general_constants.h"
+#include "psram_frame16.h"
+#include "test_util.h"
+
+// panel memory written the way Adafruit_SPITFT writes it: pixels fill the address window row by row
+struct FakePanel {
+  std::vector<uint16_t> pixels = std::vector<uint16_t>(kTftWidth * kTftHeight, 0);
+  int16_t win_x = 0, win_y = 0;
+  uint16_t win_w = 0, win_h = 0;
+  uint32_t win_pos = 0, pixels_written = 0;
+  int writes = 0, transactions = 0;
+  bool in_transaction = false;
+
+  void startWrite() {
+    CHECK(!in_transaction);
+    in_transaction = true;
+    transactions++;
+  }
+  void endWrite() {
+    CHECK(in_transaction);
+    in_transaction = false;
+  }
+  void setAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    CHECK(in_transaction);
+    CHECK(x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= kTftWidth && y + h <= kTftHeight);
+    win_x = x; win_y = y; win_w = w; win_h = h;
+    win_pos = 0;
+  }
+  void writePixels(uint16_t* colors, uint32_t len) {
+    CHECK(in_transaction);
+    CHECK(win_pos + len <= (uint32_t)win_w * win_h);
+    for (uint32_t i = 0; i < len; i++, win_pos++)
+      pixels[(win_y + win_pos / win_w) * kTftWidth + win_x + win_pos % win_w] = colors[i];
+    pixels_written += len;
+    writes++;
+  }
+};
+
+static void DrawRandom(Adafruit_GFX& gfx, TestRandom& rnd) {
+  int16_t x = rnd.Range(-40, kTftWidth + 20), y = rnd.Range(-40, kTftHeight + 20);
+  uint16_t color = rnd.Range(0, 0xFFFF);
+  switch (rnd.Range(0, 8)) {
+    case 0: gfx.drawPixel(x, y, color); break;
+    case 1: gfx.drawFastHLine(x, y, rnd.Range(-60, 60), color); break;
+    case 2: gfx.drawFastVLine(x, y, rnd.Range(-60, 60), color); break;
+    case 3: gfx.fillRect(x, y, rnd.Range(0, 80), rnd.Range(0, 60), color); break;
+    case 4: gfx.drawLine(x, y, rnd.Range(-40, kTftWidth + 40), rnd.Range(-40, kTftHeight + 40), color); break;
+    case 5: gfx.fillCircle(x, y, rnd.Range(0, 30), color); break;
+    case 6: gfx.drawRoundRect(x, y, rnd.Range(8, 100), rnd.Range(8, 60), 5, color); break;
+    default:
+      gfx.setFont(rnd.Range(0, 1) ? &FreeMonoBold9pt7b : &FreeSans12pt7b);
+      gfx.setTextColor(color);
+      gfx.setCursor(x, y);
+      gfx.print("Weather 21C");
+      break;
+  }
+}
+
+// bounding box of pixels that differ between frame and panel, false if none
+static bool ChangedRect(const uint16_t* frame, const FakePanel& panel, int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1) {
+  *x0 = *y0 = INT16_MAX;
+  *x1 = *y1 = -1;
+  for (int16_t y = 0; y < kTftHeight; y++)
+    for (int16_t x = 0; x < kTftWidth; x++)
+      if(frame[y * kTftWidth + x] != panel.pixels[y * kTftWidth + x]) {
+        *x0 = std::min(*x0, x); *y0 = std::min(*y0, y);
+        *x1 = std::max(*x1, x); *y1 = std::max(*y1, y);
+      }
+  return *x1 >= 0;
+}
+
+static void TestFlushMatchesFrame() {
+  std::vector<uint16_t> buffer(kTftWidth * kTftHeight);
+  PsramFrame16 frame(kTftWidth, kTftHeight, buffer.data());
+  FakePanel panel;
+  frame.setTextWrap(false);
+  frame.fillScreen(0x0000);
+  CHECK(frame.Flush(panel));
+  CHECK_EQ(panel.writes, 1);
+
+  TestRandom rnd(15);
+  unsigned long full_frame_pixels = 0, flushed_pixels = 0;
+  for (int k = 0; k < 3000; k++) {
+    int draws = (k % 100 == 0 ? 0 : rnd.Range(1, 4));
+    for (int d = 0; d < draws; d++)
+      DrawRandom(frame, rnd);
+    if(k % 500 == 499)
+      frame.fillScreen(rnd.Range(0, 0xFFFF));
+
+    // every changed pixel is inside the dirty rectangle
+    int16_t cx0, cy0, cx1, cy1, x = 0, y = 0, w = 0, h = 0;
+    if(ChangedRect(buffer.data(), panel, &cx0, &cy0, &cx1, &cy1)) {
+      CHECK(frame.dirty());
+      frame.DirtyRect(&x, &y, &w, &h);
+      CHECK(x <= cx0 && y <= cy0 && x + w - 1 >= cx1 && y + h - 1 >= cy1);
+    }
+    bool dirty = frame.dirty();
+    if(dirty)
+      frame.DirtyRect(&x, &y, &w, &h);
+
+    int writes = panel.writes, transactions = panel.transactions;
+    uint32_t pixels_written = panel.pixels_written;
+    CHECK_EQ(frame.Flush(panel), dirty);
+    CHECK(!frame.dirty());
+    CHECK(!panel.in_transaction);
+    CHECK(panel.pixels == buffer);
+    if(dirty) {
+      CHECK_EQ(panel.transactions - transactions, 1);
+      CHECK_EQ(panel.pixels_written - pixels_written, (uint32_t)w * h);
+      CHECK_EQ(panel.writes - writes, (w == kTftWidth ? 1 : h));
+      flushed_pixels += w * h;
+    }
+    else
+      CHECK_EQ(panel.transactions, transactions);
+    full_frame_pixels += kTftWidth * kTftHeight;
+  }
+  printf("  3000 flushes sent %lu%% of the pixels of full frames\n", flushed_pixels * 100 / full_frame_pixels);
+}
+
+// a single rectangle marks exactly its part on screen, nothing off screen marks anything
+static void TestDirtyRectExact() {
+  std::vector<uint16_t> buffer(kTftWidth * kTftHeight);
+  PsramFrame16 frame(kTftWidth, kTftHeight, buffer.data());
+  TestRandom rnd(16);
+  for (int k = 0; k < 5000; k++) {
+    frame.ClearDirty();
+    int16_t x = rnd.Range(-100, kTftWidth + 20), y = rnd.Range(-100, kTftHeight + 20);
+    int16_t w = rnd.Range(0, 150), h = rnd.Range(0, 150);
+    frame.fillRect(x, y, w, h, 0xFFFF);
+    int16_t x0 = std::max<int>(x, 0), y0 = std::max<int>(y, 0);
+    int16_t x1 = std::min<int>(x + w - 1, kTftWidth - 1), y1 = std::min<int>(y + h - 1, kTftHeight - 1);
+    if(w == 0 || h == 0 || x0 > x1 || y0 > y1) {
+      CHECK(!frame.dirty());
+      continue;
+    }
+    int16_t dx, dy, dw, dh;
+    CHECK(frame.dirty());
+    frame.DirtyRect(&dx, &dy, &dw, &dh);
+    CHECK_EQ(dx, x0);
+    CHECK_EQ(dy, y0);
+    CHECK_EQ(dw, x1 - x0 + 1);
+    CHECK_EQ(dh, y1 - y0 + 1);
+  }
+
+  // negative sizes draw left of and above the start
+  int16_t dx, dy, dw, dh;
+  frame.ClearDirty();
+  frame.drawFastHLine(100, 50, -10, 0x1234);
+  frame.DirtyRect(&dx, &dy, &dw, &dh);
+  CHECK(dx == 91 && dy == 50 && dw == 10 && dh == 1);
+  frame.ClearDirty();
+  frame.drawFastVLine(5, 3, -10, 0x1234);
+  frame.DirtyRect(&dx, &dy, &dw, &dh);
+  CHECK(dx == 5 && dy == 0 && dw == 1 && dh == 4);
+
+  FakePanel panel;
+  frame.ClearDirty();
+  CHECK(!frame.Flush(panel));
+  CHECK_EQ(panel.transactions, 0);
+}
+
+int main() {
+  TestFlushMatchesFrame();
+  TestDirtyRectExact();
+  printf("test_psram_frame16 passed\n");
+  return 0;
+}
@@ -0,0 +1,107 @@
+// RenderHistogram: bucket edges, percentiles against the exact ones from sorted samples, and hours of screensaver
+// frames at 40 fps, long enough to fill a 16 bit bucket many times over.
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "render_profiler.h"
+#include "test_util.h"
+
+static void TestBuckets() {
+  CHECK_EQ(RenderHistogram::BucketIndex(0), 0);
+  CHECK_EQ(RenderHistogram::BucketIndex(0xFFFFFFFF), RenderHistogram::kBuckets - 1);
+  uint8_t prev = 0;
+  for (uint32_t us = 0; us < 3000000; us += (us < 5000 ? 1 : us / 1000)) {
+    uint8_t i = RenderHistogram::BucketIndex(us);
+    CHECK(i >= prev && i < RenderHistogram::kBuckets);
+    prev = i;
+    // us is inside its bucket: at most the upper edge, above the one below
+    CHECK(us <= RenderHistogram::BucketUpperUs(i));
+    if(i > 0)
+      CHECK(us > RenderHistogram::BucketUpperUs(i - 1));
+    // buckets are at most a quarter of their lower edge wide
+    if(i >= RenderHistogram::kSubBuckets && i < RenderHistogram::kBuckets - 1)
+      CHECK(RenderHistogram::BucketUpperUs(i) - RenderHistogram::BucketUpperUs(i - 1) <= (RenderHistogram::BucketUpperUs(i - 1) + 1) / 4 + 1);
+  }
+}
+
+// reported percentile is the upper edge of the exact one's bucket, capped at the max
+static void CheckPercentile(const RenderHistogram& h, std::vector<uint32_t> samples, uint8_t pct) {
+  std::sort(samples.begin(), samples.end());
+  size_t rank = (samples.size() * pct + 99) / 100;
+  uint32_t exact = samples[(rank ? rank : 1) - 1];
+  uint32_t expected = std::min(RenderHistogram::BucketUpperUs(RenderHistogram::BucketIndex(exact)), samples.back());
+  CHECK_EQ(h.Percentile(pct), expected);
+}
+
+static void TestPercentiles() {
+  RenderHistogram h;
+  CHECK_EQ(h.Percentile(50), 0);
+  TestRandom rnd(20);
+  for (int trial = 0; trial < 50; trial++) {
+    h.Clear();
+    std::vector<uint32_t> samples;
+    int n = rnd.Range(1, 5000);
+    for (int k = 0; k < n; k++) {
+      uint32_t us = (rnd.Range(0, 20) == 0 ? rnd.Range(0, 400000) : rnd.Range(2000, 20000 + trial * 1000));
+      samples.push_back(us);
+      h.Add(us);
+    }
+    CHECK_EQ(h.count(), n);
+    CHECK_EQ(h.max_us(), *std::max_element(samples.begin(), samples.end()));
+    for (uint8_t pct : { 0, 1, 50, 90, 99, 100 })
+      CheckPercentile(h, samples, pct);
+  }
+}
+
+// 6 hours at 40 fps: most frames 14 - 16 ms, 3% slow ones around 60 ms and one 2 s stall. The fast bucket passes
+// 0xFFFF after half an hour, percentiles must still come from the buckets and not fall through to the max
+static void TestSaturation() {
+  RenderHistogram h;
+  TestRandom rnd(40);
+  const uint32_t kFrames = 6 * 3600 * 40;
+  uint32_t halvings = 0, prev_total = 0;
+  for (uint32_t k = 0; k < kFrames; k++) {
+    uint32_t us = (k == kFrames / 3 ? 2000000 : (rnd.Range(0, 99) < 3 ? rnd.Range(58000, 62000) : rnd.Range(14000, 16000)));
+    h.Add(us);
+    uint32_t total = 0;
+    if(k % 1000 == 0 || k + 1 == kFrames) {
+      for (uint8_t i = 0; i < RenderHistogram::kBuckets; i++)
+        total += h.bucket_count(i);
+      if(total < prev_total)
+        halvings++;
+      prev_total = total;
+    }
+    if(k % 50000 == 0 && k > 0) {
+      CHECK(h.Percentile(50) >= 14000 && h.Percentile(50) <= RenderHistogram::BucketUpperUs(RenderHistogram::BucketIndex(16000)));
+      CHECK(h.Percentile(99) >= 58000 && h.Percentile(99) <= RenderHistogram::BucketUpperUs(RenderHistogram::BucketIndex(62000)));
+    }
+  }
+  CHECK(halvings >= 3);
+  CHECK_EQ(h.count(), kFrames);
+  CHECK_EQ(h.max_us(), 2000000);
+  // the stall is still in the tail after the halvings
+  CHECK(h.bucket_count(RenderHistogram::BucketIndex(2000000)) >= 1);
+  CHECK_EQ(h.Percentile(100), 2000000);
+  printf("  %u frames, %u halvings: p50 %u us, p99 %u us, max %u us\n", kFrames, halvings, h.Percentile(50), h.Percentile(99), h.max_us());
+}
+
+static void TestProfiler() {
+  RenderProfiler profiler;
+  for (uint8_t i = 0; i < kRenderSectionCount; i++) {
+    CHECK(RenderProfiler::SectionName((RenderSection)i) != nullptr);
+    profiler.Add((RenderSection)i, 100 * (i + 1));
+  }
+  CHECK_EQ(profiler.histogram(kRenderKeyboard).max_us(), 100 * (kRenderKeyboard + 1));
+  profiler.Clear();
+  CHECK_EQ(profiler.histogram(kRenderKeyboard).count(), 0);
+}
+
+int main() {
+  TestBuckets();
+  TestPercentiles();
+  TestSaturation();
+  TestProfiler();
+  printf("test_render_profiler passed\n");
+  return 0;
+}
@@ -0,0 +1,168 @@
+// Bounce path panel simulation of the screensaver paste. With the colored edge on, the panel must match always sending
+// the full canvas, which is how the edge trail has always looked. With it off, the panel must hold nothing but the
+// canvas, so motion blits never leave stale pixels inside or around the clock.
+
+#include <stdint.h>
+#include <vector>
+#include "general_constants.h"
+#include "two_color_blit.h"
+#include "screensaver_motion.h"
+#include "test_util.h"
+#include "mock_panel.h"
+
+static const int16_t kGapBand = 5;          // bg margin around the screensaver text, GAP_BAND in Screensaver()
+static const int16_t kMotionBlitMaxStep = 8;
+static const uint16_t kBg = 0x0000;
+
+struct Canvas {
+  int16_t w, h;
+  std::vector<uint8_t> bits;
+  uint16_t color;
+  bool edge;
+};
+
+// text-like blob inside a kGapBand bg margin, plus the one pixel border of the colored edge look
+static Canvas MakeCanvas(TestRandom& rnd, bool edge) {
+  Canvas c;
+  c.w = rnd.Range(150, 210);
+  c.h = rnd.Range(100, 130);
+  c.color = (uint16_t)(rnd.Next() | 1);
+  c.edge = edge;
+  int16_t row_bytes = (c.w + 7) / 8;
+  c.bits.assign(row_bytes * c.h, 0);
+  for (int16_t y = kGapBand; y < c.h - kGapBand; y++)
+    for (int16_t x = kGapBand; x < c.w - kGapBand; x++)
+      if(((x / 7 + y / 11) & 1) && (rnd.Next() & 7))
+        c.bits[y * row_bytes + x / 8] |= 0x80 >> (x & 7);
+  if(edge)
+    for (int16_t y = 0; y < c.h; y++)
+      for (int16_t x = 0; x < c.w; x++)
+        if(x == 0 || y == 0 || x == c.w - 1 || y == c.h - 1)
+          c.bits[y * row_bytes + x / 8] |= 0x80 >> (x & 7);
+  return c;
+}
+
+// panel pixels under the canvas at (x, y) show it
+static void CheckCanvasOnPanel(const MockPanel& panel, const Canvas& c, int16_t x, int16_t y) {
+  int16_t row_bytes = (c.w + 7) / 8;
+  for (int16_t j = 0; j < c.h; j++)
+    for (int16_t i = 0; i < c.w; i++) {
+      int16_t px = x + i, py = y + j;
+      if(px < 0 || py < 0 || px >= panel.width() || py >= panel.height())
+        continue;
+      bool set = c.bits[j * row_bytes + i / 8] & (0x80 >> (i & 7));
+      CHECK_EQ(panel.Pixel(px, py), (set ? c.color : kBg));
+    }
+}
+
+// panel outside the canvas at (x, y) is bg
+static void CheckBgOutside(const MockPanel& panel, const Canvas& c, int16_t x, int16_t y) {
+  for (int16_t py = 0; py < panel.height(); py++)
+    for (int16_t px = 0; px < panel.width(); px++)
+      if(px < x || py < y || px >= x + c.w || py >= y + c.h)
+        CHECK_EQ(panel.Pixel(px, py), kBg);
+}
+
+// tft.fillRect in bg, clipped to the panel
+static void FillRect(MockPanel& panel, const ScreensaverPaste::Rect& r) {
+  for (int16_t py = r.y; py < r.y + r.h; py++)
+    for (int16_t px = r.x; px < r.x + r.w; px++)
+      if(px >= 0 && py >= 0 && px < panel.width() && py < panel.height()) {
+        uint16_t bg = kBg;
+        panel.SetWindow(px, py, 1, 1);
+        panel.WritePixels(&bg, 1);
+      }
+}
+
+// runs the bounce path with the colored edge switched on and off along the way
+static void RunBouncePath(uint32_t seed, bool motion_blit_enabled, int max_adder) {
+  TestRandom rnd(seed);
+  MockPanel reference(kTftWidth, kTftHeight, kBg), panel(kTftWidth, kTftHeight, kBg);
+  TwoColorLut lut;
+  ScreensaverPaste paste;
+
+  bool edge = true;
+  Canvas canvas = MakeCanvas(rnd, edge);
+  int16_t x = 0, y = 20, prev_x = 0, prev_y = 0;
+  bool right = true, down = true, refresh = false, on_screen = false;
+  long motion_pixels = 0, full_pixels = 0;
+
+  for (int frame = 0; frame < 5000; frame++) {
+    // the 'z' toggle and the brightness band flip the edge, a new canvas picks it up
+    if(frame % 1500 == 700) {
+      edge = !edge;
+      refresh = true;
+    }
+    if(refresh) {
+      canvas = MakeCanvas(rnd, edge);
+      refresh = false;
+      on_screen = false;
+    }
+    else {
+      // same edge rules as RGBDisplay::Screensaver in bounce mode
+      int16_t adder = (rnd.Range(0, 9) == 0 ? rnd.Range(1, max_adder) : 1);
+      x += (right ? adder : -adder);
+      y += (down ? adder : -adder);
+      if(x + 2 * kGapBand <= 0)
+        right = true;
+      else if(x + canvas.w - 2 * kGapBand >= kTftWidth)
+        right = false;
+      if(y + kGapBand <= 0) {
+        if(!down) {
+          down = true;
+          refresh = true;
+        }
+      }
+      else if(y + canvas.h - kGapBand >= kTftHeight) {
+        if(down) {
+          down = false;
+          refresh = true;
+        }
+      }
+    }
+
+    // an edge period starts from whatever the panel holds, from then on it must look like plain full blits
+    if(canvas.edge && !paste.trail_on_panel())
+      reference = panel;
+    lut.Set(canvas.color, kBg);
+    BlitTwoColorBitmap(reference, lut, kTftWidth, kTftHeight, x, y, canvas.bits.data(), canvas.w, canvas.h);
+    ScreensaverPaste::Kind kind = paste.Next(motion_blit_enabled, on_screen, {x, y, canvas.w, canvas.h}, kMotionBlitMaxStep, canvas.edge);
+    if(kind == ScreensaverPaste::kClearThenFullBlit)
+      panel.Fill(kBg);
+    long sent = panel.pixels;
+    if(kind == ScreensaverPaste::kMotionBlit)
+      motion_pixels += MotionBlitTwoColorBitmap<kTftWidth>(panel, lut, kTftHeight, x, y, prev_x, prev_y, canvas.bits.data(), canvas.w, canvas.h);
+    else
+      BlitTwoColorBitmap(panel, lut, kTftWidth, kTftHeight, x, y, canvas.bits.data(), canvas.w, canvas.h);
+    if(kind != ScreensaverPaste::kMotionBlit)
+      full_pixels += panel.pixels - sent;
+    for (uint8_t i = 0; i < paste.stale_count(); i++)
+      FillRect(panel, paste.stale(i));
+    prev_x = x;
+    prev_y = y;
+    on_screen = true;
+
+    CheckCanvasOnPanel(panel, canvas, x, y);
+    if(paste.trail_on_panel()) {
+      // colored edge trail is kept exactly as full blits draw it
+      CHECK(panel == reference);
+    }
+    else if(frame % 7 == 0) {
+      // no trail: nothing but the canvas on the panel
+      CheckBgOutside(panel, canvas, x, y);
+    }
+  }
+  if(motion_blit_enabled)
+    CHECK(motion_pixels > 0);
+  printf("  seed %u, motion blit %d, steps up to %d: %ld px in motion blits, %ld px in full blits\n", seed, motion_blit_enabled, max_adder, motion_pixels, full_pixels);
+}
+
+int main() {
+  for (uint32_t seed = 1; seed <= 2; seed++) {
+    RunBouncePath(seed, true, 3);
+    RunBouncePath(seed, true, kGapBand);
+    RunBouncePath(seed, false, 3);
+  }
+  printf("test_screensaver_panel passed\n");
+  return 0;
+}
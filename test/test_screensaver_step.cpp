@@ -0,0 +1,80 @@
+// Frame rate independence of the screensaver motion: at any frame rate, with jittery frames and a blocked loop now
+// and then, steps never go over the limit and the clock covers the same distance in the same time.
+
+#include <stdint.h>
+#include <initializer_list>
+#include "screensaver_motion.h"
+#include "test_util.h"
+
+static const unsigned long kSpeedPxPerSec = 40;     // kScreensaverSpeedPxPerSec
+static const unsigned long kMaxFrameGapMs = 250;    // kScreensaverMaxFrameGapMs
+static const int16_t kGapBand = 5;                  // GAP_BAND in Screensaver()
+
+struct Run {
+  long distance;
+  long stalled_ms;    // frame time past kMaxFrameGapMs, not turned into motion
+  int16_t max_step;
+};
+
+// frames at fps with +-jitter_pct interval jitter for duration_ms, a stall_ms frame every stall_every frames
+static Run RunFrames(uint32_t seed, unsigned long fps, int jitter_pct, int16_t max_step, unsigned long stall_ms, int stall_every, unsigned long duration_ms) {
+  TestRandom rnd(seed);
+  ScreensaverStep step;
+  Run run = {0, 0, 0};
+  unsigned long t = 0;
+  int frame = 0;
+  while(t < duration_ms) {
+    unsigned long period = 1000 / fps;
+    unsigned long interval = period + (long)period * rnd.Range(-jitter_pct, jitter_pct) / 100;
+    if(stall_every && ++frame % stall_every == 0)
+      interval = stall_ms;
+    t += interval;
+    if(interval > kMaxFrameGapMs)
+      run.stalled_ms += interval - kMaxFrameGapMs;
+    step.Add(interval < kMaxFrameGapMs ? interval : kMaxFrameGapMs, kSpeedPxPerSec);
+    int16_t s = step.Take(max_step);
+    CHECK(s >= 0 && s <= max_step);
+    if(s > run.max_step)
+      run.max_step = s;
+    run.distance += s;
+  }
+  return run;
+}
+
+int main() {
+  const unsigned long kDurationMs = 60000;
+  const long kExpected = kSpeedPxPerSec * kDurationMs / 1000;
+
+  // no edge: steps up to GAP_BAND, every frame rate the scheduler picks covers the same distance
+  for (unsigned long fps : {10ul, 25ul, 40ul, 60ul})
+    for (int jitter : {0, 30}) {
+      Run run = RunFrames(fps * 7 + jitter, fps, jitter, kGapBand, 0, 0, kDurationMs);
+      CHECK(run.max_step <= kGapBand);
+      CHECK(labs(run.distance - kExpected) <= kExpected / 100);
+      printf("  %2lu fps, jitter %2d%%: %ld px of %ld, largest step %d\n", fps, jitter, run.distance, kExpected, run.max_step);
+    }
+
+  // colored edge: 1 px steps, the frame rate is raised to kSpeedPxPerSec so the distance holds
+  for (int jitter : {0, 30}) {
+    Run run = RunFrames(99 + jitter, kSpeedPxPerSec, jitter, 1, 0, 0, kDurationMs);
+    CHECK(run.max_step == 1);
+    CHECK(labs(run.distance - kExpected) <= kExpected * 3 / 100);
+    printf("  edge, %2lu fps, jitter %2d%%: %ld px of %ld\n", kSpeedPxPerSec, jitter, run.distance, kExpected);
+  }
+  // below that frame rate the edge slows down rather than dotting its trail
+  Run slow = RunFrames(5, 10, 0, 1, 0, 0, kDurationMs);
+  CHECK(slow.max_step == 1 && slow.distance <= (long)(10 * kDurationMs / 1000));
+
+  // a blocked loop: stall time past kMaxFrameGapMs is dropped, the rest is caught up without a big step
+  for (unsigned long stall : {100ul, 400ul, 2000ul}) {
+    Run run = RunFrames(stall, 25, 10, kGapBand, stall, 50, kDurationMs);
+    CHECK(run.max_step <= kGapBand);
+    long expected = kSpeedPxPerSec * (kDurationMs - run.stalled_ms) / 1000;
+    CHECK(run.distance <= expected + 1);
+    CHECK(run.distance >= expected * 95 / 100);
+    printf("  stall %4lu ms every 50 frames: %ld px of %ld owed, largest step %d\n", stall, run.distance, expected, run.max_step);
+  }
+
+  printf("test_screensaver_step passed\n");
+  return 0;
+}
@@ -0,0 +1,217 @@
+// SntpMath against a local NTP stand-in: a UDP server thread on 127.0.0.1 keeps its own clock at a known offset from
+// the client and answers real request packets. Time is a fake clock that only moves when the test or the stand-in
+// steps it (forward path, server processing, return path, time spent after sampling), so round trips and errors are
+// exact whatever the host scheduler does. The client runs the WiFiStuff::GetSntpTime steps with a micros() that wraps
+// mid test, picks the best sample and works out the next second the way GetTimeFromNtpServer does, including after
+// samples that took longer than a second.
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <initializer_list>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "sntp_math.h"
+#include "test_util.h"
+
+static const int64_t kServerOffsetUs = 123456789;   // stand-in clock ahead of the client by this
+
+// fake time, microseconds since 1970 on the client side
+static std::atomic<int64_t> g_now_us{1700000000000000};
+static void Advance(int64_t us) { g_now_us += us; }
+static int64_t ServerUs() { return g_now_us + kServerOffsetUs; }
+
+// micros() stand-in, wraps partway through the test
+static uint32_t g_micros_base;
+static uint32_t Micros() { return (uint32_t)g_now_us - g_micros_base; }
+
+static void WriteBigEndian32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+static void WriteNtpTime(uint8_t* p, int64_t unix_us) {
+  int64_t seconds = unix_us / 1000000;
+  WriteBigEndian32(p, (uint32_t)(seconds + SntpMath::kNtpToUnixSeconds));
+  WriteBigEndian32(p + 4, (uint32_t)(((uint64_t)(unix_us - seconds * 1000000) << 32) / 1000000));
+}
+
+class NtpStandIn {
+public:
+  NtpStandIn() {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK(fd_ >= 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CHECK(bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    CHECK(getsockname(fd_, (struct sockaddr*)&addr, &len) == 0);
+    port = ntohs(addr.sin_port);
+    struct timeval tv = { 0, 50000 };
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    thread_ = std::thread([this] { Serve(); });
+  }
+  ~NtpStandIn() {
+    stop_ = true;
+    thread_.join();
+    close(fd_);
+  }
+
+  uint16_t port;
+  // fake time the next request spends on the way in, in the server, and on the way back
+  std::atomic<int32_t> forward_us{0}, processing_us{300}, return_us{0};
+  // reply stratum, 0 = kiss of death
+  std::atomic<int> stratum{2};
+
+private:
+  // the client is blocked in recv while this runs, so the clock steps here are all that happens to time
+  void Serve() {
+    uint8_t packet[64];
+    while(!stop_) {
+      struct sockaddr_in from;
+      socklen_t from_len = sizeof(from);
+      ssize_t n = recvfrom(fd_, packet, sizeof(packet), 0, (struct sockaddr*)&from, &from_len);
+      if(n < SntpMath::kPacketSize)
+        continue;
+      Advance(forward_us);
+      uint8_t reply[SntpMath::kPacketSize] = {};
+      reply[0] = (0 << 6) | (4 << 3) | 4;
+      reply[1] = stratum;
+      memcpy(reply + 24, packet + 40, 8);   // originate = client transmit
+      WriteNtpTime(reply + 32, ServerUs());
+      Advance(processing_us);               // not part of the round trip
+      WriteNtpTime(reply + 40, ServerUs());
+      Advance(return_us);
+      sendto(fd_, reply, sizeof(reply), 0, (struct sockaddr*)&from, from_len);
+    }
+  }
+
+  int fd_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+class Client {
+public:
+  explicit Client(uint16_t port) {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK(fd_ >= 0);
+    server_.sin_family = AF_INET;
+    server_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server_.sin_port = htons(port);
+    struct timeval tv = { 2, 0 };
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  }
+  ~Client() { close(fd_); }
+
+  // one request and its reply, false if there was no usable one
+  bool Sample(uint32_t cookie, SntpMath::Sample* sample, uint32_t reply_cookie = 0) {
+    uint8_t packet[SntpMath::kPacketSize];
+    SntpMath::MakeRequest(packet, reply_cookie ? reply_cookie : cookie);
+    uint32_t t1 = Micros();
+    sendto(fd_, packet, sizeof(packet), 0, (struct sockaddr*)&server_, sizeof(server_));
+    CHECK(recv(fd_, packet, sizeof(packet), 0) == SntpMath::kPacketSize);
+    uint32_t t4 = Micros();
+    return SntpMath::ParseReply(packet, cookie, t1, t4, sample);
+  }
+
+private:
+  int fd_;
+  struct sockaddr_in server_ = {};
+};
+
+static void TestSamples() {
+  NtpStandIn server;
+  Client client(server.port);
+
+  // forward and return path delays, the symmetric 2 ms round trip is the one to pick
+  const int32_t kForwardUs[] = { 4000, 1000, 1000, 12000 };
+  const int32_t kReturnUs[] = { 30000, 7000, 1000, 3000 };
+  SntpMath::Sample samples[4];
+  for (int i = 0; i < 4; i++) {
+    server.forward_us = kForwardUs[i];
+    server.return_us = kReturnUs[i];
+    CHECK(client.Sample(0x1000 + i, &samples[i]));
+    CHECK(llabs(samples[i].round_trip_us - (kForwardUs[i] + kReturnUs[i])) <= 2);
+    Advance(20000);
+  }
+  const SntpMath::Sample* best = SntpMath::Best(samples, 4);
+  CHECK(best == &samples[2]);
+  CHECK(SntpMath::Best(samples, 0) == nullptr);
+
+  // each sample is off by half its path asymmetry, however long ago it was taken
+  for (int i = 0; i < 4; i++) {
+    int64_t error = SntpMath::UtcUsAt(samples[i], Micros()) - ServerUs();
+    CHECK(llabs(error - (kForwardUs[i] - kReturnUs[i]) / 2) <= 2);
+  }
+  CHECK(llabs(SntpMath::UtcUsAt(*best, Micros()) - ServerUs()) <= 2);
+
+  // replies that must not become samples: someone else's cookie, kiss of death
+  server.forward_us = server.return_us = 500;
+  SntpMath::Sample s;
+  CHECK(!client.Sample(0x2000, &s, 0x2001));
+  server.stratum = 0;
+  CHECK(!client.Sample(0x2002, &s));
+  server.stratum = 2;
+  CHECK(client.Sample(0x2003, &s));
+}
+
+// GetTimeFromNtpServer after sampling: the second set has to start after now, even when the samples after the best
+// one took the rest of its second and more
+static void TestNextSecond() {
+  NtpStandIn server;
+  Client client(server.port);
+  server.forward_us = 1500;
+  server.return_us = 2500;
+  for (int32_t late_us : { 0, 1, 400000, 999999, 1300000, 5000000 }) {
+    // samples land anywhere in a second
+    Advance(137777);
+    SntpMath::Sample best;
+    CHECK(client.Sample(0x3000 + late_us, &best));
+    Advance(late_us);
+    uint32_t now = Micros();
+    uint32_t at_micros;
+    int64_t second = SntpMath::NextSecondAfter(best, now, &at_micros);
+    int32_t wait_us = (int32_t)(at_micros - now);
+    CHECK(wait_us > 0 && wait_us <= 1000000);
+    // the sample's own boundary, used before, is in the past once late_us is past the rest of its second
+    int64_t old_second = best.utc_us_at_t4 / 1000000 + 1;
+    bool old_in_past = (int32_t)(best.t4_micros + (uint32_t)(old_second * 1000000 - best.utc_us_at_t4) - now) <= 0;
+    CHECK_EQ(old_in_past, second > old_second);
+
+    // wait like RTC::SetTimeAtSecond, the server clock is then on that second, off by the sample's asymmetry
+    Advance(wait_us);
+    CHECK(llabs(ServerUs() - second * 1000000 - (2500 - 1500) / 2) <= 2);
+    printf("  %7d us after the sample: waited %6d us for second %lld%s\n", late_us, wait_us, (long long)second, old_in_past ? ", its own boundary long gone" : "");
+  }
+}
+
+// timestamp conversion against hand worked values
+static void TestConversions() {
+  CHECK_EQ(SntpMath::NtpToUnixUs(SntpMath::kNtpToUnixSeconds, 0), 0);
+  CHECK_EQ(SntpMath::NtpToUnixUs(SntpMath::kNtpToUnixSeconds + 1, 0x80000000u), 1500000);
+  // era 0 runs to 2036, the device sees dates until then
+  CHECK_EQ(SntpMath::NtpToUnixUs(0xFFFFFFFFu, 0), ((int64_t)0xFFFFFFFFu - SntpMath::kNtpToUnixSeconds) * 1000000);
+  uint8_t p[8];
+  for (int64_t us : { (int64_t)1700000000123456, (int64_t)946684800000000, (int64_t)2000000000999999 }) {
+    WriteNtpTime(p, us);
+    CHECK(llabs(SntpMath::NtpToUnixUs(SntpMath::ReadBigEndian32(p), SntpMath::ReadBigEndian32(p + 4)) - us) <= 1);
+  }
+}
+
+int main() {
+  // micros() wraps 100 ms in, during the samples
+  g_micros_base = (uint32_t)g_now_us - (0xFFFFFFFFu - 100000);
+  TestConversions();
+  TestSamples();
+  TestNextSecond();
+  CHECK(Micros() < 0x80000000u);
+  printf("test_sntp passed\n");
+  return 0;
+}
@@ -0,0 +1,167 @@
+// SpanTextCanvas1 against Adafruit_GFX drawChar / print into a plain GFXcanvas1: every glyph of every full font at
+// every bit alignment, and random strings with newlines, wrap and clipping on all sides, in set and clear color.
+
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMono9pt7b.h"
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeSans12pt7b.h"
+#include "Fonts/FreeSansBold12pt7b.h"
+#include "Fonts/FreeSans18pt7b.h"
+#include "Fonts/Satisfy_Regular18pt7b.h"
+#include "Fonts/Satisfy_Regular24pt7b.h"
+#include "Fonts/FreeSans24pt7b.h"
+#include "Fonts/FreeSansBold24pt7b.h"
+#include "Fonts/FreeSansBold48pt7b.h"
+#include "Fonts/ComingSoon_Regular70pt7b.h"
+#include "gfx_canvases.h"
+#include "test_util.h"
+
+static const struct { const char* name; const GFXfont* font; } kFonts[] = {
+  { "FreeMono9pt7b", &FreeMono9pt7b },
+  { "FreeMonoBold9pt7b", &FreeMonoBold9pt7b },
+  { "FreeSans12pt7b", &FreeSans12pt7b },
+  { "FreeSansBold12pt7b", &FreeSansBold12pt7b },
+  { "FreeSans18pt7b", &FreeSans18pt7b },
+  { "Satisfy_Regular18pt7b", &Satisfy_Regular18pt7b },
+  { "Satisfy_Regular24pt7b", &Satisfy_Regular24pt7b },
+  { "FreeSans24pt7b", &FreeSans24pt7b },
+  { "FreeSansBold24pt7b", &FreeSansBold24pt7b },
+  { "FreeSansBold48pt7b", &FreeSansBold48pt7b },
+  { "ComingSoon_Regular70pt7b", &ComingSoon_Regular70pt7b },
+};
+
+static void Fill(TestRandom& rnd, GFXcanvas1& a, GFXcanvas1& b) {
+  int bytes = ((a.width() + 7) / 8) * a.height();
+  int kind = rnd.Range(0, 2);
+  for (int i = 0; i < bytes; i++)
+    a.getBuffer()[i] = b.getBuffer()[i] = (kind == 0 ? 0x00 : (kind == 1 ? 0xFF : (uint8_t)rnd.Next()));
+}
+
+static void CheckSame(const GFXcanvas1& a, const GFXcanvas1& b) {
+  CHECK_EQ(a.getCursorX(), b.getCursorX());
+  CHECK_EQ(a.getCursorY(), b.getCursorY());
+  int bytes = ((a.width() + 7) / 8) * a.height();
+  for (int i = 0; i < bytes; i++)
+    if(a.getBuffer()[i] != b.getBuffer()[i]) {
+      for (int16_t y = 0; y < a.height(); y++)
+        for (int16_t x = 0; x < a.width(); x++)
+          CHECK_EQ(a.getPixel(x, y), b.getPixel(x, y));
+      // differing bits past the row end are padding, not pixels
+      return;
+    }
+}
+
+// Adafruit_GFX drawChar keeps its bitmap read offset in 16 bits, so glyphs stored past 64 KB into a font bitmap
+// (the last letters of ComingSoon_Regular70pt7b) come out wrapped there, the span canvas reads them as stored
+static bool GfxDrawsGlyph(const GFXfont* font, uint8_t c) {
+  if(c < font->first || c > font->last)
+    return true;
+  const GFXglyph& glyph = font->glyph[c - font->first];
+  return glyph.bitmapOffset + (glyph.width * glyph.height + 7) / 8 <= 0x10000;
+}
+
+static void Setup(GFXcanvas1& canvas, const GFXfont* font, int16_t x, int16_t y, uint16_t color, bool wrap) {
+  canvas.setFont(font);
+  canvas.setTextColor(color);
+  canvas.setTextWrap(wrap);
+  canvas.setCursor(x, y);
+}
+
+// each glyph alone at 8 bit alignments and near every edge
+static void TestEveryGlyph(const GFXfont* font) {
+  TestRandom rnd(3);
+  uint8_t first = font->first, last = font->last;
+  for (int c = first; c <= last; c++)
+    for (int16_t x = -9; x < 160 && GfxDrawsGlyph(font, c); x += 13) {
+      int16_t w = 120 + (c & 7), h = 40 + (c % 50);
+      GFXcanvas1 gfx(w, h);
+      SpanTextCanvas1 span(w, h);
+      Fill(rnd, gfx, span);
+      int16_t y = rnd.Range(-10, h + 30);
+      uint16_t color = ((c + x) % 5 == 0 ? 0 : 1);
+      Setup(gfx, font, x, y, color, false);
+      Setup(span, font, x, y, color, false);
+      gfx.write((uint8_t)c);
+      span.write((uint8_t)c);
+      CheckSame(gfx, span);
+    }
+}
+
+// random strings through print, wrap on and off, cursor anywhere
+static void TestStrings(const GFXfont* font) {
+  TestRandom rnd(11);
+  for (int trial = 0; trial < 300; trial++) {
+    int16_t w = rnd.Range(1, 330), h = rnd.Range(1, 160);
+    GFXcanvas1 gfx(w, h);
+    SpanTextCanvas1 span(w, h);
+    Fill(rnd, gfx, span);
+    char str[24];
+    int len = rnd.Range(1, sizeof(str) - 1);
+    for (int i = 0; i < len; i++) {
+      int k = rnd.Range(0, 40);
+      str[i] = (k == 0 ? '\n' : (k == 1 ? '\r' : (k == 2 ? (char)0x7F : (char)rnd.Range(0x20, 0x7E))));
+      if(!GfxDrawsGlyph(font, str[i]))
+        str[i] = '0';
+    }
+    str[len] = '\0';
+    int16_t x = rnd.Range(-60, w + 10), y = rnd.Range(-20, h + 60);
+    uint16_t color = (trial % 4 == 3 ? 0 : 1);
+    bool wrap = (trial & 1);
+    Setup(gfx, font, x, y, color, wrap);
+    Setup(span, font, x, y, color, wrap);
+    gfx.print(str);
+    span.print(str);
+    CheckSame(gfx, span);
+  }
+}
+
+// paths handed back to Adafruit_GFX: text size 2, rotation, span_glyphs off
+static void TestFallbacks() {
+  TestRandom rnd(17);
+  for (int k = 1; k < 4; k++) {
+    GFXcanvas1 gfx(200, 100);
+    SpanTextCanvas1 span(200, 100);
+    Fill(rnd, gfx, span);
+    Setup(gfx, &FreeSans12pt7b, 5, 40, 1, true);
+    Setup(span, &FreeSans12pt7b, 5, 40, 1, true);
+    if(k == 1) {
+      gfx.setTextSize(2);
+      span.setTextSize(2);
+    }
+    if(k == 2) {
+      gfx.setRotation(1);
+      span.setRotation(1);
+    }
+    if(k == 3)
+      span.span_glyphs = false;
+    gfx.print("Wake up 07:30");
+    span.print("Wake up 07:30");
+    CheckSame(gfx, span);
+  }
+}
+
+// canvas drawing into an outside buffer matches one owning its buffer
+static void TestArenaCanvas() {
+  static uint8_t arena[((97 + 7) / 8) * 60];
+  memset(arena, 0, sizeof(arena));
+  ArenaCanvas1 view(97, 60, arena);
+  SpanTextCanvas1 owned(97, 60);
+  owned.fillScreen(0);
+  Setup(view, &FreeSans18pt7b, -3, 35, 1, false);
+  Setup(owned, &FreeSans18pt7b, -3, 35, 1, false);
+  view.print("Tue 9 Jan");
+  owned.print("Tue 9 Jan");
+  CHECK(view.getBuffer() == arena);
+  CheckSame(view, owned);
+}
+
+int main() {
+  for (auto& f : kFonts) {
+    TestEveryGlyph(f.font);
+    TestStrings(f.font);
+  }
+  TestFallbacks();
+  TestArenaCanvas();
+  printf("test_span_text_canvas passed, %d fonts\n", (int)(sizeof(kFonts) / sizeof(kFonts[0])));
+  return 0;
+}
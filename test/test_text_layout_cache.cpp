@@ -0,0 +1,199 @@
+// TextLayoutCache::TextBounds against Adafruit_GFX getTextBounds and print for random strings in the page fonts, hit
+// and miss, multi line and too long to cache. Then LRU eviction order, and strings whose FNV-1a hashes collide,
+// found by a birthday search, each keeping its own layout.
+
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeMono9pt7b.h"
+#include "Fonts/FreeMonoBold9pt7b.h"
+#include "Fonts/FreeSans12pt7b.h"
+#include "Fonts/FreeSansBold12pt7b.h"
+#include "Fonts/FreeSans18pt7b.h"
+#include "general_constants.h"
+#include "text_layout_cache.h"
+#include "test_util.h"
+
+static const GFXfont* const kFonts[] = { &FreeMono9pt7b, &FreeMonoBold9pt7b, &FreeSans12pt7b, &FreeSansBold12pt7b, &FreeSans18pt7b };
+
+static GFXcanvas1 screen(kTftWidth, kTftHeight);
+
+// printable ASCII mostly, now and then a byte outside the fonts, a carriage return or a new line
+static std::string RandomString(TestRandom& rnd, int max_len, bool newlines) {
+  std::string str;
+  int len = rnd.Range(0, max_len);
+  for (int i = 0; i < len; i++) {
+    int kind = rnd.Range(0, 40);
+    if(kind == 0)
+      str += (char)rnd.Range(0x80, 0xFF);
+    else if(kind == 1)
+      str += '\r';
+    else if(kind == 2 && newlines)
+      str += '\n';
+    else
+      str += (char)rnd.Range(0x20, 0x7E);
+  }
+  return str;
+}
+
+static void CheckBounds(TextLayoutCache& cache, const GFXfont* font, const char* str, int16_t x, int16_t y) {
+  int16_t x1, y1, ex1, ey1, x_advance;
+  uint16_t w, h, ew, eh;
+  cache.TextBounds(screen, font, str, x, y, &x1, &y1, &w, &h, &x_advance);
+  screen.getTextBounds(str, x, y, &ex1, &ey1, &ew, &eh);
+  CHECK_EQ(x1, ex1);
+  CHECK_EQ(y1, ey1);
+  CHECK_EQ(w, ew);
+  CHECK_EQ(h, eh);
+  // the cursor moves by x_advance when the string is printed, single line only
+  if(strchr(str, '\n') == NULL) {
+    screen.setCursor(x, y);
+    screen.print(str);
+    CHECK_EQ(screen.getCursorX() - x, x_advance);
+  }
+}
+
+// cursor far enough right and down that no glyph reaches above or left of the screen, getTextBounds then has
+// nothing clipped by its -1 initial max and the two agree exactly
+static void TestAgainstGetTextBounds() {
+  TestRandom rnd(146);
+  screen.setTextWrap(false);
+  for (const GFXfont* font : kFonts) {
+    TextLayoutCache cache;
+    std::string recent[8];
+    for (int k = 0; k < 4000; k++) {
+      // a third of the strings repeat so they come from the cache, some are longer than the cache takes
+      std::string str = (k % 3 == 0 ? recent[rnd.Range(0, 7)] : RandomString(rnd, (k % 10 == 0 ? 40 : 20), k % 7 == 0));
+      recent[k % 8] = str;
+      CheckBounds(cache, font, str.c_str(), rnd.Range(0, kTftWidth - 1), rnd.Range(60, kTftHeight + 100));
+    }
+    CHECK(cache.hits > 500 && cache.misses > 500);
+  }
+}
+
+// bounds only translate with the cursor, also where getTextBounds itself would clip at 0
+static void TestTranslation() {
+  TestRandom rnd(147);
+  screen.setTextWrap(false);
+  TextLayoutCache cache;
+  for (int k = 0; k < 2000; k++) {
+    std::string str = RandomString(rnd, 12, false);
+    const GFXfont* font = kFonts[rnd.Range(0, 4)];
+    int16_t x = rnd.Range(-200, 200), y = rnd.Range(-100, 100);
+    int16_t x1, y1, ex1, ey1;
+    uint16_t w, h, ew, eh;
+    cache.TextBounds(screen, font, str.c_str(), x, y, &x1, &y1, &w, &h);
+    screen.getTextBounds(str.c_str(), x + 1000, y + 1000, &ex1, &ey1, &ew, &eh);
+    CHECK_EQ(x1, ex1 - 1000);
+    CHECK_EQ(y1, ey1 - 1000);
+    CHECK_EQ(w, ew);
+    CHECK_EQ(h, eh);
+  }
+}
+
+static bool Hit(TextLayoutCache& cache, const GFXfont* font, const char* str) {
+  TextLayoutCache::Layout layout;
+  return cache.Lookup(font, str, &layout);
+}
+
+static void TestLru() {
+  screen.setTextWrap(false);
+  TextLayoutCache cache;
+  char str[32];
+  int16_t x1, y1;
+  uint16_t w, h;
+  const int n = TextLayoutCache::kEntries;
+  // fill, then use the first half again so the second half is least recently used
+  for (int i = 0; i < n; i++) {
+    snprintf(str, sizeof(str), "entry %d", i);
+    cache.TextBounds(screen, &FreeSans12pt7b, str, 0, 0, &x1, &y1, &w, &h);
+  }
+  CHECK_EQ(cache.misses, n);
+  for (int i = 0; i < n / 2; i++) {
+    snprintf(str, sizeof(str), "entry %d", i);
+    cache.TextBounds(screen, &FreeSans12pt7b, str, 0, 0, &x1, &y1, &w, &h);
+  }
+  CHECK_EQ(cache.hits, n / 2);
+  // new strings push out the second half in the order it was last used. A hit counts as a use, so only misses
+  // are looked up until the end
+  for (int i = n; i < n + n / 2; i++) {
+    snprintf(str, sizeof(str), "entry %d", i);
+    cache.TextBounds(screen, &FreeSans12pt7b, str, 0, 0, &x1, &y1, &w, &h);
+    snprintf(str, sizeof(str), "entry %d", i - n / 2);
+    CHECK(!Hit(cache, &FreeSans12pt7b, str));
+  }
+  for (int i = 0; i < n + n / 2; i++) {
+    snprintf(str, sizeof(str), "entry %d", i);
+    CHECK_EQ(Hit(cache, &FreeSans12pt7b, str), (i < n / 2 || i >= n));
+  }
+  // the same string in another font is another entry
+  CHECK(!Hit(cache, &FreeMono9pt7b, "entry 0"));
+
+  // strings past kMaxStrLen are measured every time and take no entry
+  std::string at_max(TextLayoutCache::kMaxStrLen, 'x'), too_long(TextLayoutCache::kMaxStrLen + 1, 'x');
+  unsigned long misses = cache.misses;
+  for (int k = 0; k < 2; k++) {
+    cache.TextBounds(screen, &FreeSans12pt7b, at_max.c_str(), 0, 0, &x1, &y1, &w, &h);
+    cache.TextBounds(screen, &FreeSans12pt7b, too_long.c_str(), 0, 0, &x1, &y1, &w, &h);
+  }
+  CHECK_EQ(cache.misses - misses, 3);
+  CHECK(Hit(cache, &FreeSans12pt7b, at_max.c_str()));
+  CHECK(!Hit(cache, &FreeSans12pt7b, too_long.c_str()));
+}
+
+// FNV-1a collisions among 10 letter strings, found by the birthday bound in about 2^16 tries each
+static void TestHashCollisions() {
+  screen.setTextWrap(false);
+  TestRandom rnd(1469598103);
+  std::unordered_map<uint32_t, std::string> seen;
+  std::vector<std::pair<std::string, std::string>> pairs;
+  long tries = 0;
+  while(pairs.size() < (size_t)TextLayoutCache::kEntries / 2) {
+    char str[11];
+    for (int i = 0; i < 10; i++)
+      str[i] = 'a' + rnd.Range(0, 25);
+    str[10] = '\0';
+    size_t len;
+    uint32_t hash = TextLayoutCache::Hash(str, &len);
+    tries++;
+    auto it = seen.find(hash);
+    if(it == seen.end())
+      seen[hash] = str;
+    else if(it->second != str) {
+      pairs.push_back({ it->second, str });
+      seen.erase(it);
+    }
+  }
+
+  TextLayoutCache cache;
+  size_t len;
+  for (auto& pair : pairs) {
+    CHECK(pair.first != pair.second);
+    CHECK_EQ(TextLayoutCache::Hash(pair.first.c_str(), &len), TextLayoutCache::Hash(pair.second.c_str(), &len));
+    // made up layouts that differ, each string must get its own back
+    TextLayoutCache::Layout a = { 1, 2, 3, 4, 5 }, b = { 6, 7, 8, 9, 10 }, got;
+    cache.Insert(&FreeSans12pt7b, pair.first.c_str(), a);
+    cache.Insert(&FreeSans12pt7b, pair.second.c_str(), b);
+    CHECK(cache.Lookup(&FreeSans12pt7b, pair.first.c_str(), &got) && got.x1 == a.x1 && got.x_advance == a.x_advance);
+    CHECK(cache.Lookup(&FreeSans12pt7b, pair.second.c_str(), &got) && got.x1 == b.x1 && got.x_advance == b.x_advance);
+  }
+  // and measured through TextBounds, a full cache of colliding pairs matches getTextBounds on hits
+  TextLayoutCache measured;
+  for (int round = 0; round < 3; round++)
+    for (auto& pair : pairs)
+      for (const std::string* str : { &pair.first, &pair.second })
+        CheckBounds(measured, &FreeSans12pt7b, str->c_str(), 20, 100);
+  CHECK_EQ(measured.misses, 2 * pairs.size());
+  printf("  %zu colliding pairs in %ld tries, e.g. \"%s\" and \"%s\"\n", pairs.size(), tries, pairs[0].first.c_str(), pairs[0].second.c_str());
+}
+
+int main() {
+  TestAgainstGetTextBounds();
+  TestTranslation();
+  TestLru();
+  TestHashCollisions();
+  printf("test_text_layout_cache passed\n");
+  return 0;
+}
@@ -0,0 +1,70 @@
+// TimeMath against gmtime for every day from 1970 to 2100, with a random time of day each day, plus week days before
+// 1970 and the 12 hour clock conversions for every minute of the day.
+
+#include <stdint.h>
+#include <time.h>
+#include "time_math.h"
+#include "test_util.h"
+
+static void TestEveryDay() {
+  TestRandom rnd(1970);
+  const int32_t last_day = TimeMath::DaysFromCivil(2100, 12, 31);
+  int32_t prev_year = 1969;
+  for (int32_t days = 0; days <= last_day; days++) {
+    uint32_t epoch = (uint32_t)days * TimeMath::kSecondsPerDay + rnd.Range(0, TimeMath::kSecondsPerDay - 1);
+    time_t t = epoch;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+
+    int32_t year;
+    uint8_t month, day, hour, minute, second, day_of_week;
+    TimeMath::EpochToCivil(epoch, year, month, day, hour, minute, second, day_of_week);
+    CHECK_EQ(year, tm.tm_year + 1900);
+    CHECK_EQ(month, tm.tm_mon + 1);
+    CHECK_EQ(day, tm.tm_mday);
+    CHECK_EQ(hour, tm.tm_hour);
+    CHECK_EQ(minute, tm.tm_min);
+    CHECK_EQ(second, tm.tm_sec);
+    CHECK_EQ(day_of_week, tm.tm_wday);
+
+    // and back
+    CHECK_EQ(TimeMath::DaysFromCivil(year, month, day), days);
+    // years run on without a gap
+    CHECK(year == prev_year || (year == prev_year + 1 && month == 1 && day == 1));
+    prev_year = year;
+  }
+  CHECK_EQ(prev_year, 2100);
+  printf("  %d days, 1970 - 2100\n", (int)last_day + 1);
+}
+
+// before 1970 through the negative days branch, a week day is just days mod 7
+static void TestNegativeDays() {
+  for (int32_t days = -800000; days < 800; days++) {
+    CHECK_EQ(TimeMath::WeekdayFromDays(days), ((days + 4) % 7 + 7) % 7);
+    int32_t year;
+    uint8_t month, day;
+    TimeMath::CivilFromDays(days, year, month, day);
+    CHECK_EQ(TimeMath::DaysFromCivil(year, month, day), days);
+  }
+  CHECK_EQ(TimeMath::DaysFromCivil(1969, 12, 31), -1);
+  CHECK_EQ(TimeMath::DaysFromCivil(2000, 3, 1), 11017);
+}
+
+static void TestTwelveHour() {
+  for (uint16_t minutes = 0; minutes < 24 * 60; minutes++) {
+    uint8_t am_pm, hr, min;
+    TimeMath::DaysMinutesTo12Hour(minutes, am_pm, hr, min);
+    CHECK(hr >= 1 && hr <= 12 && min < 60);
+    CHECK_EQ(am_pm, (minutes < 12 * 60 ? 1 : 2));
+    CHECK_EQ(TimeMath::ClockTimeToDaysMinutes(am_pm, hr, min), minutes);
+    CHECK_EQ(TimeMath::ClockTimeToDaysMinutes(0, minutes / 60, minutes % 60), minutes);
+  }
+}
+
+int main() {
+  TestEveryDay();
+  TestNegativeDays();
+  TestTwelveHour();
+  printf("test_time_math passed\n");
+  return 0;
+}
@@ -0,0 +1,93 @@
+// TimeRowLayout::DirtyColumns: redrawing only the dirty columns of the main page time row gives the same pixels as a
+// full redraw, and a seconds tick inside a minute redraws no more than the seconds digits that changed
+
+#include <string.h>
+#include "time_row_draw.h"
+#include "test_util.h"
+
+static GFXcanvas1 old_full(kTftWidth, kRowH), new_full(kTftWidth, kRowH);
+static TimeRowLayout layout(&FreeSansBold48pt7b, &FreeSans18pt7b);
+static long tight = 0, checked = 0, second_ticks = 0, second_tick_columns = 0;
+
+// cursor x of :SS, kDisplayTextGap after HH:MM
+static int16_t SecondsX(const RowText& r) {
+  int16_t x = r.hh_x0;
+  for (const char* c = r.hhmm; *c; c++)
+    x += pgm_read_byte(&TimeRowLayout::FontGlyph(&FreeSansBold48pt7b, *c)->xAdvance);
+  return x + kDisplayTextGap;
+}
+
+// panel after a redraw of the dirty columns equals a full redraw of the new row
+static void CheckTransition(const RowText& old_r, const RowText& new_r) {
+  int16_t dirty_x0 = -1, dirty_x1 = -1;
+  bool dirty = layout.DirtyColumns(new_r.row(), old_r.row(), &dirty_x0, &dirty_x1);
+  if(dirty)
+    CHECK(dirty_x0 >= 0 && dirty_x0 <= dirty_x1 && dirty_x1 < kTftWidth);
+  DrawTimeRow(old_full, 0, old_r);
+  DrawTimeRow(new_full, 0, new_r);
+  int16_t first_diff = kTftWidth, last_diff = -1;
+  for (int16_t y = 0; y < kRowH; y++)
+    for (int16_t x = 0; x < kTftWidth; x++)
+      if(old_full.getPixel(x, y) != new_full.getPixel(x, y)) {
+        first_diff = std::min(first_diff, x);
+        last_diff = std::max(last_diff, x);
+      }
+  if(!dirty) {
+    // the panel keeps the old row, which must already be the new one
+    CHECK_EQ(last_diff, -1);
+    return;
+  }
+  GFXcanvas1 partial(dirty_x1 - dirty_x0 + 1, kRowH);
+  DrawTimeRow(partial, dirty_x0, new_r);
+  for (int16_t y = 0; y < kRowH; y++)
+    for (int16_t x = dirty_x0; x <= dirty_x1; x++)
+      CHECK_EQ(partial.getPixel(x - dirty_x0, y), new_full.getPixel(x, y));
+  // outside the dirty columns the panel keeps the old row
+  CHECK(last_diff < 0 || (first_diff >= dirty_x0 && last_diff <= dirty_x1));
+
+  // count cases where the dirty columns hug the changed ones, the bounds are not just always the whole row
+  tight += (last_diff >= 0 && first_diff - dirty_x0 <= 8 && dirty_x1 - last_diff <= 8);
+  checked++;
+  if(strcmp(old_r.hhmm, new_r.hhmm) == 0 && old_r._12_hour_mode == new_r._12_hour_mode && old_r.pm_not_am == new_r.pm_not_am &&
+     old_r.hh_x0 == new_r.hh_x0) {
+    // same minute: only :SS digits, never the ':' or anything left of it
+    const GFXglyph* colon = TimeRowLayout::FontGlyph(&FreeSans18pt7b, ':');
+    CHECK(dirty_x0 >= SecondsX(new_r) + pgm_read_byte(&colon->xAdvance) - 4);
+    if(old_r.ss[1] == new_r.ss[1]) {
+      // only the units digit changed
+      const GFXglyph* digit = TimeRowLayout::FontGlyph(&FreeSans18pt7b, '0');
+      CHECK(dirty_x1 - dirty_x0 < 2 * pgm_read_byte(&digit->xAdvance));
+      CHECK(dirty_x0 >= SecondsX(new_r) + pgm_read_byte(&colon->xAdvance) + pgm_read_byte(&digit->xAdvance) - 4);
+    }
+    second_ticks++;
+    second_tick_columns += dirty_x1 - dirty_x0 + 1;
+  }
+}
+
+int main() {
+  TestRandom rnd(3);
+  for (int mode = 0; mode < 2; mode++) {
+    bool _12_hour_mode = (mode == 1);
+    // every minute rollover of a day, the worst case for the HH:MM glyphs
+    for (int t = 59; t < 86400; t += 60)
+      CheckTransition(MakeRow(t, _12_hour_mode), MakeRow((t + 1) % 86400, _12_hour_mode));
+    // plain second ticks
+    for (int i = 0; i < 300; i++) {
+      int t = rnd.Range(0, 86399);
+      CheckTransition(MakeRow(t, _12_hour_mode), MakeRow((t + 1) % 86400, _12_hour_mode));
+    }
+    // time jumps, e.g. an NTP correction
+    for (int i = 0; i < 300; i++)
+      CheckTransition(MakeRow(rnd.Range(0, 86399), _12_hour_mode), MakeRow(rnd.Range(0, 86399), _12_hour_mode));
+  }
+  // 12 / 24 hour mode switches
+  for (int i = 0; i < 200; i++) {
+    int t = rnd.Range(0, 86399);
+    CheckTransition(MakeRow(t, i & 1), MakeRow(t, !(i & 1)));
+  }
+  CHECK(tight > checked / 2);
+  CHECK(second_ticks > 0);
+  printf("test_time_row_layout passed, %ld transitions, dirty columns within 8 px of the changed ones in %ld, "
+         "%ld px wide on average for %ld seconds ticks\n", checked, tight, second_tick_columns / second_ticks, second_ticks);
+  return 0;
+}
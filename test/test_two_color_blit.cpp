@@ -0,0 +1,108 @@
+// TwoColorLut row expansion and BlitTwoColorBitmap against Adafruit_GFX drawBitmap(color, bg) into a GFXcanvas16
+
+#include <Adafruit_GFX.h>
+#include "two_color_blit.h"
+#include "test_util.h"
+#include "mock_panel.h"
+
+// random bitmap where some bytes are all clear / all set, so both expander paths are hit
+static void FillBitmap(TestRandom& rnd, uint8_t* bitmap, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    int kind = rnd.Range(0, 3);
+    bitmap[i] = (kind == 0 ? 0x00 : (kind == 1 ? 0xFF : (uint8_t)rnd.Next()));
+  }
+}
+
+// every window [i, iLim) of every row matches what Adafruit_GFX draws for that bitmap
+static void TestExpandMatchesDrawBitmap() {
+  TestRandom rnd(1);
+  TwoColorLut lut;
+  const uint16_t kPairs[][2] = {{0xF800, 0x0000}, {0x07E0, 0x001F}, {0x0000, 0xFFFF}, {0x1234, 0x1234}};
+  for (int trial = 0; trial < 400; trial++) {
+    int16_t w = rnd.Range(1, 80), h = rnd.Range(1, 6);
+    int row_bytes = (w + 7) / 8;
+    uint8_t bitmap[row_bytes * h];
+    FillBitmap(rnd, bitmap, row_bytes * h);
+    uint16_t color = kPairs[trial % 4][0], bg = kPairs[trial % 4][1];
+
+    GFXcanvas16 ref(w, h);
+    ref.fillScreen(0xA5A5);
+    ref.drawBitmap(0, 0, bitmap, w, h, color, bg);
+
+    lut.Set(color, bg);
+    for (int16_t j = 0; j < h; j++) {
+      int16_t i = rnd.Range(0, w - 1), iLim = rnd.Range(i + 1, w);
+      if(trial % 5 == 0) {
+        i = 0;
+        iLim = w;
+      }
+      uint16_t row[w + 1];
+      row[iLim - i] = 0xBEEF;   // guard: nothing written past the window
+      lut.ExpandRow(bitmap + j * row_bytes, i, iLim, row);
+      for (int16_t k = i; k < iLim; k++)
+        CHECK_EQ(row[k - i], ref.getPixel(k, j));
+      CHECK_EQ(row[iLim - i], 0xBEEF);
+    }
+  }
+}
+
+// changing the color pair rebuilds the table, setting the same pair again keeps it
+static void TestColorPairChange() {
+  TwoColorLut lut;
+  const uint8_t bits[2] = {0xA5, 0x0F};
+  uint16_t row[16];
+  lut.Set(1, 2);
+  lut.ExpandRow(bits, 0, 16, row);
+  CHECK_EQ(row[0], 1);
+  CHECK_EQ(row[1], 2);
+  lut.Set(3, 4);
+  lut.ExpandRow(bits, 0, 16, row);
+  CHECK_EQ(row[0], 3);
+  CHECK_EQ(row[1], 4);
+  CHECK_EQ(row[15], 3);
+  lut.Set(3, 4);
+  CHECK_EQ(lut.color(), 3);
+  CHECK_EQ(lut.bg(), 4);
+}
+
+// clipped blits at random positions, partly or fully off the panel, land exactly where drawBitmap puts them
+static void TestBlitMatchesDrawBitmap() {
+  TestRandom rnd(2);
+  TwoColorLut lut;
+  const int16_t kPanelW = 64, kPanelH = 40;
+  for (int trial = 0; trial < 600; trial++) {
+    int16_t w = rnd.Range(1, 90), h = rnd.Range(1, 50);
+    int16_t x = rnd.Range(-w - 4, kPanelW + 4), y = rnd.Range(-h - 4, kPanelH + 4);
+    int row_bytes = (w + 7) / 8;
+    uint8_t bitmap[row_bytes * h];
+    FillBitmap(rnd, bitmap, row_bytes * h);
+    uint16_t color = (uint16_t)rnd.Next(), bg = (uint16_t)rnd.Next();
+
+    GFXcanvas16 ref(kPanelW, kPanelH);
+    ref.fillScreen(MockPanel::kUntouched);
+    ref.drawBitmap(x, y, bitmap, w, h, color, bg);
+
+    MockPanel panel(kPanelW, kPanelH);
+    lut.Set(color, bg);
+    BlitTwoColorBitmap(panel, lut, kPanelW, kPanelH, x, y, bitmap, w, h);
+
+    CHECK(panel.WindowComplete());
+    CHECK(panel.windows <= 1);
+    long visible = 0;
+    for (int16_t py = 0; py < kPanelH; py++)
+      for (int16_t px = 0; px < kPanelW; px++) {
+        CHECK_EQ(panel.Pixel(px, py), ref.getPixel(px, py));
+        visible += (px >= x && px < x + w && py >= y && py < y + h);
+      }
+    // only the visible part goes on the bus
+    CHECK_EQ(panel.pixels, visible);
+  }
+}
+
+int main() {
+  TestExpandMatchesDrawBitmap();
+  TestColorPairChange();
+  TestBlitMatchesDrawBitmap();
+  printf("test_two_color_blit passed\n");
+  return 0;
+}
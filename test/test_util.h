@@ -0,0 +1,54 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <chrono>
+
+// failed checks print where they are and end the test with exit code 1
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      exit(1); \
+    } \
+  } while(0)
+
+#define CHECK_EQ(a, b) do { \
+    long long check_a = (long long)(a), check_b = (long long)(b); \
+    if(check_a != check_b) { \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a, check_b); \
+      exit(1); \
+    } \
+  } while(0)
+
+// small deterministic generator so every run sees the same cases
+class TestRandom {
+public:
+  explicit TestRandom(uint32_t seed) : state_(seed ? seed : 1) {}
+  uint32_t Next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+  // uniform in [lo, hi]
+  int32_t Range(int32_t lo, int32_t hi) { return lo + (int32_t)(Next() % (uint32_t)(hi - lo + 1)); }
+
+private:
+  uint32_t state_;
+};
+
+// run fn iterations times and print average ns per call
+template <typename Fn>
+double Bench(const char* name, long iterations, Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++)
+    fn();
+  auto t1 = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+  printf("  %-44s %10.0f ns\n", name, ns);
+  return ns;
+}
+
+#endif  // TEST_UTIL_H
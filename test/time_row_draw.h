@@ -0,0 +1,54 @@
+#ifndef TIME_ROW_DRAW_H
+#define TIME_ROW_DRAW_H
+
+// main page time row text and drawing as RGBDisplay::DisplayTimeUpdate does it, shared by tests and benchmarks
+
+#include <stdio.h>
+#include <Adafruit_GFX.h>
+#include "Fonts/FreeSansBold48pt7b_numbers_only.h"
+#include "Fonts/FreeSans18pt7b.h"
+#include "time_row_layout.h"
+
+static const int16_t kRowH = kTimeRowY0 + 6;
+
+struct RowText {
+  char hhmm[kHHMM_ArraySize];
+  char ss[kSS_ArraySize];
+  bool _12_hour_mode, pm_not_am;
+  int16_t hh_x0;
+  TimeRowLayout::Row row() const { return {hhmm, ss, (_12_hour_mode ? (pm_not_am ? kPmLabel : kAmLabel) : NULL), hh_x0}; }
+};
+
+// same text as the clock shows for second of day t
+inline RowText MakeRow(int t, bool _12_hour_mode) {
+  RowText r;
+  int hour = t / 3600, minute = (t / 60) % 60, second = t % 60;
+  r._12_hour_mode = _12_hour_mode;
+  r.pm_not_am = (hour >= 12);
+  if(_12_hour_mode)
+    hour = (hour % 12 == 0 ? 12 : hour % 12);
+  snprintf(r.hhmm, sizeof(r.hhmm), "%d:%02d", hour, minute);
+  snprintf(r.ss, sizeof(r.ss), ":%02d", second);
+  r.hh_x0 = kTimeRowX0 + (hour >= 10 ? 0 : 30);
+  return r;
+}
+
+// time row layout of RGBDisplay::DisplayTimeUpdate on a canvas whose column 0 is panel column canvas_x0
+inline void DrawTimeRow(GFXcanvas1& canvas, int16_t canvas_x0, const RowText& r) {
+  canvas.fillScreen(0);
+  canvas.setTextWrap(false);
+  canvas.setTextColor(1);
+  canvas.setFont(&FreeSansBold48pt7b);
+  canvas.setCursor(r.hh_x0 - canvas_x0, kTimeRowY0);
+  canvas.print(r.hhmm);
+  int16_t x0_pos = canvas.getCursorX();
+  canvas.setFont(&FreeSans18pt7b);
+  if(r._12_hour_mode) {
+    canvas.setCursor(x0_pos + kDisplayTextGap, kAM_PM_row_Y0);
+    canvas.print(r.pm_not_am ? kPmLabel : kAmLabel);
+  }
+  canvas.setCursor(x0_pos + kDisplayTextGap, kTimeRowY0);
+  canvas.print(r.ss);
+}
+
+#endif  // TIME_ROW_DRAW_H
@@ -0,0 +1,129 @@
+#ifndef TEXT_LAYOUT_CACHE_H
+#define TEXT_LAYOUT_CACHE_H
+
+#include <string.h>
+#include <Adafruit_GFX.h>
+
+// Small LRU of getTextBounds results keyed by font and string, needs only Adafruit_GFX.
+// Text wrap is off and text size is 1, so bounds measured once away from the origin only translate with the cursor.
+// Entries are found by FNV-1a hash and confirmed by comparing the string, so two strings with the same hash each keep
+// their own layout.
+class TextLayoutCache {
+public:
+  struct Layout {
+    int16_t x1, y1;         // top left of bounds relative to cursor
+    uint16_t w, h;
+    int16_t x_advance;      // cursor movement after printing the string
+  };
+
+  static const int kEntries = 16;
+  static const int kMaxStrLen = 23;     // longer strings are not cached
+
+  // same results as gfx.getTextBounds of str in font at x, y, plus the cursor advance if x_advance is not NULL
+  // sets gfx's font to font
+  void TextBounds(Adafruit_GFX& gfx, const GFXfont* font, const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h, int16_t* x_advance = NULL) {
+    gfx.setFont(font);
+    Layout layout;
+    // multi line strings restart at x = 0 and do not translate with the cursor
+    if(strchr(str, '\n') != NULL) {
+      gfx.getTextBounds(str, x, y, x1, y1, w, h);
+      if(x_advance != NULL)
+        *x_advance = XAdvance(font, str);
+      return;
+    }
+    if(Lookup(font, str, &layout))
+      hits++;
+    else {
+      misses++;
+      // measure away from 0,0 so glyphs left of / above the cursor are not clipped by getTextBounds' -1 initial max
+      const int16_t kOrigin = 4096;
+      gfx.getTextBounds(str, kOrigin, kOrigin, &layout.x1, &layout.y1, &layout.w, &layout.h);
+      layout.x1 -= kOrigin;
+      layout.y1 -= kOrigin;
+      layout.x_advance = XAdvance(font, str);
+      Insert(font, str, layout);
+    }
+    *x1 = x + layout.x1;
+    *y1 = y + layout.y1;
+    *w = layout.w;
+    *h = layout.h;
+    if(x_advance != NULL)
+      *x_advance = layout.x_advance;
+  }
+
+  bool Lookup(const GFXfont* font, const char* str, Layout* layout) {
+    size_t len;
+    uint32_t hash = Hash(str, &len);
+    if(len > kMaxStrLen)
+      return false;
+    for (int i = 0; i < kEntries; i++) {
+      Entry &entry = entries_[i];
+      if(entry.last_used != 0 && entry.hash == hash && entry.font == font && strcmp(entry.str, str) == 0) {
+        entry.last_used = ++use_counter_;
+        *layout = entry.layout;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Insert(const GFXfont* font, const char* str, const Layout& layout) {
+    size_t len;
+    uint32_t hash = Hash(str, &len);
+    if(len > kMaxStrLen)
+      return;
+    // replace least recently used entry, never used entries have last_used 0
+    int lru = 0;
+    for (int i = 1; i < kEntries; i++)
+      if(entries_[i].last_used < entries_[lru].last_used)
+        lru = i;
+    Entry &entry = entries_[lru];
+    entry.font = font;
+    entry.hash = hash;
+    entry.last_used = ++use_counter_;
+    strcpy(entry.str, str);
+    entry.layout = layout;
+  }
+
+  // same glyph advance sum as Adafruit_GFX write() for a single line at text size 1
+  static int16_t XAdvance(const GFXfont* font, const char* str) {
+    if(font == NULL)
+      return 6 * strlen(str);
+    uint8_t first = pgm_read_byte(&font->first), last = pgm_read_byte(&font->last);
+    GFXglyph* font_glyphs = (GFXglyph*)pgm_read_ptr(&font->glyph);
+    int16_t x_advance = 0;
+    for (const char* c = str; *c; c++) {
+      uint8_t ch = (uint8_t)*c;
+      if(ch >= first && ch <= last)
+        x_advance += pgm_read_byte(&(font_glyphs + (ch - first))->xAdvance);
+    }
+    return x_advance;
+  }
+
+  // FNV-1a
+  static uint32_t Hash(const char* str, size_t* len) {
+    uint32_t hash = 2166136261u;
+    const char* c = str;
+    for (; *c; c++) {
+      hash ^= (uint8_t)*c;
+      hash *= 16777619u;
+    }
+    *len = c - str;
+    return hash;
+  }
+
+  unsigned long hits = 0, misses = 0;
+
+private:
+  struct Entry {
+    const GFXfont* font;
+    uint32_t hash;
+    uint32_t last_used;
+    char str[kMaxStrLen + 1];
+    Layout layout;
+  };
+  Entry entries_[kEntries] = {};
+  uint32_t use_counter_ = 0;
+};
+
+#endif // TEXT_LAYOUT_CACHE_H
@@ -0,0 +1,67 @@
+#ifndef TIME_MATH_H
+#define TIME_MATH_H
+
+#include <stdint.h>
+
+// Calendar and clock conversions without year or month loops, no Arduino dependencies.
+// Days are counted from 1 Jan 1970 in the proleptic Gregorian calendar. Civil date conversions are Howard Hinnant's
+// days_from_civil / civil_from_days (http://howardhinnant.github.io/date_algorithms.html): years are shifted to start
+// on 1 March so the leap day is the last day of the year, and 400 year eras make every step a division.
+class TimeMath {
+public:
+  static const uint32_t kSecondsPerDay = 86400;
+
+  // days since 1 Jan 1970, month_Jan_is_1 1 - 12, day 1 - 31
+  static int32_t DaysFromCivil(int32_t year, uint8_t month_Jan_is_1, uint8_t day) {
+    year -= (month_Jan_is_1 <= 2);
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t year_of_era = year - era * 400;                                                      // 0 - 399
+    const uint32_t day_of_year = (153 * (month_Jan_is_1 + (month_Jan_is_1 > 2 ? -3 : 9)) + 2) / 5 + day - 1;   // 0 - 365
+    const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;  // 0 - 146096
+    return era * 146097 + (int32_t)day_of_era - 719468;
+  }
+
+  static void CivilFromDays(int32_t days, int32_t &year, uint8_t &month_Jan_is_1, uint8_t &day) {
+    days += 719468;
+    const int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const uint32_t day_of_era = days - era * 146097;                                                   // 0 - 146096
+    const uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t month_Mar_is_0 = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * month_Mar_is_0 + 2) / 5 + 1;
+    month_Jan_is_1 = month_Mar_is_0 < 10 ? month_Mar_is_0 + 3 : month_Mar_is_0 - 9;
+    year = (int32_t)year_of_era + era * 400 + (month_Jan_is_1 <= 2);
+  }
+
+  // Sunday = 0, 1 Jan 1970 was a Thursday
+  static uint8_t WeekdayFromDays(int32_t days) {
+    return (days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+  }
+
+  // epoch seconds to date, time of day and week day
+  static void EpochToCivil(uint32_t epoch, int32_t &year, uint8_t &month_Jan_is_1, uint8_t &day, uint8_t &hour_24, uint8_t &minute, uint8_t &second, uint8_t &day_of_week_Sun_is_0) {
+    const int32_t days = epoch / kSecondsPerDay;
+    uint32_t seconds_of_day = epoch % kSecondsPerDay;
+    CivilFromDays(days, year, month_Jan_is_1, day);
+    day_of_week_Sun_is_0 = WeekdayFromDays(days);
+    hour_24 = seconds_of_day / 3600;
+    minute = seconds_of_day / 60 % 60;
+    second = seconds_of_day % 60;
+  }
+
+  // minutes since midnight to 12 hour clock: hour_mode_and_am_pm 1 = AM, 2 = PM, hour 1 - 12
+  static void DaysMinutesTo12Hour(uint16_t todays_minutes, uint8_t &hour_mode_and_am_pm, uint8_t &hr, uint8_t &min) {
+    const uint8_t hour_24 = todays_minutes / 60;
+    hour_mode_and_am_pm = (hour_24 < 12 ? 1 : 2);
+    hr = (hour_24 % 12 == 0 ? 12 : hour_24 % 12);
+    min = todays_minutes % 60;
+  }
+
+  // clock time to minutes since midnight, hour_mode_and_am_pm 0 = 24 hour mode (hr 0 - 23), 1 = AM, 2 = PM (hr 1 - 12)
+  static uint16_t ClockTimeToDaysMinutes(uint8_t hour_mode_and_am_pm, uint8_t hr, uint8_t min) {
+    const uint8_t hour_24 = (hour_mode_and_am_pm == 0 ? hr : hr % 12 + (hour_mode_and_am_pm == 2 ? 12 : 0));
+    return hour_24 * 60 + min;
+  }
+};
+
+#endif  // TIME_MATH_H
@@ -0,0 +1,91 @@
+#ifndef TIME_ROW_LAYOUT_H
+#define TIME_ROW_LAYOUT_H
+
+#include <Adafruit_GFX.h>
+#include "general_constants.h"
+
+// Main page time row geometry from GFX font metrics, needs only Adafruit_GFX types.
+// The row is HH:MM in the big font from hh_x0, then AM/PM above and :SS below in the small font, both kDisplayTextGap
+// after the HH:MM cursor. DirtyColumns finds the pixel columns that can differ between two such rows, so a redraw of
+// just those columns gives the same pixels as a full row redraw.
+class TimeRowLayout {
+public:
+  struct Row {
+    const char* hhmm;
+    const char* ss;
+    const char* am_pm;    // NULL in 24 hour mode
+    int16_t hh_x0;        // cursor x of HH:MM
+  };
+
+  TimeRowLayout(const GFXfont* hhmm_font, const GFXfont* small_font) : hhmm_font_(hhmm_font), small_font_(small_font) {}
+
+  static const GFXglyph* FontGlyph(const GFXfont* font, char c) {
+    uint8_t first = pgm_read_byte(&font->first), last = pgm_read_byte(&font->last);
+    if((uint8_t)c < first || (uint8_t)c > last)
+      return NULL;
+    return font->glyph + ((uint8_t)c - first);
+  }
+
+  // add the pixel columns of glyphs of str printed at cursor x to x0..x1, except glyphs that other printed at
+  // cursor other_x has too, same character at the same x; returns cursor x after str
+  static int16_t ChangedGlyphs(const GFXfont* font, const char* str, int16_t x, const char* other, int16_t other_x, int16_t &x0, int16_t &x1) {
+    for (; *str != '\0'; str++) {
+      const GFXglyph* glyph = FontGlyph(font, *str);
+      if(glyph == NULL)
+        continue;
+      if(!HasGlyphAt(font, other, other_x, *str, x)) {
+        int16_t glyph_x = x + (int8_t)pgm_read_byte(&glyph->xOffset);
+        uint8_t glyph_w = pgm_read_byte(&glyph->width);
+        if(glyph_w > 0 && pgm_read_byte(&glyph->height) > 0) {
+          x0 = min(x0, glyph_x);
+          x1 = max(x1, (int16_t)(glyph_x + glyph_w - 1));
+        }
+      }
+      x += pgm_read_byte(&glyph->xAdvance);
+    }
+    return x;
+  }
+
+  // true if str printed at cursor x draws c with its cursor at c_x
+  static bool HasGlyphAt(const GFXfont* font, const char* str, int16_t x, char c, int16_t c_x) {
+    for (; *str != '\0' && x <= c_x; str++) {
+      const GFXglyph* glyph = FontGlyph(font, *str);
+      if(glyph == NULL)
+        continue;
+      if(*str == c && x == c_x)
+        return true;
+      x += pgm_read_byte(&glyph->xAdvance);
+    }
+    return false;
+  }
+
+  // pixel columns x0 to x1 that can differ between new_row and old_row, false if none can
+  // text is drawn without background, so a column where both rows have the same glyphs at the same places is the
+  // same on both; the columns of every other glyph, of either row, are in x0..x1
+  bool DirtyColumns(const Row& new_row, const Row& old_row, int16_t* x0, int16_t* x1) const {
+    int16_t lo = INT16_MAX, hi = INT16_MIN;
+    int16_t new_x = ChangedGlyphs(hhmm_font_, new_row.hhmm, new_row.hh_x0, old_row.hhmm, old_row.hh_x0, lo, hi) + kDisplayTextGap;
+    int16_t old_x = ChangedGlyphs(hhmm_font_, old_row.hhmm, old_row.hh_x0, new_row.hhmm, new_row.hh_x0, lo, hi) + kDisplayTextGap;
+    // AM/PM above and :SS below both start kDisplayTextGap after HH:MM, on their own baselines
+    const char* new_am_pm = (new_row.am_pm != NULL ? new_row.am_pm : "");
+    const char* old_am_pm = (old_row.am_pm != NULL ? old_row.am_pm : "");
+    ChangedGlyphs(small_font_, new_am_pm, new_x, old_am_pm, old_x, lo, hi);
+    ChangedGlyphs(small_font_, old_am_pm, old_x, new_am_pm, new_x, lo, hi);
+    ChangedGlyphs(small_font_, new_row.ss, new_x, old_row.ss, old_x, lo, hi);
+    ChangedGlyphs(small_font_, old_row.ss, old_x, new_row.ss, new_x, lo, hi);
+
+    lo = max(lo, (int16_t)0);
+    hi = min(hi, (int16_t)(kTftWidth - 1));
+    if(lo > hi)
+      return false;
+    *x0 = lo;
+    *x1 = hi;
+    return true;
+  }
+
+private:
+  const GFXfont* hhmm_font_;
+  const GFXfont* small_font_;
+};
+
+#endif  // TIME_ROW_LAYOUT_H
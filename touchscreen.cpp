@@ -1,6 +1,7 @@
 #include "touchscreen.h"
 #include <SPI.h>
 #include "rgb_display.h"
+#include "adc_lock.h"
 #include "nvs_preferences.h"
 
 Touchscreen::Touchscreen() {
@@ -9,7 +10,9 @@ Touchscreen::Touchscreen() {
 
   if(touchscreen_type == 2) {       // MCU ADC
     touchscreen_r_ptr_ = new TouchscreenResistive(TOUCHSCREEN_XP, TOUCHSCREEN_XM, TOUCHSCREEN_YP, TOUCHSCREEN_YM, 310);
+    AdcLock::Take();
     analogReadResolution(kAdcResolutionBits);
+    AdcLock::Give();
     touchscreen_r_ptr_->setAdcResolutionAndThreshold(kAdcResolutionBits);
     touchscreen_calibration_ = TouchCalibration{150, 930, 150, 870, kTftWidth, kTftHeight};
   }
@@ -78,7 +81,10 @@ bool Touchscreen::IsTouched() {
   else {
     // read touch, if touched then read touch point
     if(touchscreen_type == 2) {       // MCU ADC
+      // plates are read on the ADC the photoresistor sampler also uses
+      AdcLock::Take();
       last_touch_Pixel_.is_touched = touchscreen_r_ptr_->touched();
+      AdcLock::Give();
       if(last_touch_Pixel_.is_touched)
         GetTouchedPixel();
     }
@@ -104,7 +110,9 @@ TouchPixel* Touchscreen::GetTouchedPixel() {
     int16_t x = -1, y = -1, z = -1;
     if(touchscreen_type == 2) {
       // get touch point using MCU ADC
+      AdcLock::Take();
       TsPoint touch = touchscreen_r_ptr_->getPoint();
+      AdcLock::Give();
       x = touch.x;
       y = touch.y;
       z = touch.z;
@@ -0,0 +1,217 @@
+#ifndef TWO_COLOR_BLIT_H
+#define TWO_COLOR_BLIT_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Monochrome bitmap row to RGB565 pixels, no Arduino dependencies.
+// A 256 x 8 lookup table holds the colors of every bit of every byte value for one color pair, so a row expands with
+// one memcpy per bitmap byte. Bytes that are all set or all clear are filled without touching the table.
+class TwoColorLut {
+public:
+  // fill table for this color pair: entry [b][k] is the color of bit (7 - k) of byte b
+  void Set(uint16_t color, uint16_t bg) {
+    if(valid_ && color_ == color && bg_ == bg)
+      return;
+    for (int b = 0; b < 256; b++)
+      for (int k = 0; k < 8; k++)
+        lut_[b][k] = (((b << k) & 0x80) ? color : bg);
+    color_ = color;
+    bg_ = bg;
+    valid_ = true;
+  }
+
+  // expand bits [i, iLim) of a monochrome bitmap row into RGB565 pixels
+  void ExpandRow(const uint8_t* bitmap_row, int16_t i, int16_t iLim, uint16_t* buffer16Bit) const {
+    while(i < iLim) {
+      uint8_t currentByte = bitmap_row[i >> 3];
+      uint8_t bitIndex = i & 7;
+      int16_t count = (iLim - i < 8 - bitIndex ? iLim - i : 8 - bitIndex);
+      if(count == 8 && (currentByte == 0x00 || currentByte == 0xFF)) {
+        // whole byte is one color
+        uint16_t fill = (currentByte ? color_ : bg_);
+        for (int k = 0; k < 8; k++)
+          buffer16Bit[k] = fill;
+      }
+      else
+        memcpy(buffer16Bit, &lut_[currentByte][bitIndex], count * sizeof(uint16_t));
+      buffer16Bit += count;
+      i += count;
+    }
+  }
+
+  uint16_t color() const { return color_; }
+  uint16_t bg() const { return bg_; }
+
+private:
+  uint16_t lut_[256][8];
+  uint16_t color_ = 0, bg_ = 0;
+  bool valid_ = false;
+};
+
+// Clip a w x h monochrome bitmap drawn at (x, y) to a panel_w x panel_h panel and send the visible part row by row:
+// sink.SetWindow(x, y, w, h) once, then sink.WritePixels(row, w) for each row, top to bottom.
+// Only bitmap columns [col0, col1) are sent, the whole width by default.
+// The sink owns the bus, each WritePixels may block until its row is out since the one row buffer is reused.
+template <typename Sink>
+void BlitTwoColorBitmap(Sink& sink, const TwoColorLut& lut, int16_t panel_w, int16_t panel_h, int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, int16_t col0 = 0, int16_t col1 = INT16_MAX) {
+  int16_t x2, y2;                   // Lower-right coord
+  if ((x >= panel_w) ||             // Off-edge right
+      (y >= panel_h) ||             // " top
+      ((x2 = (x + w - 1)) < 0) ||   // " left
+      ((y2 = (y + h - 1)) < 0))
+    return; // " bottom
+
+  int16_t bx1 = 0, by1 = 0,   // Clipped top-left within bitmap
+      saveW = w,              // Save original bitmap width value
+      saveH = h;
+  if (x < 0) {                // Clip left
+    w += x;
+    bx1 = -x;
+    x = 0;
+  }
+  if (y < 0) {                // Clip top
+    h += y;
+    by1 = -y;
+    y = 0;
+  }
+  if (x2 >= panel_w)
+    w = panel_w - x;          // Clip right
+  if (y2 >= panel_h)
+    h = panel_h - y;          // Clip bottom
+
+  int16_t jLim = (saveH < h + by1 ? saveH : h + by1);
+  int16_t iLim = (saveW < w + bx1 ? saveW : w + bx1);
+  int16_t bitmapWidthBytes = (saveW + 7) >> 3;
+  if (bx1 < col0) {           // Clip to column window
+    x += col0 - bx1;
+    bx1 = col0;
+  }
+  if (iLim > col1)
+    iLim = col1;
+  w = iLim - bx1;
+  if (w <= 0)
+    return;
+
+  // 16 bit buffer of length w to hold 1 row colors
+  uint16_t buffer16Bit[w];
+  sink.SetWindow(x, y, w, h);
+  for (int16_t j = by1; j < jLim; j++) {
+    lut.ExpandRow(bitmap + j * bitmapWidthBytes, bx1, iLim, buffer16Bit);
+    sink.WritePixels(buffer16Bit, w);
+  }
+}
+
+// place bits of a w pixel wide bitmap row, drawn at panel column x, into a panel aligned bit row
+// panel pixels outside the bitmap are 0
+inline void PanelBitRow(const uint8_t* bitmap_row, int16_t w, int16_t x, uint8_t* line, int16_t line_bytes) {
+  int16_t row_bytes = (w + 7) >> 3;
+  for (int16_t d = 0; d < line_bytes; d++) {
+    int16_t o = (d << 3) - x;     // bitmap bit under first pixel of this panel byte
+    if(o <= -8 || o >= w) {
+      line[d] = 0;
+      continue;
+    }
+    int16_t b = (o >= 0 ? o >> 3 : -1);
+    uint8_t s = o - (b << 3);
+    uint8_t lo = (b >= 0 ? bitmap_row[b] : 0);
+    uint8_t hi = (b + 1 < row_bytes ? bitmap_row[b + 1] : 0);
+    uint8_t v = (s ? (uint8_t)((lo << s) | (hi >> (8 - s))) : lo);
+    int16_t valid = w - o;
+    if(valid < 8)
+      v &= (uint8_t)(0xFF << (8 - valid));
+    line[d] = v;
+  }
+}
+
+// set bits of panel columns [x0, x1) in a panel aligned bit row, clear the rest
+inline void PanelColumnMask(int16_t x0, int16_t x1, uint8_t* line, int16_t line_bytes) {
+  for (int16_t d = 0; d < line_bytes; d++) {
+    uint8_t v = 0;
+    for (int16_t k = 0; k < 8; k++)
+      if((d << 3) + k >= x0 && (d << 3) + k < x1)
+        v |= 0x80 >> k;
+    line[d] = v;
+  }
+}
+
+// Move a w x h two color bitmap that is on the panel at (prev_x, prev_y) to (x, y), sending only the pixels that
+// change. Old and new panel rows are XOR-ed and the differing pixels are sent as one row spans through
+// sink.SetWindow / sink.WritePixels, gaps shorter than an address window costs are sent along.
+// Only bitmap columns [col0, col1) count as drawn, at both places. The panel outside the drawn part of the old bitmap
+// must be bg, anything else there is left stale. Returns pixels sent.
+template <int16_t kPanelW, typename Sink>
+long MotionBlitTwoColorBitmap(Sink& sink, const TwoColorLut& lut, int16_t panel_h, int16_t x, int16_t y, int16_t prev_x, int16_t prev_y, const uint8_t* bitmap, int16_t w, int16_t h, int16_t col0 = 0, int16_t col1 = INT16_MAX) {
+  // spans closer than this are merged, an address window costs about as much as this many pixels
+  const int16_t kSpanMergeGap = 8;
+  const int16_t kLineBytes = (kPanelW + 7) >> 3;
+
+  int16_t bitmapWidthBytes = (w + 7) >> 3;
+  int16_t x_start = (x < prev_x ? x : prev_x), x_end = (x > prev_x ? x : prev_x) + w;
+  int16_t y_start = (y < prev_y ? y : prev_y), y_end = (y > prev_y ? y : prev_y) + h;
+  if(x_start < 0) x_start = 0;
+  if(x_end > kPanelW) x_end = kPanelW;
+  if(y_start < 0) y_start = 0;
+  if(y_end > panel_h) y_end = panel_h;
+
+  uint8_t new_line[kLineBytes], old_line[kLineBytes];
+  uint16_t buffer16Bit[kPanelW];
+  long pixels_sent = 0;
+
+  // column window as panel masks for the new and old place
+  bool windowed = (col0 > 0 || col1 < w);
+  uint8_t new_mask[kLineBytes], old_mask[kLineBytes];
+  if(windowed) {
+    PanelColumnMask(x + col0, x + (col1 < w ? col1 : w), new_mask, kLineBytes);
+    PanelColumnMask(prev_x + col0, prev_x + (col1 < w ? col1 : w), old_mask, kLineBytes);
+  }
+
+  for (int16_t py = y_start; py < y_end; py++) {
+    if(py >= y && py < y + h)
+      PanelBitRow(bitmap + (py - y) * bitmapWidthBytes, w, x, new_line, kLineBytes);
+    else
+      memset(new_line, 0, kLineBytes);
+    if(py >= prev_y && py < prev_y + h)
+      PanelBitRow(bitmap + (py - prev_y) * bitmapWidthBytes, w, prev_x, old_line, kLineBytes);
+    else
+      memset(old_line, 0, kLineBytes);
+    if(windowed)
+      for (int16_t d = 0; d < kLineBytes; d++) {
+        new_line[d] &= new_mask[d];
+        old_line[d] &= old_mask[d];
+      }
+    for (int16_t d = 0; d < kLineBytes; d++)
+      old_line[d] ^= new_line[d];   // old_line now holds changed pixels
+
+    int16_t px = x_start;
+    while(px < x_end) {
+      // skip unchanged pixels, whole bytes at a time
+      if(old_line[px >> 3] == 0) {
+        px = (px | 7) + 1;
+        continue;
+      }
+      if(!(old_line[px >> 3] & (0x80 >> (px & 7)))) {
+        px++;
+        continue;
+      }
+      // span of changed pixels, extended over gaps shorter than kSpanMergeGap
+      int16_t span_x0 = px, span_x1 = px + 1, gap = 0;
+      for (px++; px < x_end && gap < kSpanMergeGap; px++) {
+        if(old_line[px >> 3] & (0x80 >> (px & 7))) {
+          span_x1 = px + 1;
+          gap = 0;
+        }
+        else
+          gap++;
+      }
+      px = span_x1;
+      lut.ExpandRow(new_line, span_x0, span_x1, buffer16Bit);
+      sink.SetWindow(span_x0, py, span_x1 - span_x0, 1);
+      sink.WritePixels(buffer16Bit, span_x1 - span_x0);
+      pixels_sent += span_x1 - span_x0;
+    }
+  }
+  return pixels_sent;
+}
+
+#endif  // TWO_COLOR_BLIT_H
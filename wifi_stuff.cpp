@@ -9,6 +9,7 @@
 #include <WiFiUdp.h>
 #include <NTPClient.h>
 #include "rtc.h"
+#include "time_math.h"
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 // Web OTA Update https://github.com/programmer131/ESP8266_ESP32_SelfUpdate/tree/master
@@ -252,7 +253,7 @@ void WiFiStuff::GetTodaysWeatherInfo() {
 bool WiFiStuff::GetTimeFromNtpServer() {
   manual_time_update_successful_ = false;
 
-  if(!got_weather_info_) { // we need gmt_offset_sec_ before getting time update!
+  if(!rtc->timezone_valid() && !got_weather_info_) { // without timezone rules we need gmt_offset_sec_ before getting time update!
     GetTodaysWeatherInfo();
     PrintLn(__func__, got_weather_info_);
     if(!got_weather_info_) {
@@ -272,7 +273,24 @@ bool WiFiStuff::GetTimeFromNtpServer() {
   // Check WiFi connection status
   if(WiFi.status()== WL_CONNECTED) {
 
-    const char* NTP_SERVER = "pool.ntp.org";
+    // with timezone rules: UTC from several SNTP samples, RTC HW set on the next second boundary
+    if(rtc->timezone_valid()) {
+      SntpMath::Sample best;
+      returnVal = GetSntpTime(&best);
+      PrintLn(__func__, returnVal);
+      if(returnVal) {
+        uint32_t at_micros;
+        int64_t utc = SntpMath::NextSecondAfter(best, micros(), &at_micros);
+        rtc->SetTimeAtSecond((uint32_t)utc, at_micros);
+        last_sntp_round_trip_us_ = best.round_trip_us;
+        last_ntp_server_time_update_time_ms = millis();
+        auto_updated_time_today_ = true;
+      }
+      manual_time_update_successful_ = returnVal;
+      return returnVal;
+    }
+
+    const char* NTP_SERVER = kNtpServer;
     // const long  GMT_OFFSET_SEC = -8*60*60;
 
     // Define an NTP Client object
@@ -332,70 +350,67 @@ bool WiFiStuff::GetTimeFromNtpServer() {
   return returnVal;
 }
 
-void WiFiStuff::ConvertEpochIntoDate(unsigned long epoch_since_1970, int &today, int &month, int &year) {
+bool WiFiStuff::GetSntpTime(SntpMath::Sample* best) {
+  // all samples from one server, pool.ntp.org resolves to a different one each lookup
+  IPAddress server_ip;
+  if(!WiFi.hostByName(kNtpServer, server_ip))
+    return false;
 
-  unsigned long epoch_Jan_1_2023_12_AM = 1704067200;
-  float day = static_cast<float>(epoch_since_1970 - epoch_Jan_1_2023_12_AM) / (24*60*60);
-  year = 2024;
-  int monthJan0 = 0;
-  // calculate year
-  while(1) {
-    if(day - 365 - (year % 4 == 0 ? 1 : 0) < 0)
-      break;
-    day -= 365 + (year % 4 == 0 ? 1 : 0);
-    year++;
-  }
-  // calculate month
-  // jan
-  if(day - 31 > 0) {
-    monthJan0++; day -= 31;
-    // feb
-    if(day - 28 - (year % 4 == 0 ? 1 : 0) > 0) {
-      monthJan0++; day -= 28 + (year % 4 == 0 ? 1 : 0);
-      // march
-      if(day - 31 > 0) {
-        monthJan0++; day -= 31;
-        // apr
-        if(day - 30 > 0) {
-          monthJan0++; day -= 30;
-          // may
-          if(day - 31 > 0) {
-            monthJan0++; day -= 31;
-            // jun
-            if(day - 30 > 0) {
-              monthJan0++; day -= 30;
-              // jul
-              if(day - 31 > 0) {
-                monthJan0++; day -= 31;
-                // aug
-                if(day - 31 > 0) {
-                  monthJan0++; day -= 31;
-                  // sep
-                  if(day - 30 > 0) {
-                    monthJan0++; day -= 30;
-                    // oct
-                    if(day - 31 > 0) {
-                      monthJan0++; day -= 31;
-                      // nov
-                      if(day - 30 > 0) {
-                        monthJan0++; day -= 30;
-                        // dec
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
+  WiFiUDP udp;
+  if(!udp.begin(kSntpLocalPort))
+    return false;
+
+  SntpMath::Sample samples[kSntpSamples];
+  uint8_t count = 0;
+  uint8_t packet[SntpMath::kPacketSize];
+  for(uint8_t i = 0; i < kSntpSamples; i++) {
+    uint32_t cookie = esp_random() | 1;
+    SntpMath::MakeRequest(packet, cookie);
+    // drop late replies to earlier requests
+    while(udp.parsePacket() > 0)
+      udp.flush();
+    udp.beginPacket(server_ip, kNtpPort);
+    udp.write(packet, SntpMath::kPacketSize);
+    uint32_t t1_micros = micros();
+    udp.endPacket();
+    unsigned long start_ms = millis();
+    while(millis() - start_ms < kSntpReplyTimeoutMs) {
+      if(udp.parsePacket() >= SntpMath::kPacketSize) {
+        uint32_t t4_micros = micros();
+        udp.read(packet, SntpMath::kPacketSize);
+        // a stale or bad reply does not end the wait for this one
+        if(SntpMath::ParseReply(packet, cookie, t1_micros, t4_micros, &samples[count])) {
+          count++;
+          break;
         }
       }
+      delay(1);
     }
   }
-  today = ceil(day);
+  udp.stop();
+
+  const SntpMath::Sample* best_sample = SntpMath::Best(samples, count);
   #ifdef MORE_LOGS
-  Serial.print(kMonthsTable[monthJan0]); Serial.print(" "); Serial.print(today); Serial.print(" "); Serial.println(year);
+  for(uint8_t i = 0; i < count; i++)
+    Serial.printf("SNTP sample %u: round trip %ld us\n", i, (long)samples[i].round_trip_us);
+  #endif
+  if(best_sample == nullptr)
+    return false;
+  *best = *best_sample;
+  PrintLn("SNTP round trip us: ", (int)best->round_trip_us);
+  return true;
+}
+
+void WiFiStuff::ConvertEpochIntoDate(unsigned long epoch_since_1970, int &today, int &month, int &year) {
+  int32_t civil_year;
+  uint8_t civil_month, civil_day;
+  TimeMath::CivilFromDays(epoch_since_1970 / TimeMath::kSecondsPerDay, civil_year, civil_month, civil_day);
+  year = civil_year;
+  month = civil_month;
+  today = civil_day;
+  #ifdef MORE_LOGS
+  Serial.print(kMonthsTable[month - 1]); Serial.print(" "); Serial.print(today); Serial.print(" "); Serial.println(year);
   #endif
-  month = monthJan0 + 1;
 }
 
 void WiFiStuff::StartSetWiFiSoftAP() {
@@ -492,11 +507,12 @@ void WiFiStuff::StartSetLocationLocalServer() {
 
 void WiFiStuff::StopSetLocationLocalServer() {
   extern AsyncWebServer* server;
-  extern String temp_zip_pin_str, temp_country_code_str;
+  extern String temp_zip_pin_str, temp_country_code_str, temp_timezone_str;
 
   // To access your stored values on ssid_str, passwd_str
   PrintLn(__func__, temp_zip_pin_str.c_str());
   PrintLn(__func__, temp_country_code_str.c_str());
+  PrintLn(__func__, temp_timezone_str.c_str());
 
   TurnWiFiOff();
   delay(100);
@@ -512,6 +528,15 @@ void WiFiStuff::StopSetLocationLocalServer() {
     location_zip_code_ = std::atoi(temp_zip_pin_str.c_str());
     location_country_code_ = temp_country_code_str.c_str();
     SaveWeatherLocationDetails();
+    // timezone rules: blank goes back to the weather GMT offset, a string that does not parse keeps the current rules
+    std::string posix_tz = temp_timezone_str.substring(0, kPosixTzLengthMax).c_str();
+    PosixTz check;
+    if(posix_tz.empty() || check.Parse(posix_tz.c_str())) {
+      rtc->SetTimezone(posix_tz);
+      nvs_preferences->SaveTimezone(posix_tz);
+    }
+    else
+      PrintLn("Timezone does not parse, not saved: ", posix_tz);
   }
 
   got_SAP_user_input_ = false;
@@ -524,11 +549,13 @@ const char* kHtmlParamKeySsid = "html_ssid";
 const char* kHtmlParamKeyPasswd = "html_passwd";
 const char* kHtmlParamKeyZipPin = "html_zip_pin";
 const char* kHtmlParamKeyCountryCode = "html_country_code";
+const char* kHtmlParamKeyTimezone = "html_timezone";
 
 String temp_ssid_str = "Enter SSID";
 String temp_passwd_str = "Enter Passwd";
 String temp_zip_pin_str = "Enter ZIP/PIN";
 String temp_country_code_str = "Enter Country Code";
+String temp_timezone_str = "";
 
 // HTML web page to handle 2 input fields (html_ssid, html_passwd)
 const char index_html_wifi_details[] PROGMEM = R"rawliteral(
@@ -549,7 +576,7 @@ const char index_html_wifi_details[] PROGMEM = R"rawliteral(
   <iframe style="display:none" name="hidden-form"></iframe>
 </body></html>)rawliteral";
 
-// HTML web page to handle 2 input fields (html_zip_pin, html_country_code)
+// HTML web page to handle 3 input fields (html_zip_pin, html_country_code, html_timezone)
 const char index_html_location_details[] PROGMEM = R"rawliteral(
 <!DOCTYPE HTML><html><head>
   <title>Long Press Alarm Clock</title>
@@ -568,6 +595,10 @@ const char index_html_location_details[] PROGMEM = R"rawliteral(
     <a href="https://en.wikipedia.org/wiki/List_of_ISO_3166_country_codes#Current_ISO_3166_country_codes" target="_blank">List</a>
     <label>):</label><br>
     <input type="text" name="html_country_code" value="%html_country_code%" oninput="this.value = this.value.toUpperCase()"><br><br>
+    <label>POSIX Timezone with DST rules (</label>
+    <a href="https://github.com/nayarsystems/posix_tz_db/blob/master/zones.csv" target="_blank">List</a>
+    <label>), blank to use weather location offset:</label><br>
+    <input type="text" name="html_timezone" value="%html_timezone%" placeholder="PST8PDT,M3.2.0,M11.1.0" maxlength="64"><br><br>
     <input type="submit" value="Submit" onclick="submitMessage()"><br>
   </form>
   <iframe style="display:none" name="hidden-form"></iframe>
@@ -587,6 +618,9 @@ String processor(const String& var){
   else if(strcmp(var.c_str(), kHtmlParamKeyCountryCode) == 0){
     return temp_country_code_str;
   }
+  else if(strcmp(var.c_str(), kHtmlParamKeyTimezone) == 0){
+    return temp_timezone_str;
+  }
   return String();
 }
 
@@ -623,6 +657,7 @@ void _LocalServerLocationInputs() {
 
   temp_zip_pin_str = std::to_string(wifi_stuff->location_zip_code_).c_str();
   temp_country_code_str = wifi_stuff->location_country_code_.c_str();
+  temp_timezone_str = nvs_preferences->RetrieveTimezone().c_str();
 
   extern String processor(const String& var);
 
@@ -644,6 +679,10 @@ void _LocalServerLocationInputs() {
       inputMessage = request->getParam(kHtmlParamKeyCountryCode)->value();
       temp_country_code_str = inputMessage;
     }
+    if (request->hasParam(kHtmlParamKeyTimezone)) {
+      inputMessage = request->getParam(kHtmlParamKeyTimezone)->value();
+      temp_timezone_str = inputMessage;
+    }
     PrintLn(__func__, inputMessage.c_str());
     request->send(200, "text/text", inputMessage);
     wifi_stuff->got_SAP_user_input_ = true;
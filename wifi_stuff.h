@@ -4,6 +4,7 @@
 
 #include "common.h"
 #include "secrets.h"
+#include "sntp_math.h"
 #include <sys/_stdint.h>      // try removing it, don't know why it is here
 
 class WiFiStuff {
@@ -18,6 +19,8 @@ public:
   void TurnWiFiOff();
   void GetTodaysWeatherInfo();
   bool GetTimeFromNtpServer();
+  // several SNTP requests to one server, lowest round trip sample in best
+  bool GetSntpTime(SntpMath::Sample* best);
   void StartSetWiFiSoftAP();
   void StopSetWiFiSoftAP();
   void StartSetLocationLocalServer();
@@ -67,6 +70,8 @@ public:
   bool auto_updated_time_today_ = false;   // auto update time once every day at 2:01 AM
   bool manual_time_update_successful_ = false;   // flag used to know if manual time update fetch was success
   unsigned long last_ntp_server_time_update_time_ms = 0;
+  // round trip of the SNTP sample last used to set time
+  int32_t last_sntp_round_trip_us_ = 0;
 
   uint32_t location_zip_code_ = 92104;
 
@@ -141,6 +146,12 @@ public:
 
 private:
 
+  const char* kNtpServer = "pool.ntp.org";
+  static const uint8_t kSntpSamples = 4;
+  const unsigned long kSntpReplyTimeoutMs = 500;
+  const uint16_t kNtpPort = 123;
+  const uint16_t kSntpLocalPort = 2390;
+
   void ConvertEpochIntoDate(unsigned long epoch_since_1970, int &today, int &month, int &year);
 
 };